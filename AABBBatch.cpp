@@ -0,0 +1,263 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "AABBBatch.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define BOX_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(BOX_SSE2) && defined(__GNUC__)
+#define BOX_AVX2
+#include <immintrin.h>
+#endif
+
+// Lane values of an empty box
+static const int32_t EMPTY_MIN = INT32_MAX;
+static const int32_t EMPTY_MAX = INT32_MIN;
+
+/**
+ * BoxArray members
+ */
+
+// Constructor
+BoxArray::BoxArray(void):
+    count(0)
+{
+}
+
+/**
+ * Removes every box, keeping the allocated capacity
+ */
+void BoxArray::clear(void)
+{
+    minX.clear();
+    minY.clear();
+    maxX.clear();
+    maxY.clear();
+    count = 0;
+}
+
+/**
+ * Adds a box given by position and size
+ *
+ * @param x Left edge
+ * @param y Top edge
+ * @param w Width, boxes with no width never overlap
+ * @param h Height, boxes with no height never overlap
+ */
+void BoxArray::add(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    if (w <= 0 || h <= 0)
+        addEmpty();
+    else
+        addBounds(x, y, x + w, y + h);
+}
+
+/**
+ * Adds a box given by its edges
+ *
+ * @param minX Left edge
+ * @param minY Top edge
+ * @param maxX Right edge (exclusive)
+ * @param maxY Bottom edge (exclusive)
+ */
+void BoxArray::addBounds(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY)
+{
+    // Open a new group of lanes, all empty until filled in
+    if (count == this->minX.size())
+    {
+        this->minX.resize(count + BOX_BATCH_WIDTH, EMPTY_MIN);
+        this->minY.resize(count + BOX_BATCH_WIDTH, EMPTY_MIN);
+        this->maxX.resize(count + BOX_BATCH_WIDTH, EMPTY_MAX);
+        this->maxY.resize(count + BOX_BATCH_WIDTH, EMPTY_MAX);
+    }
+
+    this->minX[count] = minX;
+    this->minY[count] = minY;
+    this->maxX[count] = maxX;
+    this->maxY[count] = maxY;
+    ++count;
+}
+
+/**
+ * Adds a box that never overlaps anything, keeps indices lined up with another list
+ */
+void BoxArray::addEmpty(void)
+{
+    addBounds(EMPTY_MIN, EMPTY_MIN, EMPTY_MAX, EMPTY_MAX);
+}
+
+/**
+ * Getter for the number of boxes
+ *
+ * @returns Boxes added since the last clear
+ */
+size_t BoxArray::size(void) const
+{
+    return count;
+}
+
+/**
+ * Overlap kernels
+ *
+ * Each one writes a bit per lane, in groups of BOX_BATCH_WIDTH boxes.
+ * Two boxes overlap when a.min < b.max and a.max > b.min on both axes,
+ * so boxes that only share an edge don't (same as SDL_HasIntersection).
+ */
+typedef void (*overlapKernel)(int32_t, int32_t, int32_t, int32_t, const BoxArray &, uint32_t *);
+
+#ifndef BOX_SSE2
+static void overlapScalar(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, const BoxArray &boxes, uint32_t *hits)
+{
+    size_t lanes = boxes.minX.size();
+
+    for (size_t i = 0; i < lanes; ++i)
+    {
+        if (minX < boxes.maxX[i] && maxX > boxes.minX[i] && minY < boxes.maxY[i] && maxY > boxes.minY[i])
+            hits[i / 32] |= 1u << (i % 32);
+    }
+}
+#endif
+
+#ifdef BOX_SSE2
+static void overlapSSE2(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, const BoxArray &boxes, uint32_t *hits)
+{
+    size_t lanes = boxes.minX.size();
+    __m128i aMinX = _mm_set1_epi32(minX);
+    __m128i aMinY = _mm_set1_epi32(minY);
+    __m128i aMaxX = _mm_set1_epi32(maxX);
+    __m128i aMaxY = _mm_set1_epi32(maxY);
+
+    for (size_t i = 0; i < lanes; i += 4)
+    {
+        __m128i bMinX = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&boxes.minX[i]));
+        __m128i bMinY = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&boxes.minY[i]));
+        __m128i bMaxX = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&boxes.maxX[i]));
+        __m128i bMaxY = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&boxes.maxY[i]));
+
+        __m128i x = _mm_and_si128(_mm_cmplt_epi32(aMinX, bMaxX), _mm_cmpgt_epi32(aMaxX, bMinX));
+        __m128i y = _mm_and_si128(_mm_cmplt_epi32(aMinY, bMaxY), _mm_cmpgt_epi32(aMaxY, bMinY));
+        uint32_t mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(x, y)));
+
+        hits[i / 32] |= mask << (i % 32);
+    }
+}
+#endif
+
+#ifdef BOX_AVX2
+__attribute__((target("avx2")))
+static void overlapAVX2(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, const BoxArray &boxes, uint32_t *hits)
+{
+    size_t lanes = boxes.minX.size();
+    __m256i aMinX = _mm256_set1_epi32(minX);
+    __m256i aMinY = _mm256_set1_epi32(minY);
+    __m256i aMaxX = _mm256_set1_epi32(maxX);
+    __m256i aMaxY = _mm256_set1_epi32(maxY);
+
+    for (size_t i = 0; i < lanes; i += 8)
+    {
+        __m256i bMinX = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&boxes.minX[i]));
+        __m256i bMinY = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&boxes.minY[i]));
+        __m256i bMaxX = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&boxes.maxX[i]));
+        __m256i bMaxY = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&boxes.maxY[i]));
+
+        // AVX2 only has greater-than, a < b is written b > a
+        __m256i x = _mm256_and_si256(_mm256_cmpgt_epi32(bMaxX, aMinX), _mm256_cmpgt_epi32(aMaxX, bMinX));
+        __m256i y = _mm256_and_si256(_mm256_cmpgt_epi32(bMaxY, aMinY), _mm256_cmpgt_epi32(aMaxY, bMinY));
+        uint32_t mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(x, y)));
+
+        hits[i / 32] |= mask << (i % 32);
+    }
+}
+#endif
+
+/**
+ * Picks the widest kernel the CPU supports
+ *
+ * @param name Receives the instruction set name
+ * @returns Overlap kernel
+ */
+static overlapKernel pickKernel(const char *&name)
+{
+#ifdef BOX_AVX2
+    // Runs during static initialization, before the CPU info is set up otherwise
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        name = "avx2";
+        return overlapAVX2;
+    }
+#endif
+#ifdef BOX_SSE2
+    name = "sse2";
+    return overlapSSE2;
+#else
+    name = "scalar";
+    return overlapScalar;
+#endif
+}
+
+static const char *kernelName = NULL;
+static overlapKernel kernel = pickKernel(kernelName);
+
+/**
+ * Tests one box against many
+ *
+ * @param minX Left edge
+ * @param minY Top edge
+ * @param maxX Right edge (exclusive)
+ * @param maxY Bottom edge (exclusive)
+ * @param boxes Boxes to test against
+ * @param hits Receives bit i set when box i overlaps, BOX_HIT_WORDS(boxes.size()) words
+ */
+void boxOverlapOneMany(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, const BoxArray &boxes, uint32_t *hits)
+{
+    memset(hits, 0, BOX_HIT_WORDS(boxes.size()) * sizeof(uint32_t));
+    if (boxes.size() > 0)
+        kernel(minX, minY, maxX, maxY, boxes, hits);
+}
+
+/**
+ * Tests every box in one list against every box in another, e.g. the
+ * candidates a broadphase found in the same cell
+ *
+ * @param a First list
+ * @param b Second list
+ * @param hits Receives a.size() rows of BOX_HIT_WORDS(b.size()) words, bit j of row i set when a[i] overlaps b[j]
+ * @returns Number of overlapping pairs
+ */
+size_t boxOverlapManyMany(const BoxArray &a, const BoxArray &b, uint32_t *hits)
+{
+    size_t words = BOX_HIT_WORDS(b.size());
+    size_t pairs = 0;
+
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        uint32_t *row = hits + i * words;
+        boxOverlapOneMany(a.minX[i], a.minY[i], a.maxX[i], a.maxY[i], b, row);
+
+        for (size_t w = 0; w < words; ++w)
+        {
+            for (uint32_t bits = row[w]; bits != 0; bits &= bits - 1)
+                ++pairs;
+        }
+    }
+
+    return pairs;
+}
+
+/**
+ * Getter for the kernel in use, for benchmarks and logs
+ *
+ * @returns "avx2", "sse2" or "scalar"
+ */
+const char *getBoxOverlapKernel(void)
+{
+    return kernelName;
+}
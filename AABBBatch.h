@@ -0,0 +1,55 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _AABBBATCH_
+#define _AABBBATCH_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Boxes are stored in groups of this many so SIMD loops never need a scalar tail
+#define BOX_BATCH_WIDTH 8
+
+// Words needed to hold one hit bit per box
+#define BOX_HIT_WORDS(count) (((count) + 31) / 32)
+
+/**
+ * Axis-aligned boxes stored as structure-of-arrays
+ *
+ * Edges are in whole pixels with max exclusive, so a box at x with width w
+ * spans [x, x + w). Unused lanes hold an empty box (max below min) that
+ * never overlaps anything.
+ */
+class BoxArray
+{
+public:
+    BoxArray(void);
+
+    void clear(void);
+    void add(int32_t x, int32_t y, int32_t w, int32_t h);
+    void addBounds(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY);
+    void addEmpty(void);
+    size_t size(void) const;
+
+    std::vector<int32_t> minX;
+    std::vector<int32_t> minY;
+    std::vector<int32_t> maxX;
+    std::vector<int32_t> maxY;
+
+private:
+    size_t count;
+};
+
+// Sets bit i of hits for every box i that overlaps the given box, hits needs BOX_HIT_WORDS(boxes.size()) words
+void boxOverlapOneMany(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, const BoxArray &boxes, uint32_t *hits);
+
+// Runs boxOverlapOneMany for every box in a, row r of hits starts at word r * BOX_HIT_WORDS(b.size())
+size_t boxOverlapManyMany(const BoxArray &a, const BoxArray &b, uint32_t *hits);
+
+// Name of the instruction set the overlap tests run on
+const char *getBoxOverlapKernel(void);
+#endif
@@ -0,0 +1,86 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _AIPOLICIES_
+#define _AIPOLICIES_
+
+#include "Components.h"
+
+// Ticks enemy will move in one direction before changing (a tick is about 15 ms)
+#define ROBOT_MOVE_TICKS 33
+#define HUMAN_MOVE_TICKS 10
+
+// Humans flee when the player is closer than this
+#define ENEMY_MIN_DIST 250
+
+// Distance enemy will move away from player
+#define ENEMY_MAX_DIST 450
+
+// Enemies closer together than this steer apart
+#define SEPARATION_RADIUS 40
+
+// How strongly separation outweighs the direction an enemy wants to go
+#define SEPARATION_WEIGHT 1.5
+
+/**
+ * Enemy behaviour policies
+ *
+ * Each enemy type is described at compile time by a policy and tagged with
+ * its policy's component bit, so every enemy type lands in its own archetype.
+ * DisplayManager::moveEnemyGroup is instantiated once per policy and runs a
+ * branch-free loop over one archetype, and retargetEnemyAs makes the
+ * decisions when an enemy's move timer goes off. To add an enemy type, add
+ * a policy here, give it a tag bit in Components.h and append it to
+ * EnemyPolicies.
+ *
+ * MOVE_TICKS     Ticks spent moving in one direction before picking another
+ * AXIS_ALIGNED   Only move horizontally or vertically, never diagonally
+ * FLEES          Run away along a planned path when the player is too close
+ * DODGES         Prefer directions with the least danger when moving randomly
+ * FLEE_DIST_SQ   Squared distance from the player that triggers fleeing
+ * CHASE_DIST_SQ  Squared distance past which the enemy heads back to the player
+ */
+struct HumanPolicy
+{
+    static const EntityType KIND = ET_HUMAN;
+    static const ComponentMask TAG = CB_HUMAN_AI;
+    static const int MOVE_TICKS = HUMAN_MOVE_TICKS;
+    static const bool AXIS_ALIGNED = false;
+    static const bool FLEES = true;
+    static const bool DODGES = true;
+    static const int FLEE_DIST_SQ = ENEMY_MIN_DIST * ENEMY_MIN_DIST;
+    static const int CHASE_DIST_SQ = ENEMY_MAX_DIST * ENEMY_MAX_DIST;
+};
+
+struct RobotPolicy
+{
+    static const EntityType KIND = ET_ROBOT;
+    static const ComponentMask TAG = CB_ROBOT_AI;
+    static const int MOVE_TICKS = ROBOT_MOVE_TICKS;
+    static const bool AXIS_ALIGNED = true;
+    static const bool FLEES = false;
+    static const bool DODGES = false;
+    static const int FLEE_DIST_SQ = 0;
+    static const int CHASE_DIST_SQ = ENEMY_MAX_DIST * ENEMY_MAX_DIST;
+};
+
+// A compile-time list of policies
+template<typename... Policies> struct PolicyList {};
+
+// Every enemy type the game spawns
+typedef PolicyList<HumanPolicy, RobotPolicy> EnemyPolicies;
+
+/**
+ * Finds the tag bit of the policy that controls an enemy type
+ *
+ * @param kind Enemy type
+ * @returns Tag component bit, 0 if no policy controls this type
+ */
+template<typename... Policies> ComponentMask policyTag(EntityType kind, PolicyList<Policies...>)
+{
+    return ((kind == Policies::KIND ? Policies::TAG : 0) | ... | 0);
+}
+#endif
@@ -0,0 +1,205 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "AssetBundle.h"
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Constructor, starts with no bundle
+ */
+AssetBundle::AssetBundle(void):
+    mapped(NULL),
+    mappedSize(0),
+    entries(NULL),
+    entryCount(0)
+{
+}
+
+/**
+ * Destructor, unmaps the bundle
+ */
+AssetBundle::~AssetBundle(void)
+{
+    close();
+}
+
+/**
+ * Maps a bundle into memory and checks every entry lies inside it
+ *
+ * @param path Path to the bundle
+ * @returns False if there is no bundle or it is malformed, the previous bundle is closed either way
+ */
+bool AssetBundle::open(const char *path)
+{
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    struct stat info;
+
+    // Running without a bundle is normal, every asset is then loaded from its own file
+    if (fd < 0)
+        return false;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(AssetBundleHeader))
+    {
+        ::close(fd);
+        std::cout << "Asset bundle failed to load: " << path << std::endl;
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    mappedSize = info.st_size;
+    mapped = mmap(NULL, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        mapped = NULL;
+        std::cout << "Asset bundle failed to map: " << path << std::endl;
+        return false;
+    }
+
+    const uint8_t *bytes = static_cast<const uint8_t *>(mapped);
+    AssetBundleHeader header;
+    memcpy(&header, bytes, sizeof(header));
+
+    uint64_t tableEnd = sizeof(header) + static_cast<uint64_t>(header.entryCount) * sizeof(AssetEntry);
+    bool valid = memcmp(header.magic, ASSET_BUNDLE_MAGIC, sizeof(header.magic)) == 0
+        && header.version == ASSET_BUNDLE_VERSION && tableEnd <= mappedSize;
+
+    entries = reinterpret_cast<const AssetEntry *>(bytes + sizeof(header));
+    entryCount = header.entryCount;
+    for (int i = 0; valid && i < entryCount; ++i)
+    {
+        const AssetEntry &entry = entries[i];
+        valid = entry.name[ASSET_NAME_SIZE - 1] == '\0' && entry.offset >= tableEnd
+            && entry.offset <= mappedSize && entry.size <= mappedSize - entry.offset
+            && (entry.kind != AK_IMAGE || static_cast<uint64_t>(entry.pitch) * entry.height <= entry.size);
+    }
+
+    if (!valid)
+    {
+        std::cout << "Bad asset bundle: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // Everything in the bundle is used at startup, so start reading it all in now
+    madvise(mapped, mappedSize, MADV_WILLNEED);
+    return true;
+}
+
+/**
+ * Releases the bundle, anything still using its data must be done with it
+ */
+void AssetBundle::close(void)
+{
+    if (mapped != NULL)
+        munmap(mapped, mappedSize);
+    mapped = NULL;
+    mappedSize = 0;
+    entries = NULL;
+    entryCount = 0;
+}
+
+/**
+ * Checks whether a bundle is open
+ *
+ * @returns True between a successful open and close
+ */
+bool AssetBundle::isOpen(void) const
+{
+    return mapped != NULL;
+}
+
+/**
+ * Writes a bundle, placing each asset's data on an ASSET_ALIGN boundary
+ *
+ * @param path Where to write it
+ * @param entries One per asset, the offsets and sizes are filled in here
+ * @param data Each asset's bytes, in the same order as the entries
+ * @returns False if the file could not be written
+ */
+bool AssetBundle::write(const char *path, std::vector<AssetEntry> entries, const std::vector<std::vector<uint8_t> > &data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    AssetBundleHeader header;
+    const char padding[ASSET_ALIGN] = { 0 };
+
+    if (!out.is_open())
+    {
+        std::cout << "Asset bundle failed to save: " << path << std::endl;
+        return false;
+    }
+
+    uint64_t offset = sizeof(header) + entries.size() * sizeof(AssetEntry);
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        offset = (offset + ASSET_ALIGN - 1) / ASSET_ALIGN * ASSET_ALIGN;
+        entries[i].offset = offset;
+        entries[i].size = data[i].size();
+        offset += data[i].size();
+    }
+
+    memcpy(header.magic, ASSET_BUNDLE_MAGIC, sizeof(header.magic));
+    header.version = ASSET_BUNDLE_VERSION;
+    header.entryCount = entries.size();
+    header.reserved = 0;
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(AssetEntry));
+
+    uint64_t written = sizeof(header) + entries.size() * sizeof(AssetEntry);
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        out.write(padding, entries[i].offset - written);
+        out.write(reinterpret_cast<const char *>(data[i].data()), data[i].size());
+        written = entries[i].offset + data[i].size();
+    }
+    return out.good();
+}
+
+/**
+ * Looks up an asset by the path it was packed from
+ *
+ * @param name Path relative to the game directory, e.g. "assets/fonts/Courier New.ttf"
+ * @returns The asset's entry, or NULL if the bundle doesn't hold it
+ */
+const AssetEntry *AssetBundle::find(const char *name) const
+{
+    // Only a handful of assets, looked up once each at startup
+    for (int i = 0; i < entryCount; ++i)
+    {
+        if (strcmp(entries[i].name, name) == 0)
+            return &entries[i];
+    }
+    return NULL;
+}
+
+/**
+ * Retrieves an asset's bytes, valid until the bundle is closed
+ *
+ * @param entry Entry returned by find
+ * @returns Start of the asset's data in the mapping
+ */
+const uint8_t *AssetBundle::getData(const AssetEntry *entry) const
+{
+    return static_cast<const uint8_t *>(mapped) + entry->offset;
+}
+
+/**
+ * Getter for the number of assets
+ *
+ * @returns Assets in the bundle, 0 if none is open
+ */
+int AssetBundle::getEntryCount(void) const
+{
+    return entryCount;
+}
@@ -0,0 +1,102 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _ASSETBUNDLE_
+#define _ASSETBUNDLE_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Bundle the game looks for at startup, assets it doesn't hold are loaded from their own files
+#define ASSET_BUNDLE_PATH "assets/assets.bundle"
+
+// First bytes of every bundle
+#define ASSET_BUNDLE_MAGIC "SGAB"
+
+// Bumped whenever the layout below changes
+#define ASSET_BUNDLE_VERSION 1
+
+// Longest asset name, including the terminating zero
+#define ASSET_NAME_SIZE 64
+
+// Every asset's data starts on a multiple of this, so pixels can be uploaded straight from the mapping
+#define ASSET_ALIGN 64
+
+// What an asset's data holds
+enum AssetKind
+{
+    AK_RAW,   // The file as it was, e.g. a font or a map
+    AK_IMAGE, // Decoded pixels with premultiplied alpha, ready to upload to a texture
+};
+
+/**
+ * Bundle layout, little-endian:
+ *
+ *   AssetBundleHeader
+ *   AssetEntry[entryCount]
+ *   asset data, each at its entry's offset
+ *
+ * Assets are named by the path they were packed from, relative to the game
+ * directory, so a bundled asset is looked up the same way it would be opened.
+ */
+struct AssetBundleHeader
+{
+    char magic[4];        // ASSET_BUNDLE_MAGIC
+    uint32_t version;     // ASSET_BUNDLE_VERSION
+    uint32_t entryCount;  // Entries after the header
+    uint32_t reserved;    // Zero
+};
+
+// One packed asset
+struct AssetEntry
+{
+    char name[ASSET_NAME_SIZE]; // Path the asset was packed from, zero-terminated
+    uint32_t kind;              // AssetKind
+    uint32_t format;            // SDL pixel format of an image, 0 otherwise
+    uint32_t width;             // Pixels across an image, 0 otherwise
+    uint32_t height;            // Pixels down an image, 0 otherwise
+    uint32_t pitch;             // Bytes per row of an image, 0 otherwise
+    uint32_t reserved;          // Zero
+    uint64_t offset;            // Byte offset of the data from the start of the bundle
+    uint64_t size;              // Bytes of data
+};
+
+/**
+ * Textures, fonts and maps packed into one file by the assetpack tool
+ *
+ * The bundle is mapped into memory and every asset is used straight from the
+ * mapping. Images are stored already decoded, so starting the game costs a
+ * texture upload per image instead of a PNG decode.
+ *
+ * Kept free of SDL so it can be written by tools without a renderer.
+ */
+class AssetBundle
+{
+public:
+    AssetBundle(void);
+    ~AssetBundle(void);
+
+    bool open(const char *path);
+    void close(void);
+    bool isOpen(void) const;
+
+    static bool write(const char *path, std::vector<AssetEntry> entries, const std::vector<std::vector<uint8_t> > &data);
+
+    const AssetEntry *find(const char *name) const;
+    const uint8_t *getData(const AssetEntry *entry) const;
+    int getEntryCount(void) const;
+
+private:
+    AssetBundle(const AssetBundle &) = delete; // Would unmap the file twice
+    AssetBundle &operator=(const AssetBundle &) = delete;
+
+    void *mapped;       // Whole bundle while open, NULL otherwise
+    size_t mappedSize;
+    const AssetEntry *entries;
+    int entryCount;
+};
+#endif
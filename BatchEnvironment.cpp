@@ -0,0 +1,343 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "BatchEnvironment.h"
+#include <new>
+#include <string.h>
+
+/**
+ * Rounds a buffer offset up to the next array boundary
+ *
+ * @param offset Bytes used so far
+ * @returns Offset of the next array
+ */
+static size_t alignUp(size_t offset)
+{
+    return (offset + BATCH_BUFFER_ALIGN - 1) / BATCH_BUFFER_ALIGN * BATCH_BUFFER_ALIGN;
+}
+
+/**
+ * Lays the observation arrays out in a buffer
+ *
+ * @param base Start of the buffer, NULL to only measure it
+ * @param count Number of instances
+ * @param observations Receives the arrays, may be NULL
+ * @returns Bytes the arrays take
+ */
+static size_t layOut(uint8_t *base, size_t count, BatchObservations *observations)
+{
+    size_t offset = 0;
+    BatchObservations o;
+
+    o.player = reinterpret_cast<float *>(base + offset);
+    offset = alignUp(offset + count * 2 * sizeof(float));
+    o.enemies = reinterpret_cast<float *>(base + offset);
+    offset = alignUp(offset + count * BATCH_MAX_ENEMIES * BATCH_ENEMY_FLOATS * sizeof(float));
+    o.enemyCount = reinterpret_cast<int32_t *>(base + offset);
+    offset = alignUp(offset + count * sizeof(int32_t));
+    o.projectiles = reinterpret_cast<float *>(base + offset);
+    offset = alignUp(offset + count * BATCH_MAX_PROJECTILES * BATCH_PROJECTILE_FLOATS * sizeof(float));
+    o.projectileCount = reinterpret_cast<int32_t *>(base + offset);
+    offset = alignUp(offset + count * sizeof(int32_t));
+    o.health = reinterpret_cast<int32_t *>(base + offset);
+    offset = alignUp(offset + count * sizeof(int32_t));
+    o.score = reinterpret_cast<int32_t *>(base + offset);
+    offset = alignUp(offset + count * sizeof(int32_t));
+    o.done = base + offset;
+    offset = alignUp(offset + count);
+
+    if (observations != NULL)
+        *observations = o;
+    return offset;
+}
+
+/**
+ * Constructor, loads every instance on the thread pool and starts their first runs
+ *
+ * @param instances Number of games, at least one
+ * @param threads Threads stepping them, see ThreadPool::defaultThreadCount
+ * @param seed Seed of instance 0, instance i is seeded seed + i
+ * @param mapPath Map every instance plays on, NULL for the first level
+ * @param buffer Where observations are written, at least getBufferSize(instances) bytes
+ *               aligned to BATCH_BUFFER_ALIGN, NULL to allocate one
+ */
+BatchEnvironment::BatchEnvironment(int instances, int threads, uint32_t seed, const char *mapPath, void *buffer):
+    ownedBuffer(NULL),
+    pool(threads)
+{
+    if (instances < 1)
+        instances = 1;
+    if (buffer == NULL)
+    {
+        ownedBuffer = new (std::align_val_t(BATCH_BUFFER_ALIGN)) uint8_t[getBufferSize(instances)];
+        buffer = ownedBuffer;
+    }
+    memset(buffer, 0, getBufferSize(instances));
+    layOut(static_cast<uint8_t *>(buffer), instances, &observations);
+
+    // Loading the map and building its pathfinder is most of the work, so it is spread out too
+    this->instances.resize(instances, NULL);
+    forEachRange([this, seed, mapPath](int first, int last) {
+        for (int i = first; i < last; ++i)
+        {
+            Instance *instance = new Instance();
+            instance->clock.setUnlimited();
+            instance->clock.setSeed(seed + i);
+            instance->map = new Map(NULL, mapPath);
+            instance->dispMan = new DisplayManager(NULL, NULL, instance->map, &instance->clock);
+            instance->runs = 0;
+            this->instances[i] = instance;
+        }
+    });
+
+    reset();
+}
+
+/**
+ * Destructor, frees every instance and the buffer if it was allocated here
+ */
+BatchEnvironment::~BatchEnvironment(void)
+{
+    for (size_t i = 0; i < instances.size(); ++i)
+    {
+        delete instances[i]->dispMan;
+        delete instances[i]->map;
+        delete instances[i];
+    }
+    if (ownedBuffer != NULL)
+        operator delete[](ownedBuffer, std::align_val_t(BATCH_BUFFER_ALIGN));
+}
+
+/**
+ * Measures the buffer the observations need
+ *
+ * @param instances Number of instances
+ * @returns Bytes needed
+ */
+size_t BatchEnvironment::getBufferSize(int instances)
+{
+    return layOut(NULL, instances, NULL);
+}
+
+/**
+ * Starts a new run on every instance and observes them
+ */
+void BatchEnvironment::reset(void)
+{
+    forEachRange([this](int first, int last) {
+        for (int i = first; i < last; ++i)
+        {
+            restart(i);
+            observe(i);
+        }
+    });
+}
+
+/**
+ * Steps every instance and waits for all of them, then writes their observations
+ * Instances marked done by the last step restart first
+ *
+ * @param actions One action per instance
+ * @param ticks Ticks to repeat each action for, a run that ends stops early
+ */
+void BatchEnvironment::step(const BatchAction *actions, int ticks)
+{
+    forEachRange([this, actions, ticks](int first, int last) {
+        stepRange(first, last, actions, ticks);
+    });
+}
+
+/**
+ * Getter for where observations are written
+ *
+ * @returns Observation arrays, valid until the environment is destroyed
+ */
+const BatchObservations &BatchEnvironment::getObservations(void) const
+{
+    return observations;
+}
+
+/**
+ * Getter for the number of instances
+ *
+ * @returns Number of games stepped together
+ */
+int BatchEnvironment::getInstanceCount(void) const
+{
+    return instances.size();
+}
+
+/**
+ * Getter for the number of threads stepping the instances
+ *
+ * @returns Worker threads in the pool
+ */
+int BatchEnvironment::getThreadCount(void) const
+{
+    return pool.getThreadCount();
+}
+
+/**
+ * Getter for the simulation ticks stepped
+ *
+ * @returns Ticks stepped over every instance together
+ */
+uint64_t BatchEnvironment::getTickCount(void) const
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < instances.size(); ++i)
+        total += instances[i]->clock.getTicks();
+    return total;
+}
+
+/**
+ * Getter for the runs played
+ *
+ * @returns Runs started over every instance together, including the current ones
+ */
+uint64_t BatchEnvironment::getRunCount(void) const
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < instances.size(); ++i)
+        total += instances[i]->runs;
+    return total;
+}
+
+/**
+ * Splits the instances into contiguous ranges, runs a task on each range
+ * on the thread pool and waits for all of them
+ *
+ * @param task Called with the first instance of a range and one past its last
+ */
+void BatchEnvironment::forEachRange(std::function<void(int, int)> task)
+{
+    int count = instances.size();
+    int ranges = pool.getThreadCount() * BATCH_TASKS_PER_THREAD;
+    if (ranges > count)
+        ranges = count;
+
+    for (int r = 0; r < ranges; ++r)
+    {
+        int first = static_cast<int>(static_cast<int64_t>(count) * r / ranges);
+        int last = static_cast<int>(static_cast<int64_t>(count) * (r + 1) / ranges);
+        pool.submit([task, first, last] { task(first, last); });
+    }
+    pool.wait();
+}
+
+/**
+ * Steps a range of instances, the same systems in the same order as the game loop
+ *
+ * @param first First instance to step
+ * @param last One past the last instance to step
+ * @param actions One action per instance
+ * @param ticks Ticks to repeat each action for
+ */
+void BatchEnvironment::stepRange(int first, int last, const BatchAction *actions, int ticks)
+{
+    for (int i = first; i < last; ++i)
+    {
+        if (observations.done[i])
+            restart(i);
+
+        Instance &instance = *instances[i];
+        DisplayManager *dispMan = instance.dispMan;
+        Movement move = actions[i].move;
+
+        for (int t = 0; t < ticks; ++t)
+        {
+            if (actions[i].fire)
+                dispMan->firePlayer();
+            dispMan->movePlayer(instance.map, move);
+
+            dispMan->advanceTick();
+            dispMan->spawnEnemies(instance.map);
+            dispMan->moveEnemies(instance.map);
+            dispMan->fireEnemies();
+            dispMan->moveProjectiles();
+
+            if (dispMan->isPlayerDead())
+            {
+                observations.done[i] = 1;
+                break;
+            }
+        }
+        observe(i);
+    }
+}
+
+/**
+ * Starts a new run on one instance, as GameSession does
+ *
+ * @param index Instance to restart
+ */
+void BatchEnvironment::restart(int index)
+{
+    Instance &instance = *instances[index];
+
+    instance.map->revertEdits();
+    instance.dispMan->reset();
+    instance.dispMan->spawnHumanoid(instance.map, ET_PLAYER);
+    ++instance.runs;
+    observations.done[index] = 0;
+}
+
+/**
+ * Writes one instance's observations into its part of the buffer
+ *
+ * @param index Instance to observe
+ */
+void BatchEnvironment::observe(int index)
+{
+    DisplayManager *dispMan = instances[index]->dispMan;
+    World *world = dispMan->getWorld();
+    std::vector<Archetype *> &archetypes = world->getArchetypes();
+    Position *playerPos = world->get<Position>(dispMan->getPlayer());
+
+    float *player = observations.player + index * 2;
+    float *enemies = observations.enemies + static_cast<size_t>(index) * BATCH_MAX_ENEMIES * BATCH_ENEMY_FLOATS;
+    float *projectiles = observations.projectiles + static_cast<size_t>(index) * BATCH_MAX_PROJECTILES * BATCH_PROJECTILE_FLOATS;
+    int enemyCount = 0;
+    int projectileCount = 0;
+
+    player[0] = (playerPos != NULL) ? playerPos->x : 0;
+    player[1] = (playerPos != NULL) ? playerPos->y : 0;
+
+    for (size_t a = 0; a < archetypes.size(); ++a)
+    {
+        Archetype *arch = archetypes[a];
+        std::vector<Position> &positions = arch->column<Position>();
+
+        if (arch->has(CB_POSITION | CB_AISTATE))
+        {
+            std::vector<AIState> &ai = arch->column<AIState>();
+            for (size_t i = 0; i < arch->size() && enemyCount < BATCH_MAX_ENEMIES; ++i, ++enemyCount)
+            {
+                float *out = enemies + enemyCount * BATCH_ENEMY_FLOATS;
+                out[0] = positions[i].x;
+                out[1] = positions[i].y;
+                out[2] = (ai[i].kind == ET_HUMAN) ? 1 : 0;
+            }
+        }
+        else if (arch->has(CB_POSITION | CB_PROJECTILE))
+        {
+            std::vector<Projectile> &shots = arch->column<Projectile>();
+            for (size_t i = 0; i < arch->size() && projectileCount < BATCH_MAX_PROJECTILES; ++i, ++projectileCount)
+            {
+                float *out = projectiles + projectileCount * BATCH_PROJECTILE_FLOATS;
+                out[0] = positions[i].x;
+                out[1] = positions[i].y;
+                out[2] = shots[i].direction;
+                out[3] = shots[i].soulBullet ? 1 : 0;
+            }
+        }
+    }
+
+    observations.enemyCount[index] = enemyCount;
+    observations.projectileCount[index] = projectileCount;
+    observations.health[index] = dispMan->getPlayerHealth();
+    observations.score[index] = dispMan->getPlayerScore();
+}
@@ -0,0 +1,108 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _BATCHENVIRONMENT_
+#define _BATCHENVIRONMENT_
+
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "DisplayManager.h"
+#include "InputProvider.h"
+#include "Map.h"
+#include "SimClock.h"
+#include "ThreadPool.h"
+
+// Most enemies and projectiles written out per instance, any more are left out
+#define BATCH_MAX_ENEMIES 64
+#define BATCH_MAX_PROJECTILES 256
+
+// Floats written for each enemy and projectile
+#define BATCH_ENEMY_FLOATS 3      // x, y, 1 for a human or 0 for a robot
+#define BATCH_PROJECTILE_FLOATS 4 // x, y, direction in radians, 1 for a soul bullet or 0 for an enemy bullet
+
+// Tasks each step is split into per thread, so threads that finish early pick up more
+#define BATCH_TASKS_PER_THREAD 4
+
+// Every observation array starts on its own cache line
+#define BATCH_BUFFER_ALIGN 64
+
+// What one instance's player does for a step, held for every tick of it
+typedef PlayerInput BatchAction;
+
+/**
+ * Observations of every instance, written in place after each step
+ *
+ * Each array holds every instance back to back, instance i's part starts at
+ * i times the length given beside it. All of them live in one buffer, see
+ * BatchEnvironment::getBufferSize.
+ */
+struct BatchObservations
+{
+    float *player;            // 2: x, y
+    float *enemies;           // BATCH_MAX_ENEMIES * BATCH_ENEMY_FLOATS
+    int32_t *enemyCount;      // 1: enemies written
+    float *projectiles;       // BATCH_MAX_PROJECTILES * BATCH_PROJECTILE_FLOATS
+    int32_t *projectileCount; // 1: projectiles written
+    int32_t *health;          // 1
+    int32_t *score;           // 1
+    uint8_t *done;            // 1: the player died during the last step
+};
+
+/**
+ * Many independent games stepped together without a window
+ *
+ * Every instance has its own map, display manager and clock, seeded
+ * seed + index, so each one is a repeatable game that shares nothing with
+ * the others. step runs the same update systems as the game loop for every
+ * instance, spread over a thread pool, and returns once all of them are done.
+ *
+ * Observations are written straight into one preallocated buffer, which can
+ * be passed in so it is shared with whatever reads them. An instance whose
+ * player died is marked done and restarts at the start of the next step.
+ */
+class BatchEnvironment
+{
+public:
+    BatchEnvironment(int instances, int threads, uint32_t seed, const char *mapPath = NULL, void *buffer = NULL);
+    ~BatchEnvironment(void);
+
+    static size_t getBufferSize(int instances);
+
+    void reset(void);
+    void step(const BatchAction *actions, int ticks = 1);
+
+    const BatchObservations &getObservations(void) const;
+    int getInstanceCount(void) const;
+    int getThreadCount(void) const;
+    uint64_t getTickCount(void) const;
+    uint64_t getRunCount(void) const;
+
+private:
+    BatchEnvironment(const BatchEnvironment &) = delete; // Would share the instances
+    BatchEnvironment &operator=(const BatchEnvironment &) = delete;
+
+    // One game
+    struct Instance
+    {
+        SimClock clock;
+        Map *map;
+        DisplayManager *dispMan;
+        uint64_t runs; // Runs started, including the current one
+    };
+
+    void forEachRange(std::function<void(int, int)> task);
+    void stepRange(int first, int last, const BatchAction *actions, int ticks);
+    void restart(int index);
+    void observe(int index);
+
+    std::vector<Instance *> instances;
+    BatchObservations observations;
+    uint8_t *ownedBuffer; // NULL when the buffer was passed in
+    ThreadPool pool;      // Last, so it finishes its tasks before anything they use goes
+};
+#endif
@@ -0,0 +1,171 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "BotInput.h"
+#include "DisplayManager.h"
+#include <math.h>
+
+// Sine of 22.5 degrees, a direction further than this off an axis also moves along it
+#define DIAGONAL_SLACK 0.38
+
+// The eight directions to wander in
+static const int WANDER_X[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+static const int WANDER_Y[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+/**
+ * Constructor
+ *
+ * @param clock Simulation clock the game is stepped with, draws the directions to wander in
+ */
+BotInput::BotInput(SimClock *clock):
+    clock(clock),
+    wanderTicks(0),
+    lastX(0),
+    lastY(0),
+    moved(false)
+{
+    wander.left = wander.right = wander.up = wander.down = false;
+}
+
+/**
+ * Decides where to move: away from bullets heading close by, toward the
+ * nearest human, or wandering when there is none or the player is stuck
+ *
+ * @param dispMan Display manager holding the entities
+ * @returns Movement for the tick, always firing
+ */
+PlayerInput BotInput::read(DisplayManager *dispMan)
+{
+    PlayerInput input;
+    input.move.left = input.move.right = input.move.up = input.move.down = false;
+    input.fire = true;
+
+    World *world = dispMan->getWorld();
+    Hitbox *self = world->get<Hitbox>(dispMan->getPlayer());
+    if (self == NULL)
+        return input;
+
+    double px = self->rect.x + self->rect.w / 2.0;
+    double py = self->rect.y + self->rect.h / 2.0;
+
+    // Asked to move and went nowhere, so a wall is in the way
+    if (moved && px == lastX && py == lastY)
+        startWandering();
+    lastX = px;
+    lastY = py;
+
+    double dodgeX = 0, dodgeY = 0;
+    double humanX = 0, humanY = 0;
+    double nearest = -1;
+    std::vector<Archetype *> &archetypes = world->getArchetypes();
+    for (size_t a = 0; a < archetypes.size(); ++a)
+    {
+        Archetype *arch = archetypes[a];
+        std::vector<Hitbox> &hitboxes = arch->column<Hitbox>();
+
+        if (arch->has(CB_HITBOX | CB_PROJECTILE))
+        {
+            std::vector<Projectile> &shots = arch->column<Projectile>();
+            for (size_t i = 0; i < arch->size(); ++i)
+            {
+                if (shots[i].soulBullet)
+                    continue;
+
+                double rx = px - (hitboxes[i].rect.x + hitboxes[i].rect.w / 2.0);
+                double ry = py - (hitboxes[i].rect.y + hitboxes[i].rect.h / 2.0);
+                if (rx * rx + ry * ry > BOT_DANGER_RADIUS * BOT_DANGER_RADIUS)
+                    continue;
+
+                // How far ahead of the bullet the player is, and how far off its path
+                double ux = cos(shots[i].direction);
+                double uy = sin(shots[i].direction);
+                double ahead = rx * ux + ry * uy;
+                if (ahead <= 0)
+                    continue;
+                double offX = rx - ux * ahead;
+                double offY = ry - uy * ahead;
+                double off = sqrt(offX * offX + offY * offY);
+                if (off >= BOT_DODGE_DISTANCE)
+                    continue;
+
+                // Dead on, so pick a side across the path
+                if (off < 1)
+                {
+                    offX = -uy;
+                    offY = ux;
+                    off = 1;
+                }
+
+                // Closer bullets, and those passing closer, push harder
+                double weight = (1 - off / BOT_DODGE_DISTANCE) * (1 - ahead / BOT_DANGER_RADIUS);
+                dodgeX += offX / off * weight;
+                dodgeY += offY / off * weight;
+            }
+        }
+        else if (arch->has(CB_HITBOX | CB_AISTATE))
+        {
+            std::vector<AIState> &ai = arch->column<AIState>();
+            for (size_t i = 0; i < arch->size(); ++i)
+            {
+                if (ai[i].kind != ET_HUMAN)
+                    continue;
+
+                double hx = hitboxes[i].rect.x + hitboxes[i].rect.w / 2.0;
+                double hy = hitboxes[i].rect.y + hitboxes[i].rect.h / 2.0;
+                double dist = (hx - px) * (hx - px) + (hy - py) * (hy - py);
+                if (nearest < 0 || dist < nearest)
+                {
+                    nearest = dist;
+                    humanX = hx;
+                    humanY = hy;
+                }
+            }
+        }
+    }
+
+    // Where to go when not dodging
+    double seekX = 0, seekY = 0;
+    if (wanderTicks <= 0 && nearest < 0)
+        startWandering();
+    if (wanderTicks > 0)
+    {
+        --wanderTicks;
+        seekX = wander.right - wander.left;
+        seekY = wander.down - wander.up;
+    }
+    else if (nearest > 0)
+    {
+        seekX = (humanX - px) / sqrt(nearest);
+        seekY = (humanY - py) / sqrt(nearest);
+    }
+
+    double dx = seekX + dodgeX * BOT_DODGE_WEIGHT;
+    double dy = seekY + dodgeY * BOT_DODGE_WEIGHT;
+    double length = sqrt(dx * dx + dy * dy);
+    if (length > 0)
+    {
+        input.move.left = dx < -DIAGONAL_SLACK * length;
+        input.move.right = dx > DIAGONAL_SLACK * length;
+        input.move.up = dy < -DIAGONAL_SLACK * length;
+        input.move.down = dy > DIAGONAL_SLACK * length;
+    }
+    moved = input.move.left || input.move.right || input.move.up || input.move.down;
+    return input;
+}
+
+/**
+ * Picks a random direction, one of eight, to wander in for BOT_WANDER_TICKS
+ */
+void BotInput::startWandering(void)
+{
+    int direction = clock->nextRandom() % 8;
+
+    wander.right = WANDER_X[direction] > 0;
+    wander.left = WANDER_X[direction] < 0;
+    wander.down = WANDER_Y[direction] > 0;
+    wander.up = WANDER_Y[direction] < 0;
+    wanderTicks = BOT_WANDER_TICKS;
+}
@@ -0,0 +1,53 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _BOTINPUT_
+#define _BOTINPUT_
+
+#include "InputProvider.h"
+#include "SimClock.h"
+
+// Enemy bullets farther than this are ignored
+#define BOT_DANGER_RADIUS 200
+
+// Bullets expected to pass closer than this are dodged
+#define BOT_DODGE_DISTANCE 45
+
+// How much dodging outweighs chasing a human
+#define BOT_DODGE_WEIGHT 4.0
+
+// Ticks the bot wanders in one direction when there is no human or it is stuck
+#define BOT_WANDER_TICKS 60
+
+/**
+ * Scripted player for soak and load testing
+ *
+ * Every tick it steps sideways out of the path of enemy bullets heading
+ * close by, otherwise heads for the nearest human, and fires constantly.
+ * The player aims where they last moved, so walking toward a human aims the
+ * soulgun at it and a hit swaps the player into it (see swapSpots). With no
+ * human around, or when a wall stops it, it wanders in a random direction
+ * for a while. Wander directions come from the game's clock, so a run with
+ * the bot is repeated exactly by its seed.
+ */
+class BotInput : public InputProvider
+{
+public:
+    BotInput(SimClock *clock);
+
+    PlayerInput read(DisplayManager *dispMan);
+
+private:
+    SimClock *clock;       // Draws the directions to wander in
+    Movement wander;       // Direction taken while wandering
+    int wanderTicks;       // Ticks left to wander
+    double lastX;          // Player position when last read, to tell when it is stuck
+    double lastY;
+    bool moved;            // The last input asked the player to move
+
+    void startWandering(void);
+};
+#endif
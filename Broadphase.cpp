@@ -0,0 +1,148 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "Broadphase.h"
+#include <algorithm>
+
+/**
+ * Constructor, the arrays grow on first use
+ */
+GridBroadphase::GridBroadphase(void):
+    bucketMask(0)
+{
+}
+
+/**
+ * Finds the cell a coordinate falls in, rounding down for negative coordinates too
+ *
+ * @param coord X or Y coordinate in pixels
+ * @returns Cell coordinate
+ */
+int GridBroadphase::cellOf(int32_t coord)
+{
+    return (coord >= 0) ? coord / BROADPHASE_CELL_SIZE : -((-(coord + 1)) / BROADPHASE_CELL_SIZE) - 1;
+}
+
+/**
+ * Hashes a cell to a bucket
+ *
+ * @param cellX Cell column
+ * @param cellY Cell row
+ * @returns Bucket index
+ */
+uint32_t GridBroadphase::bucketOf(int cellX, int cellY) const
+{
+    uint32_t hash = static_cast<uint32_t>(cellX) * 73856093u ^ static_cast<uint32_t>(cellY) * 19349663u;
+    return hash & bucketMask;
+}
+
+/**
+ * Bins every box of a list into the cells it touches
+ *
+ * @param boxes Boxes to bin, empty ones are left out
+ */
+void GridBroadphase::bin(const BoxArray &boxes)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < boxes.size(); ++i)
+        count += (boxes.minX[i] < boxes.maxX[i] && boxes.minY[i] < boxes.maxY[i]);
+
+    // About two buckets per box keeps most lookups on an empty one
+    uint32_t buckets = BROADPHASE_MIN_BUCKETS;
+    while (buckets < 2 * count)
+        buckets *= 2;
+    bucketMask = buckets - 1;
+
+    // Counting sort by bucket, one pass to count and one to place
+    bucketStart.assign(buckets + 1, 0);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            if (boxes.minX[i] >= boxes.maxX[i] || boxes.minY[i] >= boxes.maxY[i])
+                continue;
+
+            // Edges are exclusive, so a box ending on a cell boundary stays out of the next cell
+            int right = cellOf(boxes.maxX[i] - 1);
+            int bottom = cellOf(boxes.maxY[i] - 1);
+            for (int cy = cellOf(boxes.minY[i]); cy <= bottom; ++cy)
+            {
+                for (int cx = cellOf(boxes.minX[i]); cx <= right; ++cx)
+                {
+                    uint32_t bucket = bucketOf(cx, cy);
+                    if (pass == 0)
+                    {
+                        ++bucketStart[bucket + 1];
+                    }
+                    else
+                    {
+                        CellEntry entry = { boxes.minX[i], boxes.minY[i], boxes.maxX[i], boxes.maxY[i], static_cast<int>(i), cx, cy };
+                        entries[bucketStart[bucket]++] = entry;
+                    }
+                }
+            }
+        }
+
+        if (pass == 0)
+        {
+            for (uint32_t b = 0; b < buckets; ++b)
+                bucketStart[b + 1] += bucketStart[b];
+            entries.resize(bucketStart[buckets]);
+        }
+    }
+
+    // Placing moved every start to the next bucket's, move them back
+    for (uint32_t b = buckets; b > 0; --b)
+        bucketStart[b] = bucketStart[b - 1];
+    bucketStart[0] = 0;
+}
+
+/**
+ * Finds every pair of overlapping boxes between two lists
+ * Boxes that only share an edge don't overlap (same as boxOverlapOneMany)
+ *
+ * @param a First list
+ * @param b Second list
+ * @param pairs Receives the overlapping pairs, cleared first
+ */
+void GridBroadphase::findPairs(const BoxArray &a, const BoxArray &b, std::vector<BoxPair> &pairs)
+{
+    pairs.clear();
+    bin(a);
+    if (entries.empty())
+        return;
+
+    for (size_t j = 0; j < b.size(); ++j)
+    {
+        if (b.minX[j] >= b.maxX[j] || b.minY[j] >= b.maxY[j])
+            continue;
+
+        int right = cellOf(b.maxX[j] - 1);
+        int bottom = cellOf(b.maxY[j] - 1);
+        for (int cy = cellOf(b.minY[j]); cy <= bottom; ++cy)
+        {
+            for (int cx = cellOf(b.minX[j]); cx <= right; ++cx)
+            {
+                uint32_t bucket = bucketOf(cx, cy);
+                for (uint32_t k = bucketStart[bucket]; k < bucketStart[bucket + 1]; ++k)
+                {
+                    const CellEntry &entry = entries[k];
+                    if (entry.cellX != cx || entry.cellY != cy)
+                        continue;
+                    if (!(b.minX[j] < entry.maxX && b.maxX[j] > entry.minX && b.minY[j] < entry.maxY && b.maxY[j] > entry.minY))
+                        continue;
+
+                    // Both boxes share every cell their overlap touches, only its first one reports them
+                    if (cellOf(std::max(b.minX[j], entry.minX)) != cx || cellOf(std::max(b.minY[j], entry.minY)) != cy)
+                        continue;
+
+                    BoxPair pair = { entry.box, static_cast<int>(j) };
+                    pairs.push_back(pair);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _BROADPHASE_
+#define _BROADPHASE_
+
+#include <stdint.h>
+#include <vector>
+#include "AABBBatch.h"
+
+// Width and height of a grid cell in pixels, a few bullets' swept areas across
+#define BROADPHASE_CELL_SIZE 64
+
+// Fewest buckets the grid's cells are hashed into, a power of two
+#define BROADPHASE_MIN_BUCKETS 64
+
+// Indices of two overlapping boxes, one from each list
+struct BoxPair
+{
+    int a;
+    int b;
+};
+
+/**
+ * Uniform grid broadphase between two lists of boxes
+ *
+ * The boxes of the first list are binned into every grid cell they touch,
+ * then each box of the second list is only tested against the boxes in its
+ * own cells. Cells are hashed into buckets sized to the number of boxes, so
+ * the grid covers any area without sizing it, and binning is a counting
+ * sort into one array, so nothing is allocated once the arrays have grown.
+ * A pair touching several cells is only reported from the cell holding the
+ * top left corner of where the two boxes overlap.
+ *
+ * Pass the shorter list first, its grid then stays in cache while the
+ * longer one is read straight through. Empty boxes are skipped, so a list
+ * can keep one lane per entity. At a constant density the cost grows
+ * linearly with the number of boxes, where sweeping on one axis also grows
+ * with the boxes sharing each column.
+ */
+class GridBroadphase
+{
+public:
+    GridBroadphase(void);
+
+    void findPairs(const BoxArray &a, const BoxArray &b, std::vector<BoxPair> &pairs);
+
+private:
+    // One box of the first list in one cell, with its edges so testing it doesn't look them up
+    struct CellEntry
+    {
+        int32_t minX;
+        int32_t minY;
+        int32_t maxX;
+        int32_t maxY;
+        int box;
+        int cellX;  // Cell the entry is for, told apart from other cells sharing the bucket
+        int cellY;
+    };
+
+    static int cellOf(int32_t coord);
+    uint32_t bucketOf(int cellX, int cellY) const;
+    void bin(const BoxArray &boxes);
+
+    uint32_t bucketMask; // Buckets in use less one
+
+    // Kept between calls to avoid reallocating
+    std::vector<uint32_t> bucketStart; // First entry of each bucket, and one past the last at the end
+    std::vector<CellEntry> entries;    // Sorted by bucket
+};
+#endif
@@ -0,0 +1,287 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "BulletPattern.h"
+#include <ctype.h>
+#include <errno.h>
+#include <fstream>
+#include <limits.h>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Reads a whole non-negative number
+ *
+ * @param text Digits, with nothing before or after them
+ * @param value Receives the number
+ * @returns False if the text isn't exactly a non-negative number
+ */
+static bool parseCount(const std::string &text, int &value)
+{
+    const char *start = text.c_str();
+    char *end = NULL;
+
+    if (text.empty() || !isdigit(static_cast<unsigned char>(text[0])))
+        return false;
+    errno = 0;
+    long parsed = strtol(start, &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed > INT_MAX)
+        return false;
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+/**
+ * Reads an emitter's spacing between bursts
+ *
+ * @param text Tick count, or 1/<divisor> for a fraction of the cooldown
+ * @param emitter Receives the interval or the divisor
+ * @returns False if the spacing can't be used
+ */
+static bool parseInterval(const std::string &text, PatternEmitter &emitter)
+{
+    size_t slash = text.find('/');
+    if (slash == std::string::npos)
+        return parseCount(text, emitter.interval);
+
+    int numerator;
+    return parseCount(text.substr(0, slash), numerator) && numerator == 1
+        && parseCount(text.substr(slash + 1), emitter.divisor) && emitter.divisor > 0;
+}
+
+/**
+ * Constructor, starts with the built-in patterns
+ */
+PatternLibrary::PatternLibrary(void):
+    patterns(BUILTIN_PATTERNS, BUILTIN_PATTERNS + SS_TOTAL)
+{
+}
+
+/**
+ * Loads designer patterns and adds them after the ones already known
+ *
+ * A pattern starts with "pattern <name>" followed by one line per emitter:
+ *   emit <aimed|fixed> <at> <interval> <bursts> <sweep> <angle>...
+ * where interval is a tick count or a fraction of the cooldown like 1/15,
+ * and sweep and angles are in degrees. A pattern can reuse the emitters of
+ * one defined before it, once for each of the given angles it is turned by:
+ *   use <name> [angle]...
+ *
+ * A pattern is only added once it is complete, at the next "pattern" line or
+ * the end of the file, and must have at least one emitter. Any error drops
+ * every pattern the file added, so only whole files are ever used.
+ *
+ * @param path Path to the pattern file
+ * @returns False if the file could not be used, leaving the patterns known before
+ */
+bool PatternLibrary::load(const char *path)
+{
+    std::ifstream patternFile(path);
+    std::string line;
+    size_t known = patterns.size();
+    BulletPattern current;       // Pattern being read, added once complete
+    bool reading = false;        // A "pattern" line has started current
+    bool ok = true;
+
+    if (!patternFile.is_open())
+    {
+        std::cout << "Bullet pattern file failed to load" << std::endl;
+        return false;
+    }
+
+    while (std::getline(patternFile, line))
+    {
+        // Strip comments and skip blank lines
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        std::istringstream row(line);
+        std::string keyword;
+        row >> keyword;
+
+        if (keyword == "pattern")
+        {
+            std::string name;
+            row >> name;
+            if (reading && !(ok = finishPattern(current)))
+                break;
+            if (name.empty() || name.size() >= PATTERN_NAME_LENGTH || find(name) >= 0)
+            {
+                std::cout << "Bad bullet pattern name: " << line << std::endl;
+                ok = false;
+                break;
+            }
+
+            memset(&current, 0, sizeof(current));
+            strcpy(current.name, name.c_str());
+            reading = true;
+        }
+        else if (keyword == "emit" && reading)
+        {
+            std::string mode;
+            std::string interval;
+            PatternEmitter emitter;
+            double angles[PATTERN_MAX_ANGLES];
+            double degrees;
+
+            memset(&emitter, 0, sizeof(emitter));
+            row >> mode >> emitter.at >> interval >> emitter.bursts >> emitter.sweep;
+            emitter.aimed = (mode == "aimed");
+            emitter.sweep *= M_PI / 180;
+
+            // A fraction spaces bursts relative to the shooter's cooldown
+            bool spaced = parseInterval(interval, emitter);
+
+            while (emitter.angleCount < PATTERN_MAX_ANGLES && row >> degrees)
+                angles[emitter.angleCount++] = degrees * M_PI / 180;
+
+            if (row.fail() && !row.eof())
+                emitter.angleCount = 0;
+            if ((mode != "aimed" && mode != "fixed") || emitter.at < 0 || emitter.bursts < 0
+                || !spaced || emitter.angleCount == 0
+                || !addEmitter(current, emitter, angles, 0))
+            {
+                std::cout << "Bad bullet pattern emitter: " << line << std::endl;
+                ok = false;
+                break;
+            }
+        }
+        else if (keyword == "use" && reading)
+        {
+            std::string name;
+            double degrees;
+            row >> name;
+
+            // The pattern being read isn't in the library yet, so it can't use itself
+            int index = find(name);
+            if (index < 0)
+            {
+                std::cout << "Unknown bullet pattern: " << line << std::endl;
+                ok = false;
+                break;
+            }
+
+            // Without angles the emitters are used as they are
+            BulletPattern used = patterns[index];
+            std::vector<double> rotations;
+            while (row >> degrees)
+                rotations.push_back(degrees * M_PI / 180);
+            if (rotations.empty())
+                rotations.push_back(0);
+
+            for (size_t r = 0; r < rotations.size() && ok; ++r)
+            {
+                for (int i = 0; i < used.emitterCount && ok; ++i)
+                {
+                    const PatternEmitter &e = used.emitters[i];
+                    ok = addEmitter(current, e, used.angles + e.firstAngle, rotations[r]);
+                }
+            }
+            if (!ok)
+            {
+                std::cout << "Bullet pattern too large: " << line << std::endl;
+                break;
+            }
+        }
+        else
+        {
+            std::cout << "Bad bullet pattern line: " << line << std::endl;
+            ok = false;
+            break;
+        }
+    }
+
+    // The last pattern ends with the file
+    if (ok && reading)
+        ok = finishPattern(current);
+    if (!ok)
+        patterns.resize(known);
+    return ok;
+}
+
+/**
+ * Adds a pattern that has been read in full to the library
+ *
+ * @param pattern The pattern
+ * @returns False if it has no emitters, which would never fire
+ */
+bool PatternLibrary::finishPattern(const BulletPattern &pattern)
+{
+    if (pattern.emitterCount == 0)
+    {
+        std::cout << "Bullet pattern has no emitters: " << pattern.name << std::endl;
+        return false;
+    }
+    patterns.push_back(pattern);
+    return true;
+}
+
+/**
+ * Getter for a pattern
+ *
+ * @param index Pattern index, a ShootStyle for the built-in ones
+ * @returns The pattern, or single shot if the index is unknown
+ */
+const BulletPattern &PatternLibrary::get(int index) const
+{
+    if (index < 0 || index >= static_cast<int>(patterns.size()))
+        return patterns[SS_SINGLESHOT];
+    return patterns[index];
+}
+
+/**
+ * Looks up a pattern by name
+ *
+ * @param name Pattern name
+ * @returns Pattern index, or -1 if there is no such pattern
+ */
+int PatternLibrary::find(const std::string &name) const
+{
+    for (size_t i = 0; i < patterns.size(); ++i)
+    {
+        if (name == patterns[i].name)
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * Getter for the number of patterns
+ *
+ * @returns Built-in and loaded patterns
+ */
+int PatternLibrary::getCount(void) const
+{
+    return patterns.size();
+}
+
+/**
+ * Adds an emitter and its angles to the end of a pattern
+ *
+ * @param pattern Pattern being built
+ * @param emitter Emitter to copy, its angle range is replaced
+ * @param angles Angles of the emitter
+ * @param rotation Radians added to every angle
+ * @returns False if the pattern has no room left
+ */
+bool PatternLibrary::addEmitter(BulletPattern &pattern, const PatternEmitter &emitter, const double *angles, double rotation)
+{
+    if (pattern.emitterCount >= PATTERN_MAX_EMITTERS || pattern.angleCount + emitter.angleCount > PATTERN_MAX_ANGLES)
+        return false;
+
+    PatternEmitter &added = pattern.emitters[pattern.emitterCount++];
+    added = emitter;
+    added.firstAngle = pattern.angleCount;
+
+    for (int i = 0; i < emitter.angleCount; ++i)
+        pattern.angles[pattern.angleCount++] = angles[i] + rotation;
+    return true;
+}
@@ -0,0 +1,89 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _BULLETPATTERN_
+#define _BULLETPATTERN_
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <string>
+#include <vector>
+#include "Components.h"
+
+// Designer patterns, loaded after the built-in ones
+#define PATTERN_PATH "assets/patterns/patterns.txt"
+
+// Pattern size limits, keeps patterns flat and copyable
+// A pattern never fires more than PATTERN_MAX_ANGLES projectiles in one tick
+#define PATTERN_MAX_EMITTERS 8
+#define PATTERN_MAX_ANGLES 32
+#define PATTERN_NAME_LENGTH 24
+
+/**
+ * One stream of bursts within a pattern
+ *
+ * A shooter's cooldown counts down from its timer to 0, then restarts.
+ * Burst k of an emitter fires when the cooldown equals at + k * interval,
+ * and fires one projectile for each of its angles, turned by k * sweep.
+ */
+struct PatternEmitter
+{
+    bool aimed;     // Angles are relative to the target instead of absolute
+    int at;         // Cooldown value of the first burst, 0 fires when the cooldown runs out
+    int interval;   // Ticks between bursts
+    int divisor;    // If not 0, bursts are timer / divisor ticks apart instead
+    int bursts;     // Bursts per cycle, 0 repeats until the cycle restarts
+    double sweep;   // Radians added to the angles on each burst
+    int firstAngle; // Index of the emitter's first angle in the pattern
+    int angleCount; // Projectiles per burst
+};
+
+// A bullet pattern, compiled to flat tables
+struct BulletPattern
+{
+    char name[PATTERN_NAME_LENGTH];
+    int emitterCount;
+    PatternEmitter emitters[PATTERN_MAX_EMITTERS];
+    int angleCount;
+    double angles[PATTERN_MAX_ANGLES];
+};
+
+// Built-in patterns, indexed by ShootStyle
+constexpr BulletPattern BUILTIN_PATTERNS[SS_TOTAL] =
+{
+    { "singleshot", 1, { { true, 0, 0, 0, 1, 0, 0, 1 } }, 1, { 0 } },
+    { "doubleshot", 1, { { true, 0, 0, 0, 1, 0, 0, 2 } }, 2, { -M_PI / 15, M_PI / 15 } },
+    { "tripleshot", 1, { { true, 0, 0, 0, 1, 0, 0, 3 } }, 3, { -M_PI / 12, 0, M_PI / 12 } },
+    { "4way", 1, { { false, 0, 0, 0, 1, 0, 0, 4 } }, 4, { 0, M_PI / 2, M_PI, M_PI * 3 / 2 } },
+    { "4waytilt", 1, { { false, 0, 0, 0, 1, 0, 0, 4 } }, 4, { M_PI / 4, M_PI * 3 / 4, M_PI * 5 / 4, M_PI * 7 / 4 } },
+    { "8way", 1, { { false, 0, 0, 0, 1, 0, 0, 8 } }, 8,
+        { 0, M_PI / 4, M_PI / 2, M_PI * 3 / 4, M_PI, M_PI * 5 / 4, M_PI * 3 / 2, M_PI * 7 / 4 } },
+    // Sweeps a full circle every 256 ticks, one projectile every 16 ticks
+    { "spiral", 1, { { false, 0, 16, 0, 0, M_PI / 8, 0, 1 } }, 1, { 0 } },
+    // Three aimed shots, a fifteenth of the cooldown apart
+    { "3inarow", 1, { { true, 0, 0, 15, 3, 0, 0, 1 } }, 1, { 0 } }
+};
+
+/**
+ * Every bullet pattern the game knows, built-in ones first
+ */
+class PatternLibrary
+{
+public:
+    PatternLibrary(void);
+
+    bool load(const char *path);
+    const BulletPattern &get(int index) const;
+    int find(const std::string &name) const;
+    int getCount(void) const;
+
+private:
+    bool finishPattern(const BulletPattern &pattern);
+    bool addEmitter(BulletPattern &pattern, const PatternEmitter &emitter, const double *angles, double rotation);
+
+    std::vector<BulletPattern> patterns;
+};
+#endif
@@ -0,0 +1,799 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "ChunkCache.h"
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Largest chunk side a chunked map may declare
+#define CHUNK_MAX_SIZE 1024
+
+/**
+ * Copies one chunk out of row-major tiles, padding past the map edge with 0
+ *
+ * @param tiles Tiles of the whole map, row-major
+ * @param width Tiles per row
+ * @param height Rows
+ * @param size Tiles along each side of a chunk
+ * @param chunk Chunk index, chunk rows first
+ * @param chunkColumns Chunks per row of chunks
+ * @param out Receives size * size tiles
+ */
+static void copyChunk(const uint8_t *tiles, int width, int height, int size, int chunk, int chunkColumns, uint8_t *out)
+{
+    int firstRow = (chunk / chunkColumns) * size;
+    int firstCol = (chunk % chunkColumns) * size;
+    int copyCols = (width - firstCol < size) ? width - firstCol : size;
+
+    for (int r = 0; r < size; ++r)
+    {
+        uint8_t *dst = out + static_cast<size_t>(r) * size;
+        int row = firstRow + r;
+        if (row >= height)
+        {
+            memset(dst, 0, size);
+            continue;
+        }
+        memcpy(dst, tiles + static_cast<size_t>(row) * width + firstCol, copyCols);
+        memset(dst + copyCols, 0, size - copyCols);
+    }
+}
+
+/**
+ * Constructor, starts with no map
+ */
+ChunkCache::ChunkCache(void):
+    fd(-1),
+    rowMajor(false),
+    chunkOffset(0),
+    source(NULL),
+    width(0),
+    height(0),
+    chunkSize(CHUNK_SIZE),
+    chunkColumns(0),
+    chunkRows(0),
+    walkWords(0),
+    slots(NULL),
+    slotCount(0),
+    clock(0),
+    lastChunk(-1),
+    lastData(NULL),
+    lastWalkable(NULL),
+    stopping(false)
+{
+    memset(walkable, 0, sizeof(walkable));
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * Destructor, stops the background thread
+ */
+ChunkCache::~ChunkCache(void)
+{
+    close();
+}
+
+/**
+ * Streams chunks out of a map that is already open
+ *
+ * @param source Open map, must stay open until the cache is closed
+ * @param budget Most chunks kept in memory, raised to CHUNK_MIN_BUDGET if lower
+ * @param walkableType The one tile type that can be walked on
+ * @returns False if the map has no tiles
+ */
+bool ChunkCache::open(const MapFile *source, int budget, uint8_t walkableType)
+{
+    close();
+    if (source->getTiles() == NULL)
+        return false;
+
+    this->source = source;
+    width = source->getWidth();
+    height = source->getHeight();
+    chunkSize = CHUNK_SIZE;
+    palette = source->getPalette();
+    start(budget, walkableType);
+    return true;
+}
+
+/**
+ * Streams chunks out of a chunked or binary map file, only its header and palette are read now
+ *
+ * @param path Path to the map
+ * @param budget Most chunks kept in memory, raised to CHUNK_MIN_BUDGET if lower
+ * @param walkableType The one tile type that can be walked on
+ * @returns False if the file is unreadable or malformed
+ */
+bool ChunkCache::openFile(const char *path, int budget, uint8_t walkableType)
+{
+    ChunkFileHeader header;
+    struct stat info;
+
+    close();
+    fd = ::open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &info) != 0 || pread(fd, header.magic, sizeof(header.magic), 0) != sizeof(header.magic))
+    {
+        std::cout << "Map file failed to load: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // Binary maps aren't chunked, but their rows can be read a chunk wide at a time
+    if (memcmp(header.magic, MAP_FILE_MAGIC, sizeof(header.magic)) == 0)
+        return openBinary(path, budget, walkableType, info.st_size);
+
+    if (pread(fd, &header, sizeof(header), 0) != sizeof(header))
+    {
+        std::cout << "Map file failed to load: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    uint64_t paletteEnd = sizeof(header) + static_cast<uint64_t>(header.paletteSize) * sizeof(MapPaletteEntry);
+    bool valid = memcmp(header.magic, CHUNK_FILE_MAGIC, sizeof(header.magic)) == 0
+        && header.version == CHUNK_FILE_VERSION && header.width != 0 && header.height != 0
+        && header.width <= INT32_MAX / header.height && header.chunkSize != 0 && header.chunkSize <= CHUNK_MAX_SIZE
+        && header.paletteSize != 0 && header.paletteSize <= MAP_MAX_PALETTE && header.chunkOffset >= paletteEnd;
+    if (valid)
+    {
+        uint64_t chunks = static_cast<uint64_t>((header.width + header.chunkSize - 1) / header.chunkSize)
+            * ((header.height + header.chunkSize - 1) / header.chunkSize);
+        uint64_t end = header.chunkOffset + chunks * header.chunkSize * header.chunkSize;
+        valid = end <= static_cast<uint64_t>(info.st_size);
+    }
+
+    palette.resize(valid ? header.paletteSize : 0);
+    if (!valid || pread(fd, palette.data(), palette.size() * sizeof(MapPaletteEntry), sizeof(header))
+        != static_cast<ssize_t>(palette.size() * sizeof(MapPaletteEntry)))
+    {
+        std::cout << "Bad map file header: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    width = header.width;
+    height = header.height;
+    chunkSize = header.chunkSize;
+    chunkOffset = header.chunkOffset;
+    start(budget, walkableType);
+    return true;
+}
+
+/**
+ * Streams chunks out of the binary map file already open, checking its header
+ *
+ * @param path Path to the map, for error messages
+ * @param budget Most chunks kept in memory
+ * @param walkableType The one tile type that can be walked on
+ * @param size Bytes in the file
+ * @returns False if the file is malformed, closing it
+ */
+bool ChunkCache::openBinary(const char *path, int budget, uint8_t walkableType, uint64_t size)
+{
+    MapFileHeader header;
+    bool valid = pread(fd, &header, sizeof(header), 0) == sizeof(header);
+
+    if (valid)
+    {
+        uint64_t paletteEnd = sizeof(header) + static_cast<uint64_t>(header.paletteSize) * sizeof(MapPaletteEntry);
+        valid = header.version == MAP_FILE_VERSION && header.width != 0 && header.height != 0
+            && header.width <= INT32_MAX / header.height && header.paletteSize != 0
+            && header.paletteSize <= MAP_MAX_PALETTE && header.tileOffset >= paletteEnd
+            && header.tileOffset + static_cast<uint64_t>(header.width) * header.height <= size;
+    }
+
+    palette.resize(valid ? header.paletteSize : 0);
+    if (!valid || pread(fd, palette.data(), palette.size() * sizeof(MapPaletteEntry), sizeof(header))
+        != static_cast<ssize_t>(palette.size() * sizeof(MapPaletteEntry)))
+    {
+        std::cout << "Bad map file header: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    width = header.width;
+    height = header.height;
+    chunkSize = CHUNK_SIZE;
+    chunkOffset = header.tileOffset;
+    rowMajor = true;
+    start(budget, walkableType);
+    return true;
+}
+
+/**
+ * Stops the background thread and forgets the map
+ */
+void ChunkCache::close(void)
+{
+    stop();
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+    rowMajor = false;
+    chunkOffset = 0;
+    source = NULL;
+    width = 0;
+    height = 0;
+    chunkColumns = 0;
+    chunkRows = 0;
+    palette.clear();
+    edited.clear();
+    std::vector<uint8_t>().swap(pool);
+    std::vector<uint64_t>().swap(walkPool);
+    std::vector<int>().swap(chunkSlot);
+}
+
+/**
+ * Indicates whether a file can be streamed by openFile instead of being read whole
+ *
+ * @param path Path to the file
+ * @returns True if the file starts with CHUNK_FILE_MAGIC or MAP_FILE_MAGIC
+ */
+bool ChunkCache::isStreamable(const char *path)
+{
+    char magic[4] = { 0, 0, 0, 0 };
+    std::ifstream probe(path, std::ios::binary);
+
+    probe.read(magic, sizeof(magic));
+    return memcmp(magic, CHUNK_FILE_MAGIC, sizeof(magic)) == 0 || memcmp(magic, MAP_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+/**
+ * Writes tiles as a chunked map with CHUNK_SIZE chunks
+ *
+ * @param path Where to write them
+ * @param width Tiles per row
+ * @param height Rows
+ * @param palette What each palette index stands for
+ * @param tiles Palette indices, row-major
+ * @returns False if the file could not be written
+ */
+bool ChunkCache::write(const char *path, int width, int height, const std::vector<MapPaletteEntry> &palette, const uint8_t *tiles)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    ChunkFileHeader header;
+    int chunkColumns = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    int chunkRows = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<uint8_t> chunk(CHUNK_SIZE * CHUNK_SIZE);
+
+    if (!out.is_open())
+    {
+        std::cout << "Map file failed to save: " << path << std::endl;
+        return false;
+    }
+
+    memcpy(header.magic, CHUNK_FILE_MAGIC, sizeof(header.magic));
+    header.version = CHUNK_FILE_VERSION;
+    header.width = width;
+    header.height = height;
+    header.chunkSize = CHUNK_SIZE;
+    header.paletteSize = palette.size();
+    header.chunkOffset = sizeof(header) + palette.size() * sizeof(MapPaletteEntry);
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(palette.data()), palette.size() * sizeof(MapPaletteEntry));
+    for (int i = 0; i < chunkColumns * chunkRows; ++i)
+    {
+        copyChunk(tiles, width, height, CHUNK_SIZE, i, chunkColumns, chunk.data());
+        out.write(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+    }
+    return out.good();
+}
+
+/**
+ * Looks up a tile, loading its chunk first if it isn't in memory
+ *
+ * @param row Row of the tile, must be on the map
+ * @param col Column of the tile, must be on the map
+ * @returns Palette index of the tile
+ */
+uint8_t ChunkCache::tileAt(int row, int col)
+{
+    int chunk = (row / chunkSize) * chunkColumns + col / chunkSize;
+    const uint8_t *data = (chunk == lastChunk) ? lastData : lookup(chunk);
+    return data[(row % chunkSize) * chunkSize + col % chunkSize];
+}
+
+/**
+ * Indicates whether a tile can be walked on, loading its chunk first if it isn't in memory
+ *
+ * @param row Row of the tile
+ * @param col Column of the tile
+ * @returns False if the tile can't be walked on or is off the map
+ */
+bool ChunkCache::isWalkable(int row, int col)
+{
+    if (row < 0 || col < 0 || row >= height || col >= width)
+        return false;
+
+    int chunk = (row / chunkSize) * chunkColumns + col / chunkSize;
+    if (chunk != lastChunk)
+        lookup(chunk);
+
+    int bit = (row % chunkSize) * chunkSize + col % chunkSize;
+    return (lastWalkable[bit >> 6] >> (bit & 63)) & 1;
+}
+
+/**
+ * Changes a tile, its chunk is copied out the first time so the change outlives eviction
+ *
+ * @param row Row of the tile, must be on the map
+ * @param col Column of the tile, must be on the map
+ * @param value New palette index
+ */
+void ChunkCache::setTile(int row, int col, uint8_t value)
+{
+    int chunk = (row / chunkSize) * chunkColumns + col / chunkSize;
+    std::unordered_map<int, ChunkCopy>::iterator found = edited.find(chunk);
+
+    if (found == edited.end())
+    {
+        ChunkCopy copy;
+        const uint8_t *data = lookup(chunk);
+        copy.tiles.assign(data, data + static_cast<size_t>(chunkSize) * chunkSize);
+        copy.walkable.assign(lastWalkable, lastWalkable + walkWords);
+        found = edited.insert(std::make_pair(chunk, copy)).first;
+    }
+
+    int bit = (row % chunkSize) * chunkSize + col % chunkSize;
+    found->second.tiles[bit] = value;
+    if (walkable[value])
+        found->second.walkable[bit >> 6] |= static_cast<uint64_t>(1) << (bit & 63);
+    else
+        found->second.walkable[bit >> 6] &= ~(static_cast<uint64_t>(1) << (bit & 63));
+    lastChunk = -1;
+}
+
+/**
+ * Keeps the chunks around a tile loaded, queueing the missing ones for the
+ * background thread. Call once per tick with the player's tile.
+ *
+ * @param row Row of the tile
+ * @param col Column of the tile
+ */
+void ChunkCache::prefetchAround(int row, int col)
+{
+    const int side = 2 * CHUNK_PREFETCH_RADIUS + 1;
+    int centerRow = row / chunkSize;
+    int centerCol = col / chunkSize;
+    bool queuedAny = false;
+
+    if (slots == NULL)
+        return;
+
+    uint64_t now = ++clock;
+    lastChunk = -1;
+    if (centerRow < 0) centerRow = 0;
+    if (centerCol < 0) centerCol = 0;
+    if (centerRow >= chunkRows) centerRow = chunkRows - 1;
+    if (centerCol >= chunkColumns) centerCol = chunkColumns - 1;
+
+    // Chunks already here are marked first so none of them is evicted for another
+    for (int i = 0; i < side * side; ++i)
+    {
+        int r = centerRow + i / side - CHUNK_PREFETCH_RADIUS;
+        int c = centerCol + i % side - CHUNK_PREFETCH_RADIUS;
+        if (r >= 0 && c >= 0 && r < chunkRows && c < chunkColumns && chunkSlot[r * chunkColumns + c] >= 0)
+            slots[chunkSlot[r * chunkColumns + c]].lastUsed = now;
+    }
+
+    for (int i = 0; i < side * side; ++i)
+    {
+        int r = centerRow + i / side - CHUNK_PREFETCH_RADIUS;
+        int c = centerCol + i % side - CHUNK_PREFETCH_RADIUS;
+        if (r < 0 || c < 0 || r >= chunkRows || c >= chunkColumns || chunkSlot[r * chunkColumns + c] >= 0)
+            continue;
+
+        // Every slot is wanted this tick or still loading, try again next tick
+        int slot = findVictim(now);
+        if (slot < 0)
+            break;
+
+        assign(slot, r * chunkColumns + c);
+        slots[slot].lastUsed = now;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            slots[slot].state = CS_LOADING;
+            loadQueue.push_back(slot);
+        }
+        ++stats.prefetches;
+        queuedAny = true;
+    }
+
+    // Maps that fit in memory never queue anything, so never need the thread
+    if (queuedAny && !worker.joinable())
+        worker = std::thread(&ChunkCache::streamChunks, this);
+    if (queuedAny)
+        queued.notify_one();
+}
+
+/**
+ * Sets up the slots once the map's size is known, the background thread
+ * waits until a chunk is first queued for it
+ *
+ * @param budget Most chunks kept in memory
+ * @param walkableType The one tile type that can be walked on
+ */
+void ChunkCache::start(int budget, uint8_t walkableType)
+{
+    // Looked up per palette index, indices the palette doesn't cover can't be walked on
+    for (int i = 0; i < MAP_MAX_PALETTE; ++i)
+        walkable[i] = (i < static_cast<int>(palette.size()) && palette[i].type == walkableType);
+
+    chunkColumns = (width + chunkSize - 1) / chunkSize;
+    chunkRows = (height + chunkSize - 1) / chunkSize;
+    walkWords = (chunkSize * chunkSize + 63) / 64;
+    slotCount = (budget < CHUNK_MIN_BUDGET) ? CHUNK_MIN_BUDGET : budget;
+    slots = new ChunkSlot[slotCount];
+    pool.assign(static_cast<size_t>(slotCount) * chunkSize * chunkSize, 0);
+    walkPool.assign(static_cast<size_t>(slotCount) * walkWords, 0);
+    chunkSlot.assign(static_cast<size_t>(chunkRows) * chunkColumns, -1);
+    clock = 0;
+    lastChunk = -1;
+    lastData = NULL;
+    lastWalkable = NULL;
+    memset(&stats, 0, sizeof(stats));
+
+    stopping = false;
+}
+
+/**
+ * Stops the background thread, dropping whatever it hadn't loaded yet, and frees the slots
+ */
+void ChunkCache::stop(void)
+{
+    if (worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        queued.notify_all();
+        worker.join();
+    }
+
+    loadQueue.clear();
+    delete[] slots;
+    slots = NULL;
+    slotCount = 0;
+    lastChunk = -1;
+    lastData = NULL;
+    lastWalkable = NULL;
+}
+
+/**
+ * Background thread, fills queued slots until told to stop
+ */
+void ChunkCache::streamChunks(void)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    while (true)
+    {
+        queued.wait(guard, [this] { return stopping || !loadQueue.empty(); });
+        if (stopping)
+            return;
+
+        int slot = loadQueue.front();
+        int chunk = slots[slot].chunk;
+        loadQueue.pop_front();
+
+        // The main thread leaves loading slots alone, so the read needs no lock
+        guard.unlock();
+        loadSlot(slot, chunk);
+        guard.lock();
+
+        slots[slot].state = CS_READY;
+        loaded.notify_all();
+    }
+}
+
+/**
+ * Finds a chunk's tiles, loading it on the spot if it isn't in memory
+ * Its walkable bits are left in lastWalkable
+ *
+ * @param chunk Chunk index
+ * @returns The chunk's tiles, valid until the next prefetch or miss
+ */
+const uint8_t *ChunkCache::lookup(int chunk)
+{
+    int slot = chunkSlot[chunk];
+
+    if (!edited.empty())
+    {
+        std::unordered_map<int, ChunkCopy>::iterator found = edited.find(chunk);
+        if (found != edited.end())
+        {
+            lastChunk = chunk;
+            lastData = found->second.tiles.data();
+            lastWalkable = found->second.walkable.data();
+            return lastData;
+        }
+    }
+
+    if (slot < 0)
+    {
+        ++stats.misses;
+        slot = claimSlot();
+        assign(slot, chunk);
+        loadSlot(slot, chunk);
+        slots[slot].state = CS_READY;
+    }
+    else
+    {
+        ++stats.hits;
+        waitForLoad(slot);
+    }
+
+    slots[slot].lastUsed = ++clock;
+    lastChunk = chunk;
+    lastData = slotData(slot);
+    lastWalkable = slotWalkable(slot);
+    return lastData;
+}
+
+/**
+ * Finds the least recently used slot that isn't loading
+ *
+ * @param before Only slots last used before this clock value are considered
+ * @returns Slot index, or -1 if there is none
+ */
+int ChunkCache::findVictim(uint64_t before) const
+{
+    int best = -1;
+
+    for (int i = 0; i < slotCount; ++i)
+    {
+        if (slots[i].state == CS_LOADING || slots[i].lastUsed >= before)
+            continue;
+        if (best < 0 || slots[i].lastUsed < slots[best].lastUsed)
+            best = i;
+    }
+    return best;
+}
+
+/**
+ * Picks a slot for a chunk needed right now, waiting for a prefetch to land if every slot is loading
+ *
+ * @returns Slot index
+ */
+int ChunkCache::claimSlot(void)
+{
+    int slot = findVictim(clock + 1);
+
+    if (slot < 0)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        loaded.wait(guard, [this, &slot] { return (slot = findVictim(clock + 1)) >= 0; });
+    }
+    return slot;
+}
+
+/**
+ * Gives a slot to a chunk, evicting the chunk it held
+ *
+ * @param slot Slot index, not loading
+ * @param chunk Chunk index
+ */
+void ChunkCache::assign(int slot, int chunk)
+{
+    int old = slots[slot].chunk;
+
+    if (old >= 0)
+    {
+        chunkSlot[old] = -1;
+        ++stats.evictions;
+        if (old == lastChunk)
+            lastChunk = -1;
+    }
+    slots[slot].chunk = chunk;
+    slots[slot].state = CS_EMPTY;
+    chunkSlot[chunk] = slot;
+}
+
+/**
+ * Waits until a slot's chunk has finished loading
+ *
+ * @param slot Slot index
+ */
+void ChunkCache::waitForLoad(int slot)
+{
+    if (slots[slot].state == CS_READY)
+        return;
+
+    std::unique_lock<std::mutex> guard(lock);
+    loaded.wait(guard, [this, slot] { return slots[slot].state == CS_READY; });
+}
+
+/**
+ * Fills a slot with a chunk's tiles and walkable bits, safe to call from either thread
+ *
+ * @param slot Slot index, not looked at by the other thread until it is ready
+ * @param chunk Chunk index
+ */
+void ChunkCache::loadSlot(int slot, int chunk)
+{
+    readChunk(chunk, slotData(slot));
+    markWalkable(slotData(slot), slotWalkable(slot));
+}
+
+/**
+ * Reads a chunk's tiles from wherever the map is, safe to call from either thread
+ *
+ * @param chunk Chunk index
+ * @param out Receives chunkSize * chunkSize tiles
+ */
+void ChunkCache::readChunk(int chunk, uint8_t *out) const
+{
+    size_t bytes = static_cast<size_t>(chunkSize) * chunkSize;
+    size_t done = 0;
+
+    if (source != NULL)
+    {
+        copyChunk(source->getTiles(), width, height, chunkSize, chunk, chunkColumns, out);
+        return;
+    }
+
+    // A binary map holds the chunk as a slice of each of its rows
+    if (rowMajor)
+    {
+        int firstRow = (chunk / chunkColumns) * chunkSize;
+        int firstCol = (chunk % chunkColumns) * chunkSize;
+        int cols = (width - firstCol < chunkSize) ? width - firstCol : chunkSize;
+
+        memset(out, 0, bytes);
+        for (int r = 0; r < chunkSize && firstRow + r < height; ++r)
+        {
+            uint64_t offset = chunkOffset + static_cast<uint64_t>(firstRow + r) * width + firstCol;
+            if (pread(fd, out + static_cast<size_t>(r) * chunkSize, cols, offset) != cols)
+            {
+                std::cout << "Map chunk failed to load: " << chunk << std::endl;
+                return;
+            }
+        }
+        return;
+    }
+
+    while (done < bytes)
+    {
+        ssize_t got = pread(fd, out + done, bytes - done, chunkOffset + static_cast<uint64_t>(chunk) * bytes + done);
+        if (got <= 0)
+        {
+            std::cout << "Map chunk failed to load: " << chunk << std::endl;
+            memset(out + done, 0, bytes - done);
+            return;
+        }
+        done += got;
+    }
+}
+
+/**
+ * Sets a bit for every tile of a chunk that can be walked on
+ *
+ * @param tiles chunkSize * chunkSize tiles
+ * @param bits Receives walkWords words of bits, tile by tile from the lowest bit
+ */
+void ChunkCache::markWalkable(const uint8_t *tiles, uint64_t *bits) const
+{
+    int count = chunkSize * chunkSize;
+
+    memset(bits, 0, walkWords * sizeof(uint64_t));
+    for (int i = 0; i < count; ++i)
+        bits[i >> 6] |= static_cast<uint64_t>(walkable[tiles[i]]) << (i & 63);
+}
+
+/**
+ * Getter for a slot's tiles
+ *
+ * @param slot Slot index
+ * @returns chunkSize * chunkSize tiles
+ */
+uint8_t *ChunkCache::slotData(int slot)
+{
+    return pool.data() + static_cast<size_t>(slot) * chunkSize * chunkSize;
+}
+
+/**
+ * Getter for a slot's walkable bits
+ *
+ * @param slot Slot index
+ * @returns walkWords words of bits
+ */
+uint64_t *ChunkCache::slotWalkable(int slot)
+{
+    return walkPool.data() + static_cast<size_t>(slot) * walkWords;
+}
+
+/**
+ * Getter for the map height, for pathfinding
+ *
+ * @returns Rows, 0 if no map is open
+ */
+int ChunkCache::getRows(void) const
+{
+    return height;
+}
+
+/**
+ * Getter for the map width, for pathfinding
+ *
+ * @returns Tiles per row, 0 if no map is open
+ */
+int ChunkCache::getColumns(void) const
+{
+    return width;
+}
+
+/**
+ * Getter for the map width
+ *
+ * @returns Tiles per row, 0 if no map is open
+ */
+int ChunkCache::getWidth(void) const
+{
+    return width;
+}
+
+/**
+ * Getter for the map height
+ *
+ * @returns Rows, 0 if no map is open
+ */
+int ChunkCache::getHeight(void) const
+{
+    return height;
+}
+
+/**
+ * Getter for the palette
+ *
+ * @returns What each palette index stands for
+ */
+const std::vector<MapPaletteEntry> &ChunkCache::getPalette(void) const
+{
+    return palette;
+}
+
+/**
+ * Counts the chunks in memory
+ *
+ * @returns Chunks loaded and ready, never more than the budget
+ */
+int ChunkCache::getResidentCount(void) const
+{
+    int count = 0;
+
+    for (int i = 0; i < slotCount; ++i)
+    {
+        if (slots[i].chunk >= 0 && slots[i].state == CS_READY)
+            ++count;
+    }
+    return count;
+}
+
+/**
+ * Getter for the budget
+ *
+ * @returns Most chunks kept in memory
+ */
+int ChunkCache::getBudget(void) const
+{
+    return slotCount;
+}
+
+/**
+ * Getter for the cache counters
+ *
+ * @returns Counters since the map was opened
+ */
+const ChunkStats &ChunkCache::getStats(void) const
+{
+    return stats;
+}
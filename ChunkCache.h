@@ -0,0 +1,196 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _CHUNKCACHE_
+#define _CHUNKCACHE_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "MapFile.h"
+#include "WalkGrid.h"
+
+// First bytes of every chunked map
+#define CHUNK_FILE_MAGIC "SGCK"
+
+// Bumped whenever the layout below changes
+#define CHUNK_FILE_VERSION 1
+
+// Tiles along each side of a chunk, one chunk is a 4 KB read
+#define CHUNK_SIZE 64
+
+// Chunks around the player's chunk kept loaded, in each direction
+#define CHUNK_PREFETCH_RADIUS 1
+
+// Chunks kept in memory by default, the prefetch square plus room for enemies elsewhere
+#define CHUNK_BUDGET 16
+
+// Fewest chunks a cache can hold, the prefetch square plus one for a stray lookup
+#define CHUNK_MIN_BUDGET ((2 * CHUNK_PREFETCH_RADIUS + 1) * (2 * CHUNK_PREFETCH_RADIUS + 1) + 1)
+
+/**
+ * Chunked map layout, little-endian:
+ *
+ *   ChunkFileHeader
+ *   MapPaletteEntry[paletteSize]
+ *   uint8_t chunks[chunkRows][chunkColumns][chunkSize][chunkSize]  (at chunkOffset)
+ *
+ * Each chunk's tiles are contiguous so it can be read in one go. Tiles of
+ * edge chunks that fall past the map are 0.
+ */
+struct ChunkFileHeader
+{
+    char magic[4];         // CHUNK_FILE_MAGIC
+    uint32_t version;      // CHUNK_FILE_VERSION
+    uint32_t width;        // Tiles per row
+    uint32_t height;       // Rows
+    uint32_t chunkSize;    // Tiles along each side of a chunk
+    uint32_t paletteSize;  // Palette entries after the header
+    uint32_t chunkOffset;  // Byte offset of the first chunk from the start of the file
+};
+
+// Counters for how well the cache keeps up with the player
+struct ChunkStats
+{
+    uint64_t hits;       // Lookups that found their chunk loaded
+    uint64_t misses;     // Lookups that had to load their chunk on the spot
+    uint64_t prefetches; // Chunks queued for the background thread
+    uint64_t evictions;  // Chunks dropped to make room for others
+};
+
+// What a cache slot holds
+enum ChunkState
+{
+    CS_EMPTY,
+    CS_LOADING, // Queued for or being filled by the background thread
+    CS_READY,
+};
+
+// One chunk's worth of memory in the cache
+struct ChunkSlot
+{
+    int chunk;               // Chunk index held, -1 if empty
+    uint64_t lastUsed;       // Cache clock when last looked up or prefetched
+    std::atomic<int> state;  // ChunkState, set by the background thread when a load finishes
+
+    ChunkSlot(void): chunk(-1), lastUsed(0), state(CS_EMPTY) {}
+};
+
+/**
+ * Map tiles streamed in fixed-size chunks around the player
+ *
+ * Only a budgeted number of chunks are in memory at once, each with a bit
+ * per tile for whether it can be walked on, which is what collision and
+ * pathfinding ask. Chunks around the player are prefetched by a background
+ * thread, any other chunk is loaded the moment it is looked up. The least
+ * recently used chunk makes way for a new one.
+ *
+ * Tiles come from a chunked or binary map file, read a chunk at a time, or
+ * from a MapFile that is already open. Changed tiles never go back to
+ * either, their chunks are copied out and kept in memory instead. So the
+ * tiles held stay the same however big the map is, plus one chunk for every
+ * chunk with a changed tile.
+ *
+ * Kept free of SDL so it can be benchmarked without a renderer.
+ */
+class ChunkCache : public WalkSource
+{
+public:
+    ChunkCache(void);
+    ~ChunkCache(void);
+
+    bool open(const MapFile *source, int budget, uint8_t walkableType);
+    bool openFile(const char *path, int budget, uint8_t walkableType);
+    void close(void);
+
+    static bool isStreamable(const char *path);
+    static bool write(const char *path, int width, int height, const std::vector<MapPaletteEntry> &palette, const uint8_t *tiles);
+
+    uint8_t tileAt(int row, int col);
+    bool isWalkable(int row, int col) override;
+    void setTile(int row, int col, uint8_t value);
+    void prefetchAround(int row, int col);
+
+    int getRows(void) const override;
+    int getColumns(void) const override;
+    int getWidth(void) const;
+    int getHeight(void) const;
+    const std::vector<MapPaletteEntry> &getPalette(void) const;
+    int getResidentCount(void) const;
+    int getBudget(void) const;
+    const ChunkStats &getStats(void) const;
+
+private:
+    ChunkCache(const ChunkCache &) = delete; // Would share the background thread
+    ChunkCache &operator=(const ChunkCache &) = delete;
+
+    // A changed chunk, kept whole for good
+    struct ChunkCopy
+    {
+        std::vector<uint8_t> tiles;
+        std::vector<uint64_t> walkable;
+    };
+
+    bool openBinary(const char *path, int budget, uint8_t walkableType, uint64_t size);
+    void start(int budget, uint8_t walkableType);
+    void stop(void);
+    void streamChunks(void);
+
+    const uint8_t *lookup(int chunk);
+    int findVictim(uint64_t before) const;
+    int claimSlot(void);
+    void assign(int slot, int chunk);
+    void waitForLoad(int slot);
+    void loadSlot(int slot, int chunk);
+    void readChunk(int chunk, uint8_t *out) const;
+    void markWalkable(const uint8_t *tiles, uint64_t *bits) const;
+    uint8_t *slotData(int slot);
+    uint64_t *slotWalkable(int slot);
+
+    // Where tiles come from, either a chunked or binary file or an open map
+    int fd;
+    bool rowMajor;        // The file is a binary map, each chunk is read a row at a time
+    uint64_t chunkOffset; // Offset of the first chunk, or of the tile array of a binary map
+    const MapFile *source;
+
+    int width;
+    int height;
+    int chunkSize;
+    int chunkColumns;
+    int chunkRows;
+    std::vector<MapPaletteEntry> palette;
+    unsigned char walkable[MAP_MAX_PALETTE]; // Whether each palette index can be walked on
+    int walkWords;                           // Words of walkable bits per chunk
+
+    // Resident chunks, only the main thread changes which chunk a slot holds
+    ChunkSlot *slots;
+    int slotCount;
+    std::vector<uint8_t> pool;    // slotCount chunks of tiles
+    std::vector<uint64_t> walkPool; // slotCount chunks of walkable bits, a bit per tile
+    std::vector<int> chunkSlot;   // Slot holding each chunk, -1 if not resident
+    uint64_t clock;               // Advanced by every lookup and prefetch
+    int lastChunk;                // Most recent lookup, skips the slot table for runs of tiles
+    const uint8_t *lastData;
+    const uint64_t *lastWalkable;
+    ChunkStats stats;
+
+    // Chunks changed since the map was opened, looked up before the slots
+    std::unordered_map<int, ChunkCopy> edited;
+
+    // Background prefetching
+    std::thread worker;
+    std::mutex lock;
+    std::condition_variable loaded; // A slot finished loading
+    std::condition_variable queued; // A slot was queued, or the thread should stop
+    std::deque<int> loadQueue;      // Slots waiting to be filled
+    bool stopping;
+};
+#endif
@@ -0,0 +1,135 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "Collision.h"
+#include <math.h>
+
+/**
+ * Narrows the time window in which a moving interval overlaps a still one
+ *
+ * @param start Where the moving interval starts (its low edge)
+ * @param delta How far it moves
+ * @param low Low bound the low edge must be above to overlap
+ * @param high High bound the low edge must be below to overlap
+ * @param enter Latest entry time so far, updated
+ * @param exit Earliest exit time so far, updated
+ * @returns False if the intervals never overlap
+ */
+static bool clipAxis(double start, double delta, double low, double high, double &enter, double &exit)
+{
+    if (delta == 0)
+        return start > low && start < high;
+
+    double t0 = (low - start) / delta;
+    double t1 = (high - start) / delta;
+    if (t0 > t1)
+    {
+        double swap = t0;
+        t0 = t1;
+        t1 = swap;
+    }
+
+    if (t0 > enter)
+        enter = t0;
+    if (t1 < exit)
+        exit = t1;
+    return enter < exit;
+}
+
+/**
+ * Swept AABB test, boxes that only share an edge don't count as touching
+ * (same as SDL_HasIntersection)
+ *
+ * @param moving Box at the start of the move
+ * @param dx Horizontal distance moved
+ * @param dy Vertical distance moved
+ * @param target Box that stays still
+ * @returns Fraction of the move (0 to 1) at which the boxes first overlap, or SWEEP_MISS
+ */
+double sweepBox(const Box &moving, double dx, double dy, const Box &target)
+{
+    double enter = 0;
+    double exit = 1;
+
+    // The moving box overlaps while its corner is inside the target grown by the moving box's size
+    if (!clipAxis(moving.x, dx, target.x - moving.w, target.x + target.w, enter, exit))
+        return SWEEP_MISS;
+    if (!clipAxis(moving.y, dy, target.y - moving.h, target.y + target.h, enter, exit))
+        return SWEEP_MISS;
+
+    return enter;
+}
+
+/**
+ * Walks the tiles a segment passes through, in order (Amanatides and Woo's DDA)
+ * Tiles outside the grid count as blocked
+ *
+ * @param grid Walkable tiles
+ * @param tileWidth Tile width in pixels
+ * @param tileHeight Tile height in pixels
+ * @param x0 X-coord the segment starts at
+ * @param y0 Y-coord the segment starts at
+ * @param x1 X-coord the segment ends at
+ * @param y1 Y-coord the segment ends at
+ * @param hitTile Receives the tile index (row * columns + column) of the blocked tile,
+ *                -1 if there is none or it is off the grid. May be NULL.
+ * @returns Fraction of the segment (0 to 1) at which it enters a blocked tile, or SWEEP_MISS
+ */
+double traceGrid(WalkSource &grid, double tileWidth, double tileHeight,
+                 double x0, double y0, double x1, double y1, int *hitTile)
+{
+    double dx = x1 - x0;
+    double dy = y1 - y0;
+    int col = static_cast<int>(floor(x0 / tileWidth));
+    int row = static_cast<int>(floor(y0 / tileHeight));
+    int endCol = static_cast<int>(floor(x1 / tileWidth));
+    int endRow = static_cast<int>(floor(y1 / tileHeight));
+
+    if (hitTile != NULL)
+        *hitTile = -1;
+    if (!grid.isWalkable(row, col))
+    {
+        if (hitTile != NULL && grid.inBounds(row, col))
+            *hitTile = row * grid.getColumns() + col;
+        return 0;
+    }
+
+    // Step direction, time to cross the first tile edge, and time to cross a whole tile, per axis
+    int stepCol = (dx > 0) ? 1 : -1;
+    int stepRow = (dy > 0) ? 1 : -1;
+    double nextCol = (dx == 0) ? SWEEP_MISS : ((col + (dx > 0 ? 1 : 0)) * tileWidth - x0) / dx;
+    double nextRow = (dy == 0) ? SWEEP_MISS : ((row + (dy > 0 ? 1 : 0)) * tileHeight - y0) / dy;
+    double colDelta = (dx == 0) ? SWEEP_MISS : tileWidth / fabs(dx);
+    double rowDelta = (dy == 0) ? SWEEP_MISS : tileHeight / fabs(dy);
+
+    while (col != endCol || row != endRow)
+    {
+        double t;
+        if (nextCol < nextRow)
+        {
+            t = nextCol;
+            col += stepCol;
+            nextCol += colDelta;
+        }
+        else
+        {
+            t = nextRow;
+            row += stepRow;
+            nextRow += rowDelta;
+        }
+
+        if (t > 1)
+            break;
+        if (!grid.isWalkable(row, col))
+        {
+            if (hitTile != NULL && grid.inBounds(row, col))
+                *hitTile = row * grid.getColumns() + col;
+            return t;
+        }
+    }
+
+    return SWEEP_MISS;
+}
@@ -0,0 +1,30 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _COLLISION_
+#define _COLLISION_
+
+#include "WalkGrid.h"
+
+// Returned by the sweep tests when nothing is touched along the way
+#define SWEEP_MISS 2.0
+
+// Axis-aligned box in pixels, SDL-free so collision can be tested without a renderer
+struct Box
+{
+    double x;
+    double y;
+    double w;
+    double h;
+};
+
+// When a box moving by (dx, dy) first overlaps a still box, as a fraction of the move
+double sweepBox(const Box &moving, double dx, double dy, const Box &target);
+
+// When a segment first enters a tile that can't be walked on, as a fraction of the segment
+double traceGrid(WalkSource &grid, double tileWidth, double tileHeight,
+                 double x0, double y0, double x1, double y1, int *hitTile);
+#endif
@@ -0,0 +1,158 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _COMPONENTS_
+#define _COMPONENTS_
+
+// Note: ENTITYDEBUG is defined in movement.h
+
+#include <SDL2/SDL.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "movement.h"
+#include "DangerField.h"
+#include "TextureManager.h"
+
+// Hitbox sizes in pixels
+#define HUMANOID_HITBOX_SIZE 25
+#define PROJECTILE_HITBOX_SIZE 5
+
+// Entity type identifiers
+enum EntityType
+{
+    ET_PLAYER,
+    ET_ROBOT,
+    ET_HUMAN,
+    ET_PROJECTILE,
+    ET_TOTAL
+};
+
+// Built-in bullet patterns, see BulletPattern.h
+enum ShootStyle
+{
+    SS_SINGLESHOT,
+    SS_DOUBLESHOT,
+    SS_TRIPLESHOT,
+    SS_4WAY,
+    SS_4WAYTILT,
+    SS_8WAY,
+    SS_SPIRAL,
+    SS_3INAROW,
+    SS_TOTAL
+};
+
+/**
+ * Components
+ *
+ * Plain data only. Entities are made of a set of these, and every
+ * entity with the same set is stored in the same archetype (see World.h).
+ * Position is the Position struct from movement.h.
+ */
+
+// How an entity walks
+struct Velocity
+{
+    Movement direction;  // Last direction moved
+    double speed;        // Pixels moved per tick
+    moveEntityFunc move; // Turns a direction into a new position
+};
+
+// Area that can be hit, must follow the position after every move
+struct Hitbox
+{
+    SDL_Rect rect;
+};
+
+// Hit points
+struct Health
+{
+    int current;
+    int max;
+};
+
+// Ability to fire projectiles
+struct Shooter
+{
+    int cooldown;                      // Ticks left before being able to shoot again
+    int timer;                         // Ticks between each shot
+    int pattern;                       // Bullet pattern index, a ShootStyle for the built-in ones
+    moveProjectileFunc projectileMove; // How fired projectiles move
+};
+
+// Enemy decision making, see AIPolicies.h
+struct AIState
+{
+    EntityType kind;       // Human or robot
+    bool moveAway;         // If true move away from player
+    std::vector<int> path; // Tiles to walk through while moving away
+    size_t pathStep;       // Index of the next tile in path
+};
+
+// What to draw
+struct Sprite
+{
+    TextureID texture;
+};
+
+// A fired projectile
+struct Projectile
+{
+    double startx;          // X-coord where the projectile started
+    double starty;          // Y-coord where the projectile started
+    double direction;       // Radians the projectile was aimed toward
+    double speed;           // Changed over time by some movement functions
+    int lifetime;           // Ticks before the projectile disappears
+    int power;              // Damage done on contact
+    bool soulBullet;        // True if fired by the player's soulgun
+    moveProjectileFunc move;
+    int expireTick;         // Tick the projectile disappears on, set when it is added
+    DangerSplat danger;     // What it adds to the danger field, if anything
+};
+
+// Marks the player and keeps their score
+struct PlayerControl
+{
+    int score;
+};
+
+// Bit flags naming each component type
+typedef uint32_t ComponentMask;
+
+enum ComponentBit
+{
+    CB_POSITION = 1 << 0,
+    CB_VELOCITY = 1 << 1,
+    CB_HITBOX = 1 << 2,
+    CB_HEALTH = 1 << 3,
+    CB_SHOOTER = 1 << 4,
+    CB_AISTATE = 1 << 5,
+    CB_SPRITE = 1 << 6,
+    CB_PROJECTILE = 1 << 7,
+    CB_PLAYER = 1 << 8,
+
+    // Tags without data, pick which AI policy moves an enemy (see AIPolicies.h)
+    CB_HUMAN_AI = 1 << 9,
+    CB_ROBOT_AI = 1 << 10
+};
+
+// The component sets entities are built from
+const ComponentMask PLAYER_COMPONENTS = CB_POSITION | CB_VELOCITY | CB_HITBOX | CB_HEALTH | CB_SHOOTER | CB_SPRITE | CB_PLAYER;
+const ComponentMask ENEMY_COMPONENTS = CB_POSITION | CB_VELOCITY | CB_HITBOX | CB_HEALTH | CB_SHOOTER | CB_AISTATE | CB_SPRITE;
+const ComponentMask PROJECTILE_COMPONENTS = CB_POSITION | CB_HITBOX | CB_PROJECTILE | CB_SPRITE;
+
+// Maps a component type to its bit
+template<typename T> struct ComponentBitOf;
+template<> struct ComponentBitOf<Position> { static const ComponentMask value = CB_POSITION; };
+template<> struct ComponentBitOf<Velocity> { static const ComponentMask value = CB_VELOCITY; };
+template<> struct ComponentBitOf<Hitbox> { static const ComponentMask value = CB_HITBOX; };
+template<> struct ComponentBitOf<Health> { static const ComponentMask value = CB_HEALTH; };
+template<> struct ComponentBitOf<Shooter> { static const ComponentMask value = CB_SHOOTER; };
+template<> struct ComponentBitOf<AIState> { static const ComponentMask value = CB_AISTATE; };
+template<> struct ComponentBitOf<Sprite> { static const ComponentMask value = CB_SPRITE; };
+template<> struct ComponentBitOf<Projectile> { static const ComponentMask value = CB_PROJECTILE; };
+template<> struct ComponentBitOf<PlayerControl> { static const ComponentMask value = CB_PLAYER; };
+#endif
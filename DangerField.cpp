@@ -0,0 +1,160 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "DangerField.h"
+
+/**
+ * Constructor, starts with an empty field
+ */
+DangerField::DangerField(void):
+    rows(0),
+    columns(0),
+    top(0),
+    left(0),
+    generation(0)
+{
+}
+
+/**
+ * Sizes the window the field covers and clears it, the window starts at the origin
+ *
+ * @param width Width of the window in pixels
+ * @param height Height of the window in pixels
+ */
+void DangerField::resize(int width, int height)
+{
+    columns = (width + DANGER_CELL_SIZE - 1) / DANGER_CELL_SIZE;
+    rows = (height + DANGER_CELL_SIZE - 1) / DANGER_CELL_SIZE;
+    top = 0;
+    left = 0;
+    clear();
+}
+
+/**
+ * Sets every cell to no danger, splats made before this are forgotten
+ */
+void DangerField::clear(void)
+{
+    danger.assign(rows * columns, 0);
+    ++generation;
+}
+
+/**
+ * Centres the window on a position again once it is in the outer half of it
+ * Call before projectiles move, so they splat themselves back in the same tick
+ *
+ * @param pos Position to keep in the window, usually the player's
+ */
+void DangerField::centreOn(Position pos)
+{
+    double width = columns * DANGER_CELL_SIZE;
+    double height = rows * DANGER_CELL_SIZE;
+
+    if (pos.x >= left + width / 4 && pos.x < left + width * 3 / 4 && pos.y >= top + height / 4 && pos.y < top + height * 3 / 4)
+        return;
+
+    // Whole cells, so a cell covers the same pixels whichever window it is in
+    left = floor((pos.x - width / 2) / DANGER_CELL_SIZE) * DANGER_CELL_SIZE;
+    top = floor((pos.y - height / 2) / DANGER_CELL_SIZE) * DANGER_CELL_SIZE;
+    clear();
+}
+
+/**
+ * Moves a projectile's contribution to where it is now
+ *
+ * @param splat What the projectile added last time, updated
+ * @param pos Projectile position
+ * @param dx Horizontal distance the projectile moved this tick
+ * @param dy Vertical distance the projectile moved this tick
+ * @param ticksLeft Ticks before the projectile disappears
+ */
+void DangerField::splat(DangerSplat &splat, Position pos, double dx, double dy, int ticksLeft)
+{
+    int ahead = (ticksLeft < DANGER_LOOKAHEAD_TICKS) ? ticksLeft : DANGER_LOOKAHEAD_TICKS;
+    if (ahead < 0)
+        ahead = 0;
+
+    // Fast projectiles that stay around for the whole lookahead are the most dangerous
+    int speed = static_cast<int>(sqrt(dx * dx + dy * dy) + 0.5);
+    int weight = (1 + speed) * ahead;
+    int now = cellIndex(pos.x, pos.y);
+    int soon = cellIndex(pos.x + dx * ahead, pos.y + dy * ahead);
+    if (soon == now)
+        soon = -1;
+
+    // Most ticks a projectile stays in the same cells, nothing to do then
+    if (splat.generation == generation && now == splat.cells[0] && soon == splat.cells[1] && weight == splat.weight)
+        return;
+
+    remove(splat);
+    splat.cells[0] = now;
+    splat.cells[1] = soon;
+    splat.weight = weight;
+    splat.generation = generation;
+    for (int i = 0; i < 2; ++i)
+    {
+        if (splat.cells[i] >= 0)
+            danger[splat.cells[i]] += weight;
+    }
+}
+
+/**
+ * Takes a projectile's contribution back out of the field
+ *
+ * @param splat What the projectile added, emptied
+ */
+void DangerField::remove(DangerSplat &splat)
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        if (splat.cells[i] >= 0 && splat.generation == generation)
+            danger[splat.cells[i]] -= splat.weight;
+        splat.cells[i] = -1;
+    }
+    splat.weight = 0;
+}
+
+/**
+ * Danger at a position
+ *
+ * @param pos Position in pixels
+ * @returns Summed weight of the projectiles passing through its cell, 0 off the field
+ */
+int DangerField::sample(Position pos) const
+{
+    int cell = cellIndex(pos.x, pos.y);
+    return (cell < 0) ? 0 : danger[cell];
+}
+
+/**
+ * Finds the cell a point is in
+ *
+ * @param x X-coord in pixels
+ * @param y Y-coord in pixels
+ * @returns Cell index, or -1 if outside the window
+ */
+int DangerField::cellIndex(double x, double y) const
+{
+    x -= left;
+    y -= top;
+    if (!(x >= 0 && y >= 0 && x < columns * DANGER_CELL_SIZE && y < rows * DANGER_CELL_SIZE))
+        return -1;
+
+    int col = static_cast<int>(x) / DANGER_CELL_SIZE;
+    int row = static_cast<int>(y) / DANGER_CELL_SIZE;
+    return row * columns + col;
+}
+
+/**
+ * Getter for a splat that isn't in any field yet
+ *
+ * @returns Splat covering no cells
+ */
+DangerSplat noDangerSplat(void)
+{
+    DangerSplat splat = { { -1, -1 }, 0, 0 };
+    return splat;
+}
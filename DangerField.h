@@ -0,0 +1,72 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _DANGERFIELD_
+#define _DANGERFIELD_
+
+#include <vector>
+#include "movement.h"
+
+// Width and height of a danger cell in pixels
+#define DANGER_CELL_SIZE 50
+
+// How many ticks ahead a projectile's path counts as dangerous
+#define DANGER_LOOKAHEAD_TICKS 20
+
+// Width and height in pixels of the window the field covers around the player
+#define DANGER_WINDOW_SIZE 6400
+
+// What a projectile currently adds to the field, so it can be taken back out
+struct DangerSplat
+{
+    int cells[2];   // Cell the projectile is in and cell it is heading for, -1 if none
+    int weight;     // Added to each of the cells
+    int generation; // Field generation the cells are in, older splats are already gone
+};
+
+/**
+ * Coarse grid of how much projectile traffic is about to pass through each cell
+ *
+ * Every projectile adds a weight to the cell it is in and the cell it will
+ * reach DANGER_LOOKAHEAD_TICKS from now. The weight grows with its speed and
+ * with how much of the lookahead it will live through. Projectiles move
+ * their own contribution as they go, so keeping the field current costs
+ * O(1) per moved projectile and reading it costs O(1) per lookup, however
+ * many projectiles there are.
+ *
+ * The field only covers a window around the player, so it costs the same
+ * however big the map is. Once the player nears its edge the window is
+ * centred on them again and starts empty, and every projectile splats
+ * itself back in as it next moves.
+ */
+class DangerField
+{
+public:
+    DangerField(void);
+
+    void resize(int width, int height);
+    void clear(void);
+    void centreOn(Position pos);
+
+    void splat(DangerSplat &splat, Position pos, double dx, double dy, int ticksLeft);
+    void remove(DangerSplat &splat);
+
+    int sample(Position pos) const;
+
+private:
+    int cellIndex(double x, double y) const;
+
+    int rows;       // Size of the window in cells
+    int columns;
+    double top;     // Pixel coordinates of the window's top left corner
+    double left;
+    int generation; // Bumped whenever the field is emptied
+    std::vector<int> danger; // Summed weights per cell
+};
+
+// A splat that isn't in any field yet
+DangerSplat noDangerSplat(void);
+#endif
@@ -6,25 +6,94 @@
 
 #include "DisplayManager.h"
 
-// TO-DO: Turn into Entity Manager and move drawing functions elsewhere
+// TO-DO: Move drawing functions elsewhere
+
+/**
+ * Moves an entity and keeps its hitbox with it
+ *
+ * @param pos Entity position
+ * @param vel Entity velocity
+ * @param hitbox Entity hitbox
+ * @param dir Directions to move
+ */
+static void walk(Position &pos, Velocity &vel, Hitbox &hitbox, Movement &dir)
+{
+    pos = vel.move(pos.x, pos.y, dir, vel.speed);
+    hitbox.rect.x = pos.x;
+    hitbox.rect.y = pos.y;
+
+    if (dir.up || dir.down || dir.left || dir.right)
+        vel.direction = dir;
+}
+
+/**
+ * Moves an entity only if the map allows it
+ *
+ * @param map Pointer to the map
+ * @param pos Entity position
+ * @param vel Entity velocity
+ * @param hitbox Entity hitbox
+ * @param dir Directions to move
+ * @returns True if the entity moved
+ */
+static bool tryWalk(Map *map, Position &pos, Velocity &vel, Hitbox &hitbox, Movement &dir)
+{
+    if (!map->isPlayerColliding(vel.move(pos.x, pos.y, dir, vel.speed)))
+        return false;
+
+    walk(pos, vel, hitbox, dir);
+    return true;
+}
 
 /**
  * Initializes the display manager
  *
- * @param xRenderer External renderer
- * @param xTexture External texture manager
+ * @param xRenderer External renderer, NULL when nothing is drawn
+ * @param xTexture External texture manager, NULL when nothing is drawn
  * @param map Pointer to the map object
+ * @param clock Simulation clock, advanced every tick and drawing the random numbers
  */
-DisplayManager::DisplayManager(SDL_Renderer *xRenderer, TextureManager *xTexture, Map *map) 
+DisplayManager::DisplayManager(SDL_Renderer *xRenderer, TextureManager *xTexture, Map *map, SimClock *clock):
+    crowd(SEPARATION_RADIUS)
 {
     renderer = xRenderer;
     txMan = xTexture;
+    this->clock = clock;
 	renderMap = map;
+    for (int id = TX_PLAYER; id <= TX_BULLET && txMan != NULL; ++id)
+        entityTextures[id] = txMan->acquire(static_cast<TextureID>(id));
+
+    pathfinder.build(map->getWalkSource());
+    danger.resize(DANGER_WINDOW_SIZE, DANGER_WINDOW_SIZE);
+    director.loadWaves(SPAWN_WAVE_PATH);
+    if (!patterns.load(PATTERN_PATH))
+        std::cout << "Only the built-in bullet patterns will be used" << std::endl;
+    simTick = 0;
+    player = NULL_ENTITY;
+}
 
-    maxSpawnCooldown = 1000;
-    newSpawnCooldown = maxSpawnCooldown;
-    firstSpawn = true;
-    srand(time(NULL));
+/**
+ * Removes every entity and restarts the simulation from tick 0, keeping
+ * the loaded map, patterns, waves and all allocated storage
+ * The player has to be spawned again afterwards
+ */
+void DisplayManager::reset(void)
+{
+    world.clear();
+    director.clearCounts();
+    director.reset();
+    simTick = 0;
+    timers.reset(0);
+    firedTimers.clear();
+    player = NULL_ENTITY;
+
+    // Everything derived from the entities goes with them
+    flowField.invalidate();
+    danger.clear();
+    crowd.clear();
+    crowdOwners.clear();
+    effects.clear();
+    deaths.clear();
 }
 
 /**
@@ -32,8 +101,7 @@ DisplayManager::DisplayManager(SDL_Renderer *xRenderer, TextureManager *xTexture
  */
 DisplayManager::~DisplayManager(void) 
 {
-    entities.clear();
-    projectiles.clear();
+    world.clear();
 }
 
 /**
@@ -48,7 +116,7 @@ Position DisplayManager::applyCameraOffset(Position absPos)
     Position result = { 0, 0 };
 
     // Focal point will be the player in the center of the window
-    Position window_focus = player->getPosition();
+    Position window_focus = *world.get<Position>(player);
     double winX = WINDOW_WIDTH / 2;
     double winY = WINDOW_HEIGHT / 2;
 
@@ -66,97 +134,166 @@ Position DisplayManager::applyCameraOffset(Position absPos)
 }
 
 /**
- * Adds an entity to the manager
+ * Creates an entity and lets the spawn director count it
+ *
+ * @param mask Components the entity is made of
+ * @param type Type of entity
+ * @returns Handle to the new entity
+ */
+EntityHandle DisplayManager::createEntity(ComponentMask mask, EntityType type)
+{
+    director.onAdd(type);
+    return world.create(mask);
+}
+
+/**
+ * Removes an entity from the manager, does nothing if it is already gone
  *
- * @param entity Pointer to an entity
+ * @param entity Handle to an entity that is being managed
  */
-void DisplayManager::addEntity(Humanoid *entity) {
-    entities.push_back(entity);
+void DisplayManager::removeEntity(EntityHandle entity)
+{
+    if (!world.isAlive(entity))
+        return;
+
+    // Projectiles take their share of the danger field with them
+    Projectile *proj = world.get<Projectile>(entity);
+    if (proj != NULL)
+        danger.remove(proj->danger);
+
+    director.onRemove(getEntityType(entity));
+    world.destroy(entity);
 }
 
 /**
- * Removes an entity from the manager
+ * Works out what kind of entity a handle refers to from its components
  *
- * @param entity Pointer to an entity that is being managed
+ * @param entity Entity handle
+ * @returns Entity type identifier
  */
-void DisplayManager::removeEntity(Humanoid *entity) {
-    for (int i = 0; i < entities.size(); ++i) {
-        if (entities[i] == entity) {
-            entities.erase(entities.begin() + i);
-        }
-    }
+EntityType DisplayManager::getEntityType(EntityHandle entity)
+{
+    AIState *ai = world.get<AIState>(entity);
+
+    if (ai != NULL)
+        return ai->kind;
+    if (world.getMask(entity) & CB_PROJECTILE)
+        return ET_PROJECTILE;
+    return ET_PLAYER;
 }
 
 /**
  * Spawns enemies as needed
  */
 void DisplayManager::spawnEnemies(Map *map) {
-    int humans = 0;
-    int robots = 0;
-
-    for (int i = 0; i < entities.size(); ++i) {
-        Humanoid *e = entities[i];
-        switch (e->getType()) {
-            case ET_HUMAN:
-                ++humans;
-            break;
-            case ET_ROBOT:
-                ++robots;
-            break;
-            case ET_PLAYER:
-            break;
-            case ET_PROJECTILE:
-            break;
-        }
-    }
-    // keep the number of spawns constrained
-    if (humans + robots > 40)
-    {
-        newSpawnCooldown = 50;
-    }
-    else if (humans + robots < 2)
-    {
-        newSpawnCooldown = 0;
-        firstSpawn = true;
-    }
+    int count = director.update(simTick, spawnRequests, clock);
 
-    // spawn enemies at a generally increasing rate
-    if (newSpawnCooldown <= 0)
-    {
-        if (rand() % 4 > 0)
-            spawnHumanoid(map, ET_ROBOT);
-        else if (!firstSpawn)
-            spawnHumanoid(map, ET_HUMAN);
+    for (int i = 0; i < count; ++i)
+        spawnHumanoid(map, spawnRequests[i].type, spawnRequests[i].basic);
+}
 
-        newSpawnCooldown = maxSpawnCooldown;
-        maxSpawnCooldown -= 15;
+/**
+ * Steps the simulation clock and collects the timers that went off
+ * Call once per frame before the other update systems
+ */
+void DisplayManager::advanceTick(void)
+{
+    ++simTick;
+    clock->advance();
+    firedTimers.clear();
+    timers.advance(firedTimers);
+    indexEnemies();
+    applyMapEdits();
+
+    if (world.isAlive(player))
+        renderMap->streamAround(*world.get<Position>(player));
+}
 
-        if (maxSpawnCooldown < 500)
-            maxSpawnCooldown = 600;
-        firstSpawn = false;
+/**
+ * Brings pathfinding up to date with the tiles that changed since last tick
+ * Only the pathfinder sectors holding changed tiles are rebuilt, and the
+ * flow field is only searched again as far as the new openings shorten it
+ */
+void DisplayManager::applyMapEdits(void)
+{
+    const std::vector<MapEdit> &edits = renderMap->getEdits();
+    if (edits.empty())
+        return;
+
+    int columns = renderMap->getColumns();
+    for (size_t i = 0; i < edits.size(); ++i)
+    {
+        pathfinder.updateTile(edits[i].row * columns + edits[i].col);
+        flowField.updateTile(renderMap->getWalkSource(), edits[i].row, edits[i].col);
     }
-    else 
+    renderMap->clearEdits();
+}
+
+/**
+ * Rebuilds the neighbour index from where every enemy is now
+ * Enemies removed later in the tick stay in it, queries skip them
+ */
+void DisplayManager::indexEnemies(void)
+{
+    std::vector<Archetype *> &archetypes = world.getArchetypes();
+
+    crowd.clear();
+    crowdOwners.clear();
+    for (size_t a = 0; a < archetypes.size(); ++a)
     {
-        newSpawnCooldown -= 1;
+        if (!archetypes[a]->has(CB_POSITION | CB_AISTATE))
+            continue;
+
+        std::vector<Position> &positions = archetypes[a]->column<Position>();
+        for (size_t i = 0; i < positions.size(); ++i)
+            indexEnemy(archetypes[a]->getOwner(i), positions[i]);
     }
 }
 
+/**
+ * Adds one enemy to the neighbour index
+ *
+ * @param enemy Handle of the enemy
+ * @param pos Where it is
+ */
+void DisplayManager::indexEnemy(EntityHandle enemy, Position pos)
+{
+    crowd.insert(crowdOwners.size(), pos);
+    crowdOwners.push_back(enemy);
+}
+
 /**
  * Spawns a humanoid entity at an appropriate location considering player location and other enemies
  *
  * @param type Type of humanoid to spawn
- * @param player Pointer to the player
- * @returns A pointer to the humanoid spawned
+ * @param basic If true, use the simplest shooting style and projectile movement
+ * @returns Handle to the humanoid spawned, or NULL_ENTITY if none was
  */
-Humanoid *DisplayManager::spawnHumanoid(Map *map, EntityType type) {
+EntityHandle DisplayManager::spawnHumanoid(Map *map, EntityType type, bool basic) {
+    Movement still = { false, false, false, false };
+
     // Place player at center of map
     if (type == ET_PLAYER) {
-	    player = new Humanoid(5, ET_PLAYER, WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2, 2, movePlayer, 50, SS_SINGLESHOT, moveDirection, TX_PLAYER);
-
-        addEntity(player);
+        player = createEntity(PLAYER_COMPONENTS, ET_PLAYER);
+
+        Position start = { WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2 };
+        Velocity vel = { still, 2, ::movePlayer };
+        Hitbox hitbox = { { static_cast<int>(start.x), static_cast<int>(start.y), HUMANOID_HITBOX_SIZE, HUMANOID_HITBOX_SIZE } };
+        Health health = { 5, 5 };
+        Shooter shooter = { 100, 50, SS_SINGLESHOT, moveDirection };
+        Sprite sprite = { TX_PLAYER };
+        PlayerControl control = { 0 };
+
+        *world.get<Position>(player) = start;
+        *world.get<Velocity>(player) = vel;
+        *world.get<Hitbox>(player) = hitbox;
+        *world.get<Health>(player) = health;
+        *world.get<Shooter>(player) = shooter;
+        *world.get<Sprite>(player) = sprite;
+        *world.get<PlayerControl>(player) = control;
         return player;
     }
-    Position pos = player->getPosition();
+    Position pos = *world.get<Position>(player);
 
     // initial values and variables
     double x;
@@ -166,10 +303,10 @@ Humanoid *DisplayManager::spawnHumanoid(Map *map, EntityType type) {
     double speed;
     double health;
     int shootCooldown = 500; //starting value of the cooldown
-    ShootStyle ss;
+    int ss;
 
     moveProjectileFunc projMoveFunc;
-    double theta = (rand() % 628) * 0.01;
+    double theta = (clock->nextRandom() % 628) * 0.01;
 
     // pick a random available location around player to spawn at
     x = pos.x + cos(theta) * SPAWN_DIST;
@@ -178,7 +315,7 @@ Humanoid *DisplayManager::spawnHumanoid(Map *map, EntityType type) {
     newPos.y = y;
     while (!(map->isPlayerColliding(newPos)))
     {
-    	theta = (rand() % 628)*0.01;
+    	theta = (clock->nextRandom() % 628)*0.01;
         x = pos.x + cos(theta) * SPAWN_DIST;
         y = pos.y + sin(theta) * SPAWN_DIST;
         newPos.x = x;
@@ -186,173 +323,435 @@ Humanoid *DisplayManager::spawnHumanoid(Map *map, EntityType type) {
     }
 
     // generate randomized stats
-    speed = (type == static_cast<int>(TX_HUMAN)) ? 0.4: 0.2;
-    speed += (rand() % 30)*0.05;
-    health = (type == static_cast<int>(TX_HUMAN)) ? rand() % 3 + 2: rand() % 2 + 1;
+    speed = (type == ET_HUMAN) ? 0.4: 0.2;
+    speed += (clock->nextRandom() % 30)*0.05;
+    health = (type == ET_HUMAN) ? clock->nextRandom() % 3 + 2: clock->nextRandom() % 2 + 1;
 
-    // Randomize shooting style
-    ss = static_cast<ShootStyle>(rand() % SS_TOTAL);
+    // Randomize bullet pattern, including the ones loaded from the pattern file
+    ss = clock->nextRandom() % patterns.getCount();
     if (ss != SS_SINGLESHOT)
-        ss = static_cast<ShootStyle>(rand() % SS_TOTAL);
+        ss = clock->nextRandom() % patterns.getCount();
     if (ss == SS_8WAY || ss == SS_SPIRAL)
-        ss = static_cast<ShootStyle>(rand() % SS_TOTAL);
+        ss = clock->nextRandom() % patterns.getCount();
     if (ss == SS_8WAY || ss == SS_SPIRAL)
-        shootCooldown += rand() % 100 + 50;
+        shootCooldown += clock->nextRandom() % 100 + 50;
         
     // generate randomized shooting styles, projectile movements, and appropriate shooting cooldowns
-    switch (rand() % (NUM_OF_PROJ_MOVE_FUNCS + 5))
+    switch (clock->nextRandom() % (NUM_OF_PROJ_MOVE_FUNCS + 5))
     {
         case 0:
         case 1:
         case 2:
         case 3:
             projMoveFunc = moveDirection;
-            shootCooldown -= rand()%200 + 100;
+            shootCooldown -= clock->nextRandom()%200 + 100;
             break;
         case 4:
             projMoveFunc = moveSpiral;
-            shootCooldown += rand()%100 - 50;
+            shootCooldown += clock->nextRandom()%100 - 50;
             break;
         case 5:
         case 6:
             projMoveFunc = moveSine;
-            shootCooldown -= rand()%100;
+            shootCooldown -= clock->nextRandom()%100;
             break;
         case 7:
         case 8:
             projMoveFunc = moveCorkscrew;
-            shootCooldown += rand()%100 - 50;
+            shootCooldown += clock->nextRandom()%100 - 50;
             break;
         case 9:
             projMoveFunc = moveBoomerang;
-            shootCooldown += rand()%100 - 50;
+            shootCooldown += clock->nextRandom()%100 - 50;
             break;
         default:
             projMoveFunc = moveDirection;
             break;
     }
 
-    if (firstSpawn) //make sure the first two are very basic to let the player learn how to play
+    if (basic) //make sure the first few are very basic to let the player learn how to play
     {
         ss = SS_SINGLESHOT;
         projMoveFunc = moveDirection;
     }
 
-    if (!isNearEnemy(x, y, 5)) {
-        Humanoid *e = new Humanoid(health, type, x, y, speed, movePlayer, shootCooldown, ss, projMoveFunc, static_cast<TextureID>(type));
-        addEntity(e);
-        return e;
-    }
-    
-    return NULL;
+    // Don't spawn on top of another enemy
+    if (isNearEnemy(x, y, HUMANOID_HITBOX_SIZE))
+        return NULL_ENTITY;
+
+    EntityHandle e = createEntity(ENEMY_COMPONENTS | policyTag(type, EnemyPolicies()), type);
+    Velocity vel = { still, speed, ::movePlayer };
+    Hitbox hitbox = { { static_cast<int>(x), static_cast<int>(y), HUMANOID_HITBOX_SIZE, HUMANOID_HITBOX_SIZE } };
+    Health hp = { static_cast<int>(health), static_cast<int>(health) };
+    Shooter shooter = { 100, shootCooldown, ss, projMoveFunc };
+    Sprite sprite = { static_cast<TextureID>(type) };
+    AIState *ai = world.get<AIState>(e);
+
+    *world.get<Position>(e) = newPos;
+    *world.get<Velocity>(e) = vel;
+    *world.get<Hitbox>(e) = hitbox;
+    *world.get<Health>(e) = hp;
+    *world.get<Shooter>(e) = shooter;
+    *world.get<Sprite>(e) = sprite;
+    ai->kind = type;
+    ai->moveAway = false;
+    ai->pathStep = 0;
+    indexEnemy(e, newPos);
+
+    // Pick a direction on the next tick, and shoot once the cooldown runs out
+    timers.schedule(simTick + 1, TK_RETARGET, e);
+    timers.schedule(simTick + ticksToNextShot(shooter, patterns.get(ss)), TK_FIRE, e);
+    return e;
+}
+
+/**
+ * Moves the player if the map allows it, and counts down their shooting cooldown
+ *
+ * @param map Pointer to the map
+ * @param dir Directions the player wants to move
+ */
+void DisplayManager::movePlayer(Map *map, Movement &dir)
+{
+    if (!world.isAlive(player))
+        return;
+
+    tryWalk(map, *world.get<Position>(player), *world.get<Velocity>(player), *world.get<Hitbox>(player), dir);
+    world.get<Shooter>(player)->cooldown -= 1;
+}
+
+/**
+ * Fires the player's soulgun in the direction they last moved
+ */
+void DisplayManager::firePlayer(void)
+{
+    if (!world.isAlive(player))
+        return;
+
+    Position pos = *world.get<Position>(player);
+    double aim = convertMovementToRads(world.get<Velocity>(player)->direction);
+    Shooter &shooter = *world.get<Shooter>(player);
+    int count = shoot(shooter, patterns.get(shooter.pattern), pos, aim, true, shots);
+
+    for (int i = 0; i < count; ++i)
+        addProjectile(shots[i]);
 }
 
 /**
  * Enemy movement AI
  *
- * @param player Pointer to the player
+ * @param map Pointer to the map, used for collision and pathfinding
  */
 void DisplayManager::moveEnemies(Map *map) {
-    Position playerPos = player->getPosition();
-    Humanoid *h = NULL;
-
-    for (int i = 0; i < entities.size(); ++i) {
-        Humanoid *e = entities[i];
-        Movement mov;
-        int direction = 0;
-        int now = SDL_GetTicks();
-
-        Position enemyPos = e->getPosition();
-
-        // All hail Pythagoras
-        int distFromPlayer = static_cast<int>(sqrt(pow(abs(playerPos.x - enemyPos.x), 2) + pow(abs(playerPos.y - enemyPos.y), 2)));
-
-        switch (e->getType()) {
-            case ET_HUMAN:
-                // Humans moves randomly on diagonals
-                h = (e);
-                if (now - h->moveStartTime > HUMAN_MOVE_TIME) {
-                    h->moveStartTime = now;
-
-                    // If too far away, force to move closer to player
-                    if (distFromPlayer > ENEMY_MAX_DIST) {
-                        mov.right = (playerPos.x > enemyPos.x);
-                        mov.up = (playerPos.y < enemyPos.y);
-                    }
-                    // Otherwise be random
-                    else {
-                        // Vertical movement
-                        direction = rand() % 2;
-                        mov.up = direction;
-
-                        // Horizontal movement
-                        direction = rand() % 2;
-                        mov.right = direction;
-                    }
-                    mov.down = !mov.up;
-                    mov.left = !mov.right;
-                    if (map->isPlayerColliding(h->testMove(mov)))
-                        h->move(mov);
-                }
-                else if (map->isPlayerColliding(h->testMove(mov)))
-                {
-                    h->move(h->moveDirection);
-                }
-            break;
-            case ET_ROBOT:
-                // Robots move rigidly and nonstop
-                h = (e);
-
-                if (now - h->moveStartTime > ROBOT_MOVE_TIME) {
-                    h->moveStartTime = now;
-
-                    // If too far away, force to move closer to player
-                    if (distFromPlayer > ENEMY_MAX_DIST) {
-                        mov.right = (playerPos.x > enemyPos.x);
-                        mov.up = (playerPos.y < enemyPos.y);
-                    }
-                    // Otherwise be random
-                    else {
-                        // Vertical movement
-                        direction = rand() % 2;
-                        mov.up = direction;
-
-                        // Horizontal movement
-                        direction = rand() % 2;
-                        mov.right = direction;
-                    }
-                    mov.down = !mov.up;
-                    mov.left = !mov.right;
-
-                    // Enforce 90-degree movement
-                    if (rand() % 2 == 1) {
-                        // Disable vertical
-                        mov.up = false;
-                        mov.down = false;
-                    }
-                    else {
-                        // Disable horizontal
-                        mov.left = false;
-                        mov.right = false;
-                    }
-                    if (map->isPlayerColliding(h->testMove(mov)))
-                        h->move(mov);
-                }
-                else if (map->isPlayerColliding(h->testMove(mov))) {
-                    h->move(h->moveDirection);
-                }
-            break;
-            case ET_PLAYER:
-            case ET_PROJECTILE:
-            default:
+    Position playerPos = *world.get<Position>(player);
+    std::vector<Archetype *> &archetypes = world.getArchetypes();
+
+    // Only rebuilt when the player steps onto a different tile
+    flowField.update(map->getWalkSource(), playerPos);
+
+    // Only enemies whose move timer went off this tick make decisions
+    for (size_t i = 0; i < firedTimers.size(); ++i) {
+        if (firedTimers[i].kind == TK_RETARGET)
+            retargetEnemy(map, firedTimers[i].entity, playerPos, EnemyPolicies());
+    }
+
+    // Each enemy type lives in its own archetype, so the policy is picked once per archetype
+    for (size_t a = 0; a < archetypes.size(); ++a) {
+        if (archetypes[a]->has(CB_POSITION | CB_VELOCITY | CB_HITBOX | CB_AISTATE))
+            moveEnemyGroups(map, *archetypes[a], EnemyPolicies());
+    }
+}
+
+/**
+ * Hands an archetype to the movement loop of the policy whose tag it has
+ *
+ * @param map Pointer to the map
+ * @param arch Archetype of enemies
+ */
+template<typename... Policies>
+void DisplayManager::moveEnemyGroups(Map *map, Archetype &arch, PolicyList<Policies...>)
+{
+    ((arch.has(Policies::TAG) ? moveEnemyGroup<Policies>(map, arch) : void()), ...);
+}
+
+/**
+ * Moves every enemy of one archetype a step in the direction it picked
+ *
+ * @param map Pointer to the map
+ * @param arch Archetype of enemies controlled by Policy
+ */
+template<typename Policy>
+void DisplayManager::moveEnemyGroup(Map *map, Archetype &arch)
+{
+    std::vector<Position> &positions = arch.column<Position>();
+    std::vector<Velocity> &velocities = arch.column<Velocity>();
+    std::vector<Hitbox> &hitboxes = arch.column<Hitbox>();
+    std::vector<AIState> &states = arch.column<AIState>();
+
+    for (size_t i = 0; i < arch.size(); ++i) {
+        Position &enemyPos = positions[i];
+        Velocity &vel = velocities[i];
+        Hitbox &hitbox = hitboxes[i];
+        AIState &ai = states[i];
+
+        if (Policy::FLEES && ai.moveAway) {
+            if (!followPath(map, enemyPos, vel, hitbox, ai))
+                ai.moveAway = false;
+            continue;
+        }
+
+        // Step away from crowding enemies, otherwise go the way picked
+        if (separate(map, arch.getOwner(i), enemyPos, vel, hitbox, Policy::AXIS_ALIGNED))
+            continue;
+        if (!tryWalk(map, enemyPos, vel, hitbox, vel.direction)) {
+            // Blocked by a wall, take the way around it toward the player
+            Movement mov = flowField.getDirection(enemyPos);
+            if (Policy::AXIS_ALIGNED && (mov.left || mov.right)) {
+                mov.up = false;
+                mov.down = false;
+            }
+            tryWalk(map, enemyPos, vel, hitbox, mov);
+        }
+    }
+}
+
+/**
+ * Hands a retarget event to the policy of the enemy it is for
+ *
+ * @param map Pointer to the map
+ * @param enemy Enemy whose move timer went off, may have been destroyed
+ * @param playerPos Position of the player
+ */
+template<typename... Policies>
+void DisplayManager::retargetEnemy(Map *map, EntityHandle enemy, Position playerPos, PolicyList<Policies...>)
+{
+    ComponentMask mask = world.getMask(enemy);
+    (((mask & Policies::TAG) ? retargetEnemyAs<Policies>(map, enemy, playerPos) : void()), ...);
+}
+
+/**
+ * Picks a new direction for an enemy and schedules its next decision
+ *
+ * Robots move rigidly and nonstop on 90-degree angles, humans move
+ * randomly on diagonals and flee. Enemies too far from the player follow
+ * the flow field back toward them.
+ *
+ * @param map Pointer to the map
+ * @param enemy Enemy controlled by Policy
+ * @param playerPos Position of the player
+ */
+template<typename Policy>
+void DisplayManager::retargetEnemyAs(Map *map, EntityHandle enemy, Position playerPos)
+{
+    Position &enemyPos = *world.get<Position>(enemy);
+    Velocity &vel = *world.get<Velocity>(enemy);
+    AIState &ai = *world.get<AIState>(enemy);
+    Movement mov = { false, false, false, false };
+
+    timers.schedule(simTick + Policy::MOVE_TICKS, TK_RETARGET, enemy);
+
+    // All hail Pythagoras, squared so no root is needed
+    double dx = playerPos.x - enemyPos.x;
+    double dy = playerPos.y - enemyPos.y;
+    double distSq = dx * dx + dy * dy;
+
+    // Run somewhere far away when the player gets too close, until far enough
+    if (Policy::FLEES) {
+        if (ai.moveAway && distSq > Policy::CHASE_DIST_SQ)
+            ai.moveAway = false;
+        if (!ai.moveAway && distSq < Policy::FLEE_DIST_SQ)
+            startFleeing(map, enemyPos, ai);
+        if (ai.moveAway)
+            return;
+    }
+
+    // If too far away, follow the flow field toward the player
+    if (distSq > Policy::CHASE_DIST_SQ) {
+        mov = flowField.getDirection(enemyPos);
+    }
+    // Otherwise be random, steering clear of incoming bullets if the enemy dodges
+    else if (Policy::DODGES) {
+        mov = safestDiagonal(enemyPos, vel, world.get<Hitbox>(enemy)->rect, Policy::MOVE_TICKS);
+    }
+    else {
+        mov.up = clock->nextRandom() % 2;
+        mov.right = clock->nextRandom() % 2;
+        mov.down = !mov.up;
+        mov.left = !mov.right;
+    }
+
+    // Enforce 90-degree movement
+    if (Policy::AXIS_ALIGNED && (mov.up || mov.down) && (mov.left || mov.right)) {
+        if (clock->nextRandom() % 2 == 1) {
+            // Disable vertical
+            mov.up = false;
+            mov.down = false;
+        }
+        else {
+            // Disable horizontal
+            mov.left = false;
+            mov.right = false;
+        }
+    }
+
+    // Keep going the old way rather than turn into a wall
+    if ((mov.up || mov.down || mov.left || mov.right) && map->isPlayerColliding(vel.move(enemyPos.x, enemyPos.y, mov, vel.speed)))
+        vel.direction = mov;
+}
+
+/**
+ * Picks a distant reachable tile away from the player and plans a path to it
+ *
+ * @param map Pointer to the map
+ * @param pos Position of the human that should flee
+ * @param ai AI state of the human, receives the path
+ * @returns True if the human is now fleeing
+ */
+bool DisplayManager::startFleeing(Map *map, Position pos, AIState &ai)
+{
+    int fromTile = map->getTileIndex(pos);
+    int threatTile = map->getTileIndex(*world.get<Position>(player));
+    int target = pathfinder.findFleeTarget(fromTile, threatTile, FLEE_TARGET_SAMPLES, clock->nextRandom());
+
+    if (target < 0 || !pathfinder.findTilePath(fromTile, target, ai.path))
+        return false;
+
+    ai.pathStep = 0;
+    ai.moveAway = true;
+    return true;
+}
+
+/**
+ * Moves an entity one step along its planned path
+ *
+ * @param map Pointer to the map
+ * @param pos Entity position
+ * @param vel Entity velocity
+ * @param hitbox Entity hitbox
+ * @param ai AI state holding the path
+ * @returns False once the path is finished or blocked
+ */
+bool DisplayManager::followPath(Map *map, Position &pos, Velocity &vel, Hitbox &hitbox, AIState &ai)
+{
+    int columns = map->getColumns();
+
+    // Advance to the next tile once the current one is reached
+    Movement mov = { false, false, false, false };
+    while (ai.pathStep < ai.path.size()) {
+        int tile = ai.path[ai.pathStep];
+        mov = steerTowardTile(pos, tile / columns, tile % columns);
+        if (mov.left || mov.right || mov.up || mov.down)
             break;
+        ++ai.pathStep;
+    }
+    if (ai.pathStep >= ai.path.size())
+        return false;
+
+    return tryWalk(map, pos, vel, hitbox, mov);
+}
+
+/**
+ * Picks the diagonal that leads through the least danger, randomly among equally safe ones
+ *
+ * @param pos Entity position
+ * @param vel Entity velocity
+ * @param hitbox Entity hitbox
+ * @param ticks Ticks the entity will keep moving that way
+ * @returns Diagonal directions to move
+ */
+Movement DisplayManager::safestDiagonal(Position pos, const Velocity &vel, const SDL_Rect &hitbox, int ticks)
+{
+    Movement best = { false, false, false, false };
+    int bestDanger = -1;
+    int first = clock->nextRandom() % 4;
+
+    // Danger halfway along the move and where it ends, sampled at the entity's center
+    pos.x += hitbox.w / 2.0;
+    pos.y += hitbox.h / 2.0;
+    for (int i = 0; i < 4; ++i) {
+        int pick = (first + i) % 4;
+        Movement mov = { false, false, false, false };
+        mov.up = pick & 1;
+        mov.right = pick & 2;
+        mov.down = !mov.up;
+        mov.left = !mov.right;
+
+        int risk = danger.sample(vel.move(pos.x, pos.y, mov, vel.speed * ticks / 2))
+                 + danger.sample(vel.move(pos.x, pos.y, mov, vel.speed * ticks));
+        if (bestDanger < 0 || risk < bestDanger) {
+            best = mov;
+            bestDanger = risk;
         }
     }
+
+    return best;
+}
+
+/**
+ * Steers an enemy away from the enemies crowding it (boids-style separation)
+ *
+ * Each neighbour closer than SEPARATION_RADIUS pushes harder the closer it
+ * is. The push is blended with the direction the enemy wants to go and the
+ * result is rounded to one of the eight directions. The enemy keeps the
+ * direction it picked for later ticks.
+ *
+ * @param map Pointer to the map
+ * @param self The enemy being steered
+ * @param pos Enemy position
+ * @param vel Enemy velocity
+ * @param hitbox Enemy hitbox
+ * @param axisAligned True if the enemy can't move diagonally
+ * @returns True if the enemy was crowded and moved
+ */
+bool DisplayManager::separate(Map *map, EntityHandle self, Position &pos, Velocity &vel, Hitbox &hitbox, bool axisAligned)
+{
+    double pushX = 0;
+    double pushY = 0;
+
+    crowd.query(pos, SEPARATION_RADIUS, neighbours);
+    for (size_t i = 0; i < neighbours.size(); ++i) {
+        EntityHandle other = crowdOwners[neighbours[i].id];
+        if (other == self || !world.isAlive(other))
+            continue;
+
+        double dx = pos.x - neighbours[i].pos.x;
+        double dy = pos.y - neighbours[i].pos.y;
+        double dist = sqrt(dx * dx + dy * dy);
+
+        // Exactly on top of each other, split them sideways by id
+        if (dist == 0) {
+            dx = (other.index < self.index) ? 1 : -1;
+            dist = 1;
+        }
+
+        double strength = (SEPARATION_RADIUS - dist) / SEPARATION_RADIUS;
+        pushX += dx / dist * strength;
+        pushY += dy / dist * strength;
+    }
+    if (pushX == 0 && pushY == 0)
+        return false;
+
+    Movement wanted = vel.direction;
+    double steerX = (wanted.right - wanted.left) + SEPARATION_WEIGHT * pushX;
+    double steerY = (wanted.down - wanted.up) + SEPARATION_WEIGHT * pushY;
+
+    // Round to eight directions, or to the stronger axis for enemies that can't go diagonally
+    Movement steer = { false, false, false, false };
+    double length = sqrt(steerX * steerX + steerY * steerY);
+    double cutoff = axisAligned ? length * M_SQRT1_2 : length * sin(M_PI / 8);
+    steer.left = steerX < -cutoff;
+    steer.right = steerX > cutoff;
+    steer.up = steerY < -cutoff;
+    steer.down = steerY > cutoff;
+    if (!(steer.left || steer.right || steer.up || steer.down))
+        return false;
+
+    bool moved = tryWalk(map, pos, vel, hitbox, steer);
+    vel.direction = wanted;
+    return moved;
 }
 
 /**
  * Indicates whether an enemy is located near a coordinate
- * Todo: Do some pythagorean theorem magic to incorporate proximity
  *
  * @param x X coorindate
  * @param y Y coordinate
@@ -360,168 +759,371 @@ void DisplayManager::moveEnemies(Map *map) {
  * @returns True if an enemy is located near this coordinate
  */
 bool DisplayManager::isNearEnemy(int x, int y, int proximity) {
-    for (int i = 0; i < entities.size(); ++i) {
-        Entity *e = entities[i];
-        Position pos = e->getPosition();
+    Position pos = { static_cast<double>(x), static_cast<double>(y) };
 
-        if (pos.x == x && pos.y == y)
+    crowd.query(pos, proximity, neighbours);
+    for (size_t i = 0; i < neighbours.size(); ++i) {
+        if (world.isAlive(crowdOwners[neighbours[i].id]))
             return true;
     }
-
     return false;
 }
 
 /**
  * Adds a projectile
  * 
- * @param proj Pointer to the projectile
+ * @param proj Projectile as filled in by shoot()
+ * @returns Handle to the projectile entity
  */
-void DisplayManager::addProjectile(Projectile *proj) {
-    projectiles.push_back(proj);
+EntityHandle DisplayManager::addProjectile(const Projectile &proj) {
+    EntityHandle e = createEntity(PROJECTILE_COMPONENTS, ET_PROJECTILE);
+    Position pos = { proj.startx, proj.starty };
+    Hitbox hitbox = { { static_cast<int>(pos.x), static_cast<int>(pos.y), PROJECTILE_HITBOX_SIZE, PROJECTILE_HITBOX_SIZE } };
+    Sprite sprite = { TX_BULLET }; // change when new texture is available
+
+    *world.get<Position>(e) = pos;
+    *world.get<Hitbox>(e) = hitbox;
+    Projectile &added = *world.get<Projectile>(e);
+    added = proj;
+    added.expireTick = simTick + proj.lifetime;
+    added.danger = noDangerSplat();
+    *world.get<Sprite>(e) = sprite;
+    timers.schedule(added.expireTick, TK_EXPIRE, e);
+
+    // Only soul bullets hurt enemies, so those are what they dodge
+    if (added.soulBullet)
+        danger.splat(added.danger, pos, 0, 0, proj.lifetime);
+    return e;
 }
 
 /**
- * Removes a projectile
- * 
- * @param proj Pointer to the projectile
+ * Handles enemies shooting, only enemies whose fire timer went off are touched
  */
-void DisplayManager::removeProjectile(Projectile *proj) {
-    for (int i = 0; i < projectiles.size(); ++i) {
-        if (projectiles[i] == proj) {
-            projectiles.erase(projectiles.begin() + i);
-        }
+void DisplayManager::fireEnemies()
+{
+    Position playerPos = *world.get<Position>(player);
+
+    for (size_t i = 0; i < firedTimers.size(); ++i)
+    {
+        EntityHandle e = firedTimers[i].entity;
+        Shooter *shooter = world.get<Shooter>(e);
+        if (firedTimers[i].kind != TK_FIRE || shooter == NULL)
+            continue;
+
+        // Bring the cooldown to where it would have counted down to by now
+        Position pos = *world.get<Position>(e);
+        const BulletPattern &pattern = patterns.get(shooter->pattern);
+        shooter->cooldown -= ticksToNextShot(*shooter, pattern);
+
+        double aim = atan2(playerPos.y - pos.y, playerPos.x - pos.x);
+        int count = shoot(*shooter, pattern, pos, aim, false, shots);
+        timers.schedule(simTick + ticksToNextShot(*shooter, pattern), TK_FIRE, e);
+
+        // Add the spawned projectiles to the manager
+        for (int j = 0; j < count; ++j)
+            addProjectile(shots[j]);
     }
 }
 
 /**
- * Handles enemies shooting.
- * 
- * @param player Pointer to the player
+ * Converts a hitbox to a box for the sweep tests
+ *
+ * @param rect Hitbox rectangle
+ * @returns Same rectangle as a Box
  */
-void DisplayManager::fireEnemies()
+static Box toBox(const SDL_Rect &rect)
 {
-    Position playerPos = player->getPosition();
-    int posx = playerPos.x;
-    int posy = playerPos.y;
+    Box box = { static_cast<double>(rect.x), static_cast<double>(rect.y), static_cast<double>(rect.w), static_cast<double>(rect.h) };
+    return box;
+}
 
-    Humanoid *e = nullptr;
-    std::vector<Projectile*> p;
-    for (int i = 0; i < entities.size(); ++i)
+/**
+ * Finds the first enemy a moving soul bullet runs into and steals its soul or damages it
+ *
+ * @param shot Hitbox of the soul bullet before it moves
+ * @param dx Horizontal distance the bullet moves
+ * @param dy Vertical distance the bullet moves
+ * @param limit Fraction of the move after which the bullet is stopped by a wall
+ * @param power Damage done to robots
+ * @returns True if an enemy was hit
+ */
+bool DisplayManager::hitEnemy(const Box &shot, double dx, double dy, double limit, int power)
+{
+    std::vector<Archetype *> &archetypes = world.getArchetypes();
+    EntityHandle enemy = NULL_ENTITY;
+    double first = limit;
+
+    for (size_t a = 0; a < archetypes.size(); ++a)
     {
-        // Shooting instantiates a list of projectile objects
-        e = entities[i];
-        if (e->getType() != ET_PLAYER)
-            p = e->shoot(posx, posy, false);
+        if (!archetypes[a]->has(CB_HITBOX | CB_HEALTH | CB_AISTATE))
+            continue;
 
-        // Add the spawned projectiles to the manager
-        for (int i = 0; i < p.size(); ++i)
-            addProjectile(p[i]);
+        // Determine which entity the projectile reaches first
+        Archetype *arch = archetypes[a];
+        std::vector<Hitbox> &hitboxes = arch->column<Hitbox>();
+        for (size_t i = 0; i < arch->size(); ++i)
+        {
+            double t = sweepBox(shot, dx, dy, toBox(hitboxes[i].rect));
+            if (t <= first)
+            {
+                first = t;
+                enemy = arch->getOwner(i);
+            }
+        }
+    }
+
+    if (enemy == NULL_ENTITY)
+        return false;
+
+    // If bullet hit a humanoid steal its soul, otherwise it hit a robot
+    Health &health = *world.get<Health>(enemy);
+    health.current -= power;
+    if (swapSpots(enemy) || health.current <= 0)
+    {
+        const SDL_Rect &rect = world.get<Hitbox>(enemy)->rect;
+        Position center = { rect.x + rect.w / 2.0, rect.y + rect.h / 2.0 };
+        deaths.push_back(center);
+        removeEntity(enemy);
+        world.get<PlayerControl>(player)->score += 1;
     }
+    return true;
 }
 
 /**
  * Move projectiles using each projectile's movement function
- * 
- * @param player Pointer to the player
+ *
+ * Each move is swept from the old position to the new one, so fast
+ * projectiles can't skip over walls or entities between ticks
  */
 void DisplayManager::moveProjectiles() {
-    Position playerPos = player->getPosition();
-    Projectile *p = NULL;
-    Position projPos;
-    double thetaAim;
+    std::vector<Archetype *> &archetypes = world.getArchetypes();
+    WalkSource &grid = renderMap->getWalkSource();
+    SDL_Rect *playerBox = &world.get<Hitbox>(player)->rect; // Moves if the player swaps spots
+    double half = PROJECTILE_HITBOX_SIZE / 2.0;
 
-    // Iterate through projectiles
-    for (int i = 0; i < projectiles.size(); ++i) 
+    // Keep the danger window around the player, projectiles splat themselves back in below if it moved
+    danger.centreOn(*world.get<Position>(player));
+
+    // Projectiles that have used up their lifetime disappear
+    for (size_t i = 0; i < firedTimers.size(); ++i)
     {
-        p = projectiles[i];
-        projPos = p->getPosition();
-        thetaAim = convertCoordsToRads(projPos.x, projPos.y, playerPos.x, playerPos.y);
+        if (firedTimers[i].kind == TK_EXPIRE)
+            removeEntity(firedTimers[i].entity);
+    }
 
-        // Determine if player was hit by projectile
- 		if (!(p->isSoulBullet()) && player->entityCollision(p->getHitbox()))
+    for (size_t a = 0; a < archetypes.size(); ++a)
+    {
+        if (!archetypes[a]->has(CB_POSITION | CB_HITBOX | CB_PROJECTILE))
+            continue;
+
+        Archetype *arch = archetypes[a];
+        size_t count = arch->size();
+        shotFrom.resize(count);
+        shotWall.resize(count);
+        shotWallTile.resize(count);
+        shotBounds.clear();
+        soulBounds.clear();
+
+        // Move every projectile first, keeping the swept areas for the batched tests
+        for (size_t i = 0; i < count; ++i)
         {
-            player->damage(p->getPower());
-			removeProjectile(p);
+            Position &pos = arch->column<Position>()[i];
+            Projectile &p = arch->column<Projectile>()[i];
+
+            // Move projectile using its movement function
+            Position from = pos;
+            pos = p.move(p.startx, p.starty, pos.x, pos.y, p.direction, 0, p.speed);
+
+            // How far along the move the projectile's center runs into a wall
+            shotFrom[i] = from;
+            shotWall[i] = traceGrid(grid, TILE_WIDTH, TILE_HEIGHT, from.x + half, from.y + half, pos.x + half, pos.y + half,
+                                    &shotWallTile[i]);
+            if (p.soulBullet)
+                danger.splat(p.danger, pos, pos.x - from.x, pos.y - from.y, p.expireTick - simTick);
+
+            // Same area the exact sweep below covers, rounded outwards
+            SDL_Rect &hitbox = arch->column<Hitbox>()[i].rect;
+            double endX = hitbox.x + (pos.x - from.x);
+            double endY = hitbox.y + (pos.y - from.y);
+            BoxArray &bounds = p.soulBullet ? soulBounds : shotBounds;
+            bounds.addBounds(floor(fmin(hitbox.x, endX)), floor(fmin(hitbox.y, endY)),
+                             ceil(fmax(hitbox.x, endX)) + hitbox.w, ceil(fmax(hitbox.y, endY)) + hitbox.h);
+            (p.soulBullet ? shotBounds : soulBounds).addEmpty();
         }
-        // Or projectile was fired by player
-        else if (p->isSoulBullet())
+
+        // Enemy bullets whose swept area misses the player can't hit them
+        shotHits.resize(BOX_HIT_WORDS(count));
+        boxOverlapOneMany(playerBox->x, playerBox->y, playerBox->x + playerBox->w, playerBox->y + playerBox->h,
+                          shotBounds, shotHits.data());
+        int playerX = playerBox->x;
+        int playerY = playerBox->y;
+        cancelShots(*arch);
+
+        // Walk backwards since removing a projectile moves the last one into its row
+        for (size_t i = count; i-- > 0; )
         {
-            for (int i = 0; i < entities.size(); ++i)
+            Position &pos = arch->column<Position>()[i];
+            SDL_Rect &hitbox = arch->column<Hitbox>()[i].rect;
+            Projectile &p = arch->column<Projectile>()[i];
+            EntityHandle e = arch->getOwner(i);
+
+            Box shot = toBox(hitbox);
+            double dx = pos.x - shotFrom[i].x;
+            double dy = pos.y - shotFrom[i].y;
+            double wall = shotWall[i];
+
+            // Determine if player was hit by projectile before any wall or soul bullet
+            if ((shotHits[i / 32] >> (i % 32) & 1) && sweepBox(shot, dx, dy, toBox(*playerBox)) <= fmin(wall, shotCancel[i]))
+            {
+                world.get<Health>(player)->current -= p.power;
+                removeEntity(e);
+                continue;
+            }
+            // Or a soul bullet knocked it out of the air
+            if (shotCancel[i] <= 1)
+            {
+                removeEntity(e);
+                continue;
+            }
+            // Or projectile was fired by player
+            if (p.soulBullet && hitEnemy(shot, dx, dy, wall, p.power))
             {
-                if (entities[i]->getType() != ET_PLAYER)
+                removeEntity(e);
+
+                // Swapping spots moved the player, so the bullets still to come are filtered against where they are now
+                if (playerBox->x != playerX || playerBox->y != playerY)
                 {
-                    // Determine if the projectile hit an entity
-                    if ((entities[i])->entityCollision(p->getHitbox()))
-                    {
-                        // If bullet hit a humanoid steal its soul
-                        if (swapSpots(entities[i])) {
-                            entities.erase(entities.begin() + i);
-                            player->addScore(1);
-                        }
-                        // bullet hit a robot
-                        else if (entities[i]->damage(p->getPower()))
-                        {
-                            removeEntity(entities[i]);
-                            player->addScore(1);
-                        }
-                        removeProjectile(p);
-                    }
+                    boxOverlapOneMany(playerBox->x, playerBox->y, playerBox->x + playerBox->w, playerBox->y + playerBox->h,
+                                      shotBounds, shotHits.data());
+                    playerX = playerBox->x;
+                    playerY = playerBox->y;
                 }
-                else if (p->move(thetaAim) || !renderMap->isPlayerColliding(p->getPosition()))
-                    removeProjectile(p);
+                continue;
             }
-        }
-      	else if (p->move(thetaAim) || !renderMap->isPlayerColliding(p->getPosition()))
-        {
-            removeProjectile(p);
+
+            // Walls in the way take the hit
+            if (wall <= 1)
+            {
+                renderMap->damageWall(shotWallTile[i], p.power);
+                removeEntity(e);
+                continue;
+            }
+            hitbox.x = pos.x;
+            hitbox.y = pos.y;
         }
     }
+
+    clearShotsNearDeaths();
 }
 
 /**
- * Draws textures on the window where they are currently located
+ * Finds the enemy bullets that soul bullets run into during this move
+ * Must be called between moving the projectiles and updating their hitboxes
+ *
+ * @param arch Archetype of projectiles, with shotFrom, shotWall and the bounds filled in
  */
-void DisplayManager::refreshEntities(void) {
-    // Put textures on screen
-    SDL_Rect position;
-    SDL_Point size;
-    SDL_Texture *texture;
-    Humanoid *e;
-    Projectile *p;
+void DisplayManager::cancelShots(Archetype &arch)
+{
+    std::vector<Position> &positions = arch.column<Position>();
+    std::vector<Hitbox> &hitboxes = arch.column<Hitbox>();
 
-    // Render map
-	refreshMap();
+    shotCancel.assign(arch.size(), SWEEP_MISS);
+    projectileGrid.findPairs(soulBounds, shotBounds, shotPairs);
 
-    // Render entities
-    for (int i = 0; i < entities.size(); ++i) {
-        e = entities[i];
+    for (size_t i = 0; i < shotPairs.size(); ++i)
+    {
+        int soul = shotPairs[i].a;
+        int shot = shotPairs[i].b;
 
-        texture = txMan->getTexture(e->getImage());
-        size = txMan->getDimensions(e->getImage());
-        position.h = size.y;
-        position.w = size.x;
+        // Both moved during the tick, so sweep the soul bullet as seen from the enemy bullet
+        double dx = (positions[soul].x - shotFrom[soul].x) - (positions[shot].x - shotFrom[shot].x);
+        double dy = (positions[soul].y - shotFrom[soul].y) - (positions[shot].y - shotFrom[shot].y);
+        double t = sweepBox(toBox(hitboxes[soul].rect), dx, dy, toBox(hitboxes[shot].rect));
 
-        Position pos = applyCameraOffset(e->getPosition());
-        position.x  = pos.x;
-        position.y  = pos.y;
+        if (t <= shotWall[soul] && t <= shotWall[shot] && t < shotCancel[shot])
+            shotCancel[shot] = t;
+    }
+}
 
-        SDL_RenderCopy(renderer, texture, NULL, &position);
+/**
+ * Removes the enemy bullets near enemies that died this tick
+ */
+void DisplayManager::clearShotsNearDeaths(void)
+{
+    std::vector<Archetype *> &archetypes = world.getArchetypes();
+
+    if (DEATH_CLEAR_RADIUS <= 0 || deaths.empty())
+    {
+        deaths.clear();
+        return;
     }
 
-    // Render projectiles
-    for (int i = 0; i < projectiles.size(); ++i) {
-        p = projectiles[i];
+    // The deaths take the place of soul bullets in the broadphase
+    soulBounds.clear();
+    for (size_t i = 0; i < deaths.size(); ++i)
+        soulBounds.add(deaths[i].x - DEATH_CLEAR_RADIUS, deaths[i].y - DEATH_CLEAR_RADIUS, 2 * DEATH_CLEAR_RADIUS, 2 * DEATH_CLEAR_RADIUS);
+    deaths.clear();
 
-        texture = txMan->getTexture((p->getImage()));
-        size = txMan->getDimensions((p->getImage()));
-        position.h = size.y;
-        position.w = size.x;
+    for (size_t a = 0; a < archetypes.size(); ++a)
+    {
+        if (!archetypes[a]->has(CB_HITBOX | CB_PROJECTILE))
+            continue;
+
+        Archetype *arch = archetypes[a];
+        std::vector<Hitbox> &hitboxes = arch->column<Hitbox>();
+        std::vector<Projectile> &projectiles = arch->column<Projectile>();
+        shotBounds.clear();
+        for (size_t i = 0; i < arch->size(); ++i)
+        {
+            const SDL_Rect &rect = hitboxes[i].rect;
+            if (projectiles[i].soulBullet)
+                shotBounds.addEmpty();
+            else
+                shotBounds.add(rect.x, rect.y, rect.w, rect.h);
+        }
 
-        Position pos = applyCameraOffset(p->getPosition());
-        position.x  = pos.x;
-        position.y  = pos.y;
+        // Collect handles first, removing moves rows around
+        projectileGrid.findPairs(soulBounds, shotBounds, shotPairs);
+        shotsCleared.clear();
+        for (size_t i = 0; i < shotPairs.size(); ++i)
+            shotsCleared.push_back(arch->getOwner(shotPairs[i].b));
+        for (size_t i = 0; i < shotsCleared.size(); ++i)
+            removeEntity(shotsCleared[i]);
+    }
+}
 
-        SDL_RenderCopy(renderer, texture, NULL, &position);
+/**
+ * Draws textures on the window where they are currently located
+ */
+void DisplayManager::refreshEntities(void) {
+    std::vector<Archetype *> &archetypes = world.getArchetypes();
+
+    // Render map
+	refreshMap();
+
+    // Render entities, then projectiles on top of them
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t a = 0; a < archetypes.size(); ++a) {
+            Archetype *arch = archetypes[a];
+            if (!arch->has(CB_POSITION | CB_SPRITE) || arch->has(CB_PROJECTILE) != (pass == 1))
+                continue;
+
+            std::vector<Position> &positions = arch->column<Position>();
+            std::vector<Sprite> &sprites = arch->column<Sprite>();
+            for (size_t i = 0; i < arch->size(); ++i) {
+                SDL_Texture *texture = txMan->getTexture(sprites[i].texture);
+                SDL_Point size = txMan->getDimensions(sprites[i].texture);
+                SDL_Rect position;
+                position.h = size.y;
+                position.w = size.x;
+
+                Position pos = applyCameraOffset(positions[i]);
+                position.x  = pos.x;
+                position.y  = pos.y;
+
+                SDL_RenderCopy(renderer, texture, NULL, &position);
+            }
+        }
     }
 }
 
@@ -530,7 +1132,7 @@ void DisplayManager::refreshEntities(void) {
  */
 void DisplayManager::refreshMap() 
 {
-    Position pos = player->getPosition();
+    Position pos = *world.get<Position>(player);
     int tilesX = WINDOW_WIDTH / TILE_WIDTH; // Total horizontal tiles per window
     int tilesY = WINDOW_HEIGHT / TILE_HEIGHT; // Total vertical tiles per window
 
@@ -558,95 +1160,158 @@ void DisplayManager::refreshMap()
     if (startX < 0) startX = 0;
     if (startY < 0) startY = 0;
 
-    if (endX > MAX_TILES) endX = MAX_TILES;
-    if (endY > MAX_TILES) endY = MAX_TILES;
+    if (endX > renderMap->getColumns()) endX = renderMap->getColumns();
+    if (endY > renderMap->getRows()) endY = renderMap->getRows();
     
-	// Loops iterate over map 2D vector
+	// Loops iterate over the visible rows and columns of the map
 	for (int i = startY; i < endY; ++i)
 	{
 		for (int j = startX; j < endX; ++j)
 		{
-            MapTile *tile = renderMap->getTile(i, j);
-			SDL_Rect rect = tile->getRect();
+            MapTile tile = renderMap->getTile(i, j);
+			SDL_Rect rect = tile.getRect();
             
-			Position tilePos = { rect.x, rect.y };
+			Position tilePos = { static_cast<double>(rect.x), static_cast<double>(rect.y) };
 			Position newPos = applyCameraOffset(tilePos);
 			rect.x = newPos.x;
 			rect.y = newPos.y;
 
-			SDL_RenderCopy(renderer, tile->getTileTexture(), NULL, &rect);
+			SDL_RenderCopy(renderer, tile.getTileTexture(), NULL, &rect);
 		}
 	}
 }
 
 /**
- * Do a flash animation in a box shape
+ * Draws the queued effects over everything else and moves them on a tick
+ * Call once per frame, after the entities and HUD are drawn
+ */
+void DisplayManager::refreshEffects(void)
+{
+    Position origin = { 0, 0 };
+    effects.draw(renderer, txMan, applyCameraOffset(origin));
+    effects.advance();
+}
+
+/**
+ * Do a flash animation in a box shape, drawn over the next few frames
  * 
- * @param startx X-coord
- * @param starty Y-coord
+ * @param startx X-coord on the map
+ * @param starty Y-coord on the map
  * @param Width width of flash
  * @param Height height of flash
  */
 void DisplayManager::flashBox(int startx, int starty, int Width, int Height){
-     // Render color: RGBA
-    SDL_SetRenderDrawColor(renderer, 255, 0, 255, 255);
-
-    SDL_Rect box;
-    box.x = startx;
-    box.y = starty;
-    box.w = Width;
-    box.h = Height;
-
-    SDL_RenderFillRect(renderer, &box);
-    SDL_RenderPresent(renderer);
-    SDL_RenderClear(renderer);
+    SDL_Rect box = { startx, starty, Width, Height };
+    SDL_Color magenta = { 255, 0, 255, 255 };
+    if (renderer != NULL)
+        effects.flashBox(box, magenta, SWAP_BOX_TICKS);
 }
 
 /**
- * Do a flash animation on the entire screen
- * 
- * @param startx X-coord
- * @param starty Y-coord
- * @param Width width of flash
- * @param Height height of flash
+ * Do a flash animation on the entire screen, drawn over the next few frames
  */
 void DisplayManager::flashScreen(){
-    // Render color: RGBA
-    SDL_SetRenderDrawColor(renderer, 0, 255, 255, 255);
+    SDL_Color cyan = { 0, 255, 255, 255 };
+    if (renderer != NULL)
+        effects.flash(cyan, SWAP_FLASH_TICKS);
+}
 
-    SDL_Rect box;
-    box.x = 0;
-    box.y = 0;
-    box.w = WINDOW_WIDTH;
-    box.h = WINDOW_HEIGHT;
+/**
+ * Fades in the game over screen, which stays up for GAME_OVER_TICKS
+ */
+void DisplayManager::showGameOver(void)
+{
+    if (renderer != NULL)
+        effects.overlay(TX_GAMEOVER, GAME_OVER_TICKS, GAME_OVER_FADE_TICKS);
+}
 
-    SDL_RenderFillRect(renderer, &box);
-    SDL_RenderPresent(renderer);
+/**
+ * Indicates whether any effect is still showing
+ *
+ * @returns True until every queued effect has finished
+ */
+bool DisplayManager::hasEffects(void)
+{
+    return !effects.isEmpty();
 }
 
 /**
  * Swap the player with a humanoid entity
  * 
- * @param toSwap Pointer to the human to switch with
+ * @param toSwap Handle of the human to switch with
  * @returns True if swap was done
  */
-bool DisplayManager::swapSpots(Humanoid *toSwap)
+bool DisplayManager::swapSpots(EntityHandle toSwap)
 {
-    //double checks that the first item is the player
-    if (entities[0]->getType() == ET_PLAYER)
-    {
-        if(toSwap->getType() == ET_HUMAN)
-        {
-            Position newPos = toSwap->getPosition();
-            entities[0]->setLocation(newPos);
-            entities[0]->setHitboxPos(newPos);
-            entities[0]->setProjMoveFunc(toSwap->getProjMoveFunc());
-            entities[0]->setShootStyle(toSwap->getShootStyle());
-            flashScreen();
-            flashBox(newPos.x - 5, newPos.y - 5, newPos.x + 5, newPos.y + 5);
+    AIState *ai = world.get<AIState>(toSwap);
 
-            return true;
-        }
-    }
-    return false;
+    if (!world.isAlive(player) || ai == NULL || ai->kind != ET_HUMAN)
+        return false;
+
+    Position newPos = *world.get<Position>(toSwap);
+    Shooter *from = world.get<Shooter>(toSwap);
+    Shooter *to = world.get<Shooter>(player);
+    SDL_Rect &hitbox = world.get<Hitbox>(player)->rect;
+
+    *world.get<Position>(player) = newPos;
+    hitbox.x = newPos.x;
+    hitbox.y = newPos.y;
+    to->projectileMove = from->projectileMove;
+    to->pattern = from->pattern;
+    flashScreen();
+    flashBox(newPos.x - 5, newPos.y - 5, hitbox.w + 10, hitbox.h + 10);
+
+    return true;
+}
+
+/**
+ * Getter for the entity world, used by systems outside the display manager
+ *
+ * @returns Pointer to the world
+ */
+World *DisplayManager::getWorld(void)
+{
+    return &world;
+}
+
+/**
+ * Getter for the player entity
+ *
+ * @returns Handle to the player
+ */
+EntityHandle DisplayManager::getPlayer(void)
+{
+    return player;
+}
+
+/**
+ * Getter for the player's health
+ *
+ * @returns Remaining hit points, 0 if there is no player
+ */
+int DisplayManager::getPlayerHealth(void)
+{
+    Health *health = world.get<Health>(player);
+    return (health == NULL) ? 0 : health->current;
+}
+
+/**
+ * Getter for the player's score
+ *
+ * @returns Score, 0 if there is no player
+ */
+int DisplayManager::getPlayerScore(void)
+{
+    PlayerControl *control = world.get<PlayerControl>(player);
+    return (control == NULL) ? 0 : control->score;
+}
+
+/**
+ * Indicates whether the game is over
+ *
+ * @returns True if the player has no remaining hit points
+ */
+bool DisplayManager::isPlayerDead(void)
+{
+    return getPlayerHealth() <= 0;
 }
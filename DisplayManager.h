@@ -7,7 +7,20 @@
 #pragma once
 #include "Map.h"
 #include "TextureManager.h"
-#include "Humanoid.h"
+#include "World.h"
+#include "TimingWheel.h"
+#include "AIPolicies.h"
+#include "Shooting.h"
+#include "AABBBatch.h"
+#include "Broadphase.h"
+#include "Collision.h"
+#include "SpawnDirector.h"
+#include "Effects.h"
+#include "FlowField.h"
+#include "DangerField.h"
+#include "SpatialHash.h"
+#include "HierarchicalPathfinder.h"
+#include "SimClock.h"
 #include <vector>
 #include <math.h>
 #include <stdlib.h>
@@ -16,46 +29,115 @@
 // Distance enemies will spawn away from the player
 #define SPAWN_DIST 350
 
+// Candidate tiles looked at when a human picks somewhere to flee to
+#define FLEE_TARGET_SAMPLES 16
+
+// Enemy bullets this close to an enemy as it dies vanish with it, 0 turns this off
+#define DEATH_CLEAR_RADIUS 60
+
 #define WINDOW_HEIGHT 1024
 #define WINDOW_WIDTH 1024
 /**
  * Manages entities and where textures are drawn on-screen
+ *
+ * Entities live in an entity component system (see World.h). The update
+ * and drawing functions below are the systems that run over them, each
+ * one only walking the component arrays it needs.
+ *
+ * Made without a renderer and texture manager it runs headless, and only
+ * the update systems may be called (see BatchEnvironment). Effects such as
+ * the swap flash are then never queued, since nothing would draw and drain them.
  */
 class DisplayManager
 {
 public:
-    DisplayManager(SDL_Renderer *xRenderer, TextureManager *xTexture, Map *map);
+    DisplayManager(SDL_Renderer *xRenderer, TextureManager *xTexture, Map *map, SimClock *clock);
     ~DisplayManager(void);
 
+    void reset(void);
+
     Position applyCameraOffset(Position absPos);
 
+    void advanceTick(void);
     void spawnEnemies(Map *map);
-    Humanoid *spawnHumanoid(Map *map, EntityType type);
+    EntityHandle spawnHumanoid(Map *map, EntityType type, bool basic = false);
+    void movePlayer(Map *map, Movement &dir);
+    void firePlayer(void);
     void moveEnemies(Map *map);
     bool isNearEnemy(int x, int y, int proximity);
     void fireEnemies(void);
     void moveProjectiles(void);
 
-    void addEntity(Humanoid *entity);
-    void removeEntity(Humanoid *entity);
-    void addProjectile(Projectile *proj);
-    void removeProjectile(Projectile *proj);
+    EntityHandle addProjectile(const Projectile &proj);
+    void removeEntity(EntityHandle entity);
     void refreshEntities(void);
     void refreshMap(void); 
 
+    void refreshEffects(void);
+
     void flashBox(int startx, int starty, int Width, int Height);
     void flashScreen(void);
-    bool swapSpots(Humanoid *toSwap);
+    void showGameOver(void);
+    bool hasEffects(void);
+    bool swapSpots(EntityHandle toSwap);
+
+    World *getWorld(void);
+    EntityHandle getPlayer(void);
+    int getPlayerHealth(void);
+    int getPlayerScore(void);
+    bool isPlayerDead(void);
 
 private:
-    std::vector<Humanoid *> entities;
-    std::vector<Projectile *> projectiles;
+    EntityHandle createEntity(ComponentMask mask, EntityType type);
+    EntityType getEntityType(EntityHandle entity);
+    bool hitEnemy(const Box &shot, double dx, double dy, double limit, int power);
+    void cancelShots(Archetype &arch);
+    void clearShotsNearDeaths(void);
+    template<typename... Policies> void moveEnemyGroups(Map *map, Archetype &arch, PolicyList<Policies...>);
+    template<typename Policy> void moveEnemyGroup(Map *map, Archetype &arch);
+    template<typename... Policies> void retargetEnemy(Map *map, EntityHandle enemy, Position playerPos, PolicyList<Policies...>);
+    template<typename Policy> void retargetEnemyAs(Map *map, EntityHandle enemy, Position playerPos);
+    bool startFleeing(Map *map, Position pos, AIState &ai);
+    bool followPath(Map *map, Position &pos, Velocity &vel, Hitbox &hitbox, AIState &ai);
+    Movement safestDiagonal(Position pos, const Velocity &vel, const SDL_Rect &hitbox, int ticks);
+    bool separate(Map *map, EntityHandle self, Position &pos, Velocity &vel, Hitbox &hitbox, bool axisAligned);
+    void indexEnemies(void);
+    void indexEnemy(EntityHandle enemy, Position pos);
+    void applyMapEdits(void);
+
+    World world;
     SDL_Renderer *renderer;
 		Map *renderMap;
     TextureManager *txMan;
+    SimClock *clock; // Stepped with the simulation
+    TextureHandle entityTextures[TX_BULLET + 1]; // Every entity texture, held so they outlast unheld ones in the texture budget
+
+    SpawnDirector director;
+    PatternLibrary patterns;
+    FlowField flowField; // Shared path toward the player for all enemies
+    DangerField danger;  // Where soul bullets are about to fly, for enemies that dodge
+    EffectQueue effects; // Flashes and overlays drawn over the next frames
+    SpatialHash crowd;   // Enemy positions at the start of the tick, for neighbour queries
+    std::vector<EntityHandle> crowdOwners; // Enemy behind each crowd id, which may have died since it was indexed
+    std::vector<SpatialEntry> neighbours; // Scratch for crowd queries
+    HierarchicalPathfinder pathfinder; // Long routes, used by fleeing humans
+    SpawnRequest spawnRequests[SPAWN_MAX_BATCH];
+    Projectile shots[MAX_SHOTS];
+    int simTick; // Number of times the simulation has been stepped
+    TimingWheel timers; // Enemy decisions and shots, projectile lifetimes
+    std::vector<TimerEvent> firedTimers; // Timers that went off this tick
 
-    int newSpawnCooldown;
-    int maxSpawnCooldown;
-    bool firstSpawn;
-    Humanoid *player;
+    // Scratch space for moveProjectiles, kept between frames to avoid reallocating
+    std::vector<Position> shotFrom;
+    std::vector<double> shotWall;
+    std::vector<int> shotWallTile; // Wall tile each projectile runs into, -1 for none
+    BoxArray shotBounds;   // Swept areas of enemy bullets, empty lanes for soul bullets
+    BoxArray soulBounds;   // Swept areas of soul bullets, empty lanes for enemy bullets
+    std::vector<uint32_t> shotHits;
+    std::vector<double> shotCancel; // When a soul bullet knocks out each enemy bullet
+    std::vector<BoxPair> shotPairs;
+    GridBroadphase projectileGrid;
+    std::vector<EntityHandle> shotsCleared; // Enemy bullets near this tick's deaths
+    std::vector<Position> deaths; // Centers of enemies that died this tick
+    EntityHandle player;
 };
@@ -0,0 +1,154 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "Effects.h"
+
+/**
+ * Queues a whole-window flash that fades away
+ *
+ * @param color Flash colour
+ * @param ticks How long the flash takes to fade
+ */
+void EffectQueue::flash(SDL_Color color, int ticks)
+{
+    Effect effect = { EF_FILL, { 0, 0, 0, 0 }, false, color, TX_TOTAL, ticks, 0, ticks, 0 };
+    add(effect);
+}
+
+/**
+ * Queues a flash over part of the map that fades away
+ *
+ * @param box Area of the map to flash
+ * @param color Flash colour
+ * @param ticks How long the flash takes to fade
+ */
+void EffectQueue::flashBox(SDL_Rect box, SDL_Color color, int ticks)
+{
+    Effect effect = { EF_FILL, box, true, color, TX_TOTAL, ticks, 0, ticks, 0 };
+    add(effect);
+}
+
+/**
+ * Queues a texture over the whole window that fades in and stays
+ *
+ * @param texture Texture to show
+ * @param ticks How long it is shown, including the fade
+ * @param fadeTicks How long it takes to fade in
+ */
+void EffectQueue::overlay(TextureID texture, int ticks, int fadeTicks)
+{
+    SDL_Color opaque = { 255, 255, 255, 255 };
+    Effect effect = { EF_TEXTURE, { 0, 0, 0, 0 }, false, opaque, texture, ticks, fadeTicks, 0, 0 };
+    add(effect);
+}
+
+/**
+ * Queues an effect, starting on the next frame drawn
+ *
+ * @param effect Effect to show
+ */
+void EffectQueue::add(const Effect &effect)
+{
+    effects.push_back(effect);
+}
+
+/**
+ * Drops every effect
+ */
+void EffectQueue::clear(void)
+{
+    effects.clear();
+}
+
+/**
+ * Draws every effect in the order they were queued
+ *
+ * @param renderer Renderer to draw with
+ * @param txMan Texture manager for EF_TEXTURE effects
+ * @param cameraOffset Added to map positions to get window positions
+ */
+void EffectQueue::draw(SDL_Renderer *renderer, TextureManager *txMan, Position cameraOffset) const
+{
+    if (effects.empty())
+        return;
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    for (size_t i = 0; i < effects.size(); ++i)
+    {
+        const Effect &effect = effects[i];
+        SDL_Rect area = effect.area;
+        SDL_Rect *target = &area;
+        Uint8 alpha = opacity(effect);
+
+        if (area.w == 0 || area.h == 0)
+            target = NULL;
+        else if (effect.inWorld)
+        {
+            area.x += cameraOffset.x;
+            area.y += cameraOffset.y;
+        }
+
+        if (effect.kind == EF_FILL)
+        {
+            SDL_SetRenderDrawColor(renderer, effect.color.r, effect.color.g, effect.color.b, alpha);
+            SDL_RenderFillRect(renderer, target);
+        }
+        else
+        {
+            SDL_Texture *texture = txMan->getTexture(effect.texture);
+            txMan->setAlpha(effect.texture, alpha);
+            SDL_RenderCopy(renderer, texture, NULL, target);
+            txMan->setAlpha(effect.texture, 255);
+        }
+    }
+
+    // Leave the renderer as the rest of the frame expects, clearing uses the draw colour
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+}
+
+/**
+ * Moves every effect on by a tick, dropping the ones that are done
+ */
+void EffectQueue::advance(void)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < effects.size(); ++i)
+    {
+        if (++effects[i].age < effects[i].duration)
+            effects[kept++] = effects[i];
+    }
+    effects.resize(kept);
+}
+
+/**
+ * Indicates whether any effect is still showing
+ *
+ * @returns True if there is nothing left to draw
+ */
+bool EffectQueue::isEmpty(void) const
+{
+    return effects.empty();
+}
+
+/**
+ * Works out how opaque an effect is at its age
+ *
+ * @param effect Effect being drawn
+ * @returns Alpha from 0 to the effect colour's alpha
+ */
+Uint8 EffectQueue::opacity(const Effect &effect)
+{
+    double scale = 1;
+
+    if (effect.fadeIn > 0 && effect.age < effect.fadeIn)
+        scale = static_cast<double>(effect.age + 1) / effect.fadeIn;
+    int left = effect.duration - effect.age;
+    if (effect.fadeOut > 0 && left < effect.fadeOut)
+        scale *= static_cast<double>(left) / effect.fadeOut;
+
+    return static_cast<Uint8>(effect.color.a * scale);
+}
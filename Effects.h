@@ -0,0 +1,72 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _EFFECTS_
+#define _EFFECTS_
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "movement.h"
+#include "TextureManager.h"
+
+// Durations in ticks (a tick is about 15 ms)
+#define SWAP_FLASH_TICKS 8
+#define SWAP_BOX_TICKS 12
+#define GAME_OVER_FADE_TICKS 20
+#define GAME_OVER_TICKS 200
+
+// What an effect draws
+enum EffectKind
+{
+    EF_FILL,    // A coloured rectangle
+    EF_TEXTURE  // A texture stretched over its area
+};
+
+/**
+ * A timed visual effect
+ *
+ * Opacity ramps up over the first fadeIn ticks and down over the last
+ * fadeOut ticks, and the effect is dropped once its duration is up.
+ */
+struct Effect
+{
+    EffectKind kind;
+    SDL_Rect area;     // Where to draw, the whole window if w or h is 0
+    bool inWorld;      // True if area is a map position that follows the camera
+    SDL_Color color;   // Fill colour, alpha is the most opaque it gets
+    TextureID texture; // Texture for EF_TEXTURE
+    int duration;      // Ticks the effect lasts
+    int fadeIn;        // Ticks spent becoming opaque
+    int fadeOut;       // Ticks spent becoming transparent at the end
+    int age;           // Ticks since it started
+};
+
+/**
+ * Effects waiting to be drawn
+ *
+ * Effects are queued by the simulation and drawn on top of everything else
+ * during the normal render pass, so nothing ever presents a frame early or
+ * waits for an effect to finish.
+ */
+class EffectQueue
+{
+public:
+    void flash(SDL_Color color, int ticks);
+    void flashBox(SDL_Rect box, SDL_Color color, int ticks);
+    void overlay(TextureID texture, int ticks, int fadeTicks);
+    void add(const Effect &effect);
+    void clear(void);
+
+    void draw(SDL_Renderer *renderer, TextureManager *txMan, Position cameraOffset) const;
+    void advance(void);
+    bool isEmpty(void) const;
+
+private:
+    static Uint8 opacity(const Effect &effect);
+
+    std::vector<Effect> effects;
+};
+#endif
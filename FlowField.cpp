@@ -0,0 +1,265 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "FlowField.h"
+#include <algorithm>
+#include "Map.h"
+
+// Neighbour offsets, orthogonal first so they win ties against diagonals
+static const int NEIGHBOUR_X[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+static const int NEIGHBOUR_Y[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+/**
+ * Constructor, starts with an empty field
+ */
+FlowField::FlowField(void):
+    mapRows(0),
+    mapColumns(0),
+    targetTile(-1),
+    top(0),
+    left(0),
+    rows(0),
+    columns(0)
+{
+}
+
+/**
+ * Rebuilds the field if the target has moved onto a different tile
+ *
+ * @param grid Walkable tiles
+ * @param target Position the field should lead to
+ * @returns True if the field was rebuilt
+ */
+bool FlowField::update(WalkSource &grid, Position target)
+{
+    int targetRow = static_cast<int>(target.y + ENTITY_FOOT_HEIGHT / 2) / TILE_HEIGHT;
+    int targetCol = static_cast<int>(target.x + ENTITY_FOOT_WIDTH / 2) / TILE_WIDTH;
+
+    if (!grid.inBounds(targetRow, targetCol))
+        return false;
+    if (mapRows == grid.getRows() && mapColumns == grid.getColumns() && targetTile == targetRow * mapColumns + targetCol)
+        return false;
+
+    build(grid, targetRow, targetCol);
+    return true;
+}
+
+/**
+ * Patches the field after a tile changed, without searching the window again
+ *
+ * A tile that opened up can only shorten distances, so the tiles around it
+ * are searched outward again in order of distance, stopping wherever nothing
+ * got shorter. A tile that closed on a path lengthens distances behind it,
+ * so the field is rebuilt on the next update instead.
+ *
+ * @param grid Walkable tiles, already changed
+ * @param row Row of the tile that changed on the map
+ * @param col Column of the tile that changed on the map
+ */
+void FlowField::updateTile(WalkSource &grid, int row, int col)
+{
+    if (targetTile < 0 || mapRows != grid.getRows() || mapColumns != grid.getColumns())
+        return;
+
+    // Tiles outside the window are walls as far as the field knows
+    row -= top;
+    col -= left;
+    if (row < 0 || col < 0 || row >= rows || col >= columns)
+        return;
+
+    int tile = row * columns + col;
+    walkable[tile] = grid.isWalkable(top + row, left + col);
+    if (!walkable[tile])
+    {
+        // An unreachable tile had no path through it, nor did the gaps beside it
+        if (distance[tile] != FLOW_UNREACHABLE)
+            invalidate();
+        return;
+    }
+
+    // Every step the tile opened up starts and ends next to it
+    seeds.clear();
+    for (int r = row - 1; r <= row + 1; ++r)
+    {
+        for (int c = col - 1; c <= col + 1; ++c)
+        {
+            if (isOpen(r, c) && distance[r * columns + c] != FLOW_UNREACHABLE)
+                seeds.push_back(r * columns + c);
+        }
+    }
+    std::sort(seeds.begin(), seeds.end(), [this](int a, int b) { return distance[a] < distance[b]; });
+
+    // Seeds and the tiles they shorten are taken nearest first, like the full search
+    size_t next = 0;
+    size_t head = 0;
+    size_t tail = 0;
+    while (next < seeds.size() || head < tail)
+    {
+        if (head == tail || (next < seeds.size() && distance[seeds[next]] <= distance[frontier[head]]))
+            relax(seeds[next++], tail);
+        else
+            relax(frontier[head++], tail);
+    }
+}
+
+/**
+ * Forces the next update to rebuild the field (e.g. after the map changed)
+ */
+void FlowField::invalidate(void)
+{
+    targetTile = -1;
+}
+
+/**
+ * Directions that take an entity one tile closer to the target
+ *
+ * @param pos Entity position
+ * @returns Directions to move, straight for the target outside the window,
+ *          all false if at the target or unreachable
+ */
+Movement FlowField::getDirection(Position pos)
+{
+    Movement dir = { false, false, false, false };
+    int tile = tileIndex(pos);
+
+    if (tile < 0)
+        return (targetTile < 0) ? dir : steerTowardTile(pos, targetTile / mapColumns, targetTile % mapColumns);
+    if (distance[tile] <= 0)
+        return dir;
+
+    return steerTowardTile(pos, top + tile / columns + stepY[tile], left + tile % columns + stepX[tile]);
+}
+
+/**
+ * Number of tiles between a position and the target
+ *
+ * @param pos Entity position
+ * @returns Steps to the target, or FLOW_UNREACHABLE if unreachable or outside the window
+ */
+int FlowField::getDistance(Position pos)
+{
+    int tile = tileIndex(pos);
+    return (tile < 0) ? FLOW_UNREACHABLE : distance[tile];
+}
+
+/**
+ * Converts a position to a tile index in the window
+ *
+ * @param pos Entity position
+ * @returns Tile index, or -1 if outside the window
+ */
+int FlowField::tileIndex(Position pos)
+{
+    int row = static_cast<int>(pos.y + ENTITY_FOOT_HEIGHT / 2) / TILE_HEIGHT - top;
+    int col = static_cast<int>(pos.x + ENTITY_FOOT_WIDTH / 2) / TILE_WIDTH - left;
+
+    if (targetTile < 0 || pos.x < 0 || pos.y < 0 || row < 0 || col < 0 || row >= rows || col >= columns)
+        return -1;
+    return row * columns + col;
+}
+
+/**
+ * Breadth-first search outward from the target tile, across the window around it
+ *
+ * Diagonal steps are only taken when both orthogonal tiles are open,
+ * otherwise entities would try to squeeze between two walls
+ *
+ * @param grid Walkable tiles
+ * @param targetRow Row of the target tile on the map
+ * @param targetCol Column of the target tile on the map
+ */
+void FlowField::build(WalkSource &grid, int targetRow, int targetCol)
+{
+    mapRows = grid.getRows();
+    mapColumns = grid.getColumns();
+    targetTile = targetRow * mapColumns + targetCol;
+    top = std::max(targetRow - FLOW_WINDOW_RADIUS, 0);
+    left = std::max(targetCol - FLOW_WINDOW_RADIUS, 0);
+    rows = std::min(targetRow + FLOW_WINDOW_RADIUS + 1, mapRows) - top;
+    columns = std::min(targetCol + FLOW_WINDOW_RADIUS + 1, mapColumns) - left;
+
+    size_t total = static_cast<size_t>(rows) * columns;
+    walkable.resize(total);
+    distance.assign(total, FLOW_UNREACHABLE);
+    stepX.assign(total, 0);
+    stepY.assign(total, 0);
+    frontier.resize(total);
+
+    // Every tile of the window is looked at, so it is read from the map once up front
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int col = 0; col < columns; ++col)
+            walkable[row * columns + col] = grid.isWalkable(top + row, left + col);
+    }
+
+    size_t head = 0;
+    size_t tail = 0;
+    int start = (targetRow - top) * columns + targetCol - left;
+    distance[start] = 0;
+    frontier[tail++] = start;
+
+    while (head < tail)
+        relax(frontier[head++], tail);
+}
+
+/**
+ * Indicates whether a tile of the window can be walked on
+ *
+ * @param row Row in the window
+ * @param col Column in the window
+ * @returns False if the tile is blocked or outside the window
+ */
+bool FlowField::isOpen(int row, int col) const
+{
+    return row >= 0 && col >= 0 && row < rows && col < columns && walkable[row * columns + col];
+}
+
+/**
+ * Indicates whether an entity can step from a tile to one of its neighbours
+ *
+ * @param row Row of the tile stepped from, in the window
+ * @param col Column of the tile stepped from, in the window
+ * @param n Index into the neighbour offsets
+ * @returns True if the neighbour is walkable and reachable in one step
+ */
+bool FlowField::canStep(int row, int col, int n) const
+{
+    int nRow = row + NEIGHBOUR_Y[n];
+    int nCol = col + NEIGHBOUR_X[n];
+
+    if (!isOpen(nRow, nCol))
+        return false;
+    return n < 4 || (isOpen(row, nCol) && isOpen(nRow, col));
+}
+
+/**
+ * Leads every neighbour of a tile through it if that is shorter than its
+ * current way to the target, queueing the ones that changed
+ *
+ * @param tile Tile index in the window, must have a distance
+ * @param tail End of the queue in frontier, advanced past the queued tiles
+ */
+void FlowField::relax(int tile, size_t &tail)
+{
+    int row = tile / columns;
+    int col = tile % columns;
+
+    for (int n = 0; n < 8; ++n)
+    {
+        if (!canStep(row, col, n))
+            continue;
+
+        int next = (row + NEIGHBOUR_Y[n]) * columns + col + NEIGHBOUR_X[n];
+        if (distance[next] != FLOW_UNREACHABLE && distance[next] <= distance[tile] + 1)
+            continue;
+
+        // The neighbour reaches the target by stepping back onto this tile
+        distance[next] = distance[tile] + 1;
+        stepX[next] = -NEIGHBOUR_X[n];
+        stepY[next] = -NEIGHBOUR_Y[n];
+        frontier[tail++] = next;
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _FLOWFIELD_
+#define _FLOWFIELD_
+
+#include <vector>
+#include "movement.h"
+#include "WalkGrid.h"
+
+// Distance stored for tiles that cannot reach the target
+#define FLOW_UNREACHABLE -1
+
+// Tiles the field reaches out from the target in each direction, well inside the chunks kept around the player
+#define FLOW_WINDOW_RADIUS 32
+
+/**
+ * Breadth-first flow field toward a single target tile
+ *
+ * Every walkable tile stores the neighbouring tile that is one step closer
+ * to the target, so any number of enemies can look up where to go in O(1).
+ * The field is only rebuilt when the target moves to a different tile.
+ * A tile that opens up is patched in place, spreading out only as far as
+ * the distances it shortens.
+ *
+ * The field only covers a window of tiles around the target, so it costs
+ * the same however big the map is. Enemies outside the window head
+ * straight for the target until they are in it.
+ */
+class FlowField
+{
+public:
+    FlowField(void);
+
+    bool update(WalkSource &grid, Position target);
+    void updateTile(WalkSource &grid, int row, int col);
+    void invalidate(void);
+
+    Movement getDirection(Position pos);
+    int getDistance(Position pos);
+
+private:
+    int tileIndex(Position pos);
+    void build(WalkSource &grid, int targetRow, int targetCol);
+    bool isOpen(int row, int col) const;
+    bool canStep(int row, int col, int n) const;
+    void relax(int tile, size_t &tail);
+
+    int mapRows;    // Size of the map the field was built on
+    int mapColumns;
+    int targetTile; // Tile index on the map the field currently points to
+    int top;        // Map row and column of the window's top left tile
+    int left;
+    int rows;       // Size of the window
+    int columns;
+
+    // Per tile of the window
+    std::vector<unsigned char> walkable; // Walkable tiles, read from the map once per build
+    std::vector<int> distance;           // Steps to the target
+    std::vector<signed char> stepX;      // Column offset of the next tile
+    std::vector<signed char> stepY;      // Row offset of the next tile
+    std::vector<int> frontier;           // BFS queue, kept to avoid reallocating
+    std::vector<int> seeds;              // Tiles around a changed tile, kept to avoid reallocating
+};
+#endif
@@ -0,0 +1,111 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "GameSession.h"
+#include <chrono>
+
+/**
+ * Constructor, nothing is spawned until start is called
+ *
+ * @param dispMan Display manager holding the entities
+ * @param hud HUD showing the run's timer and score
+ * @param map Map the runs are played on
+ * @param restarts If true, a new run starts after each game over, otherwise the session ends
+ */
+GameSession::GameSession(DisplayManager *dispMan, HUD *hud, Map *map, bool restarts):
+    dispMan(dispMan),
+    hud(hud),
+    map(map),
+    restarts(restarts),
+    over(false),
+    finished(false),
+    runs(0),
+    lastStartMs(0)
+{
+}
+
+/**
+ * Starts a new run, clearing whatever is left of the last one
+ */
+void GameSession::start(void)
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    map->revertEdits();
+    dispMan->reset();
+    dispMan->spawnHumanoid(map, ET_PLAYER);
+    hud->resetTimer();
+    hud->startTimer();
+    over = false;
+    ++runs;
+
+    lastStartMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+/**
+ * Shows the game over screen once the player dies, then either starts the
+ * next run or finishes the session. Call once per frame before stepping the simulation.
+ *
+ * @returns True while the run is over and the simulation should not be stepped
+ */
+bool GameSession::update(void)
+{
+    if (!over && dispMan->isPlayerDead())
+    {
+        over = true;
+        hud->stopTimer();
+        dispMan->showGameOver();
+    }
+    else if (over && !finished && !dispMan->hasEffects())
+    {
+        if (restarts)
+            start();
+        else
+            finished = true;
+    }
+
+    return over;
+}
+
+/**
+ * Indicates whether the current run has ended
+ *
+ * @returns True from the player's death until the next run starts
+ */
+bool GameSession::isOver(void)
+{
+    return over;
+}
+
+/**
+ * Indicates whether the session is done and the game should close
+ *
+ * @returns True once a session that doesn't restart has shown its game over screen
+ */
+bool GameSession::isFinished(void)
+{
+    return finished;
+}
+
+/**
+ * Getter for the number of runs started
+ *
+ * @returns Runs started, including the current one
+ */
+int GameSession::getRunCount(void)
+{
+    return runs;
+}
+
+/**
+ * Getter for how long the latest run took to start
+ *
+ * @returns Milliseconds spent resetting and spawning the player
+ */
+double GameSession::getLastStartMs(void)
+{
+    return lastStartMs;
+}
@@ -0,0 +1,49 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _GAMESESSION_
+#define _GAMESESSION_
+
+#include "DisplayManager.h"
+#include "HUD.h"
+#include "Map.h"
+
+/**
+ * One run of the game from spawning the player to game over
+ *
+ * Starting a new run resets the display manager and HUD in place, so the
+ * textures, fonts, map, pathfinder and entity storage loaded for the first
+ * run are reused and a restart takes milliseconds instead of a relaunch.
+ *
+ * Only sessions made to restart do so after game over, for soak runs. A
+ * session played from the keyboard ends once the game over screen has been
+ * shown, as the game always has.
+ */
+class GameSession
+{
+public:
+    GameSession(DisplayManager *dispMan, HUD *hud, Map *map, bool restarts);
+
+    void start(void);
+    bool update(void);
+
+    bool isOver(void);
+    bool isFinished(void);
+    int getRunCount(void);
+    double getLastStartMs(void);
+
+private:
+    DisplayManager *dispMan;
+    HUD *hud;
+    Map *map;
+
+    bool restarts;      // Start the next run by itself after game over
+    bool over;          // True from the player's death until the next run starts
+    bool finished;      // True once a session that doesn't restart has shown its game over screen
+    int runs;           // Runs started so far
+    double lastStartMs; // How long starting the latest run took
+};
+#endif
@@ -10,18 +10,34 @@
  * Constructor
  * 
  * @param renderer External SDL renderer
- * @param player Pointer to player object
- * @param txMan Pointer to texture manager
+ * @param dispMan Pointer to the display manager holding the player
+ * @param clock Simulation clock the timer reads
+ * @param fontNormal Font for regular text, opened with openFont, the HUD closes it
+ * @param fontBold Font for bold text, opened with openFont, the HUD closes it
  */
-HUD::HUD(SDL_Renderer *renderer, Humanoid *player, TextureManager *txMan): lastTime(0), elapsedTime(0), isPaused(false), renderer(renderer), player(player), fontNormal(NULL), fontBold(NULL) {
-    fontBold = TTF_OpenFont("assets/fonts/Courier New Bold.ttf", FONT_SIZE);
-    fontNormal = TTF_OpenFont("assets/fonts/Courier New.ttf", FONT_SIZE);
+HUD::HUD(SDL_Renderer *renderer, DisplayManager *dispMan, SimClock *clock, TTF_Font *fontNormal, TTF_Font *fontBold): lastTime(0), elapsedTime(0), isPaused(false), renderer(renderer), dispMan(dispMan), clock(clock), fontNormal(fontNormal), fontBold(fontBold) {
+}
+
+/**
+ * Opens a font from the asset bundle, or from its own file if it isn't bundled
+ * Doesn't need a renderer, so fonts can be opened on another thread while the window is created
+ * 
+ * @param bundle Asset bundle, used in place so it must outlive the font
+ * @param path Path to the font file, e.g. FONT_NORMAL_PATH
+ * @returns The font, NULL if it failed to open
+ */
+TTF_Font *HUD::openFont(const AssetBundle &bundle, const char *path) {
+    const AssetEntry *entry = bundle.find(path);
+
+    if (entry != NULL)
+        return TTF_OpenFontRW(SDL_RWFromConstMem(bundle.getData(entry), entry->size), 1, FONT_SIZE);
+    return TTF_OpenFont(path, FONT_SIZE);
 }
 
 // Destructor
 HUD::~HUD(void) {
     renderer = NULL;
-    player = NULL;
+    dispMan = NULL;
     elapsedTime = 0;
     isPaused = false;
     TTF_CloseFont(fontNormal);
@@ -35,8 +51,8 @@ void HUD::refresh(void) {
     int lastX = 0;
 
     if (!isPaused) {
-        elapsedTime += SDL_GetTicks() - lastTime;
-        lastTime = SDL_GetTicks();
+        elapsedTime += static_cast<int>(clock->getMs()) - lastTime;
+        lastTime = static_cast<int>(clock->getMs());
 
         // Prepare the timer info
         TimeUnits t = getTime();
@@ -53,10 +69,10 @@ void HUD::refresh(void) {
         lastX = renderText(time, false, lastX);
 
         lastX = renderText("Score: ", true, lastX + TEXT_GAP);
-        lastX = renderText(std::to_string(player->getScore()), false, lastX);
+        lastX = renderText(std::to_string(dispMan->getPlayerScore()), false, lastX);
 
         lastX = renderText("Health: ", true, lastX + TEXT_GAP);
-        lastX = renderText(std::to_string(player->getHealth()), false, lastX);
+        lastX = renderText(std::to_string(dispMan->getPlayerHealth()), false, lastX);
     }
 }
 
@@ -92,6 +108,7 @@ int HUD::renderText(std::string text, bool isBold, int offsetX) {
  */
 void HUD::startTimer(void) {
     isPaused = false;
+    lastTime = static_cast<int>(clock->getMs());
 }
 
 /**
@@ -99,8 +116,8 @@ void HUD::startTimer(void) {
  */
 void HUD::stopTimer(void) {
     isPaused = true;
-    elapsedTime += SDL_GetTicks() - lastTime;
-    lastTime = SDL_GetTicks();
+    elapsedTime += static_cast<int>(clock->getMs()) - lastTime;
+    lastTime = static_cast<int>(clock->getMs());
 }
 
 /**
@@ -108,7 +125,7 @@ void HUD::stopTimer(void) {
  */
 void HUD::resetTimer(void) {
     elapsedTime = 0;
-    lastTime = 0;
+    lastTime = static_cast<int>(clock->getMs());
 }
 
 /**
@@ -8,13 +8,15 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
-#include "Humanoid.h"
+#include "DisplayManager.h"
 #include "TextureManager.h"
 #include <string.h>
 
 #define HUD_WIDTH 250
 #define HUD_HEIGHT 250
 #define FONT_SIZE 24
+#define FONT_NORMAL_PATH "assets/fonts/Courier New.ttf"
+#define FONT_BOLD_PATH "assets/fonts/Courier New Bold.ttf"
 #define TEXT_GAP 25
 
 #define HUD_X 25
@@ -34,8 +36,9 @@ struct TimeUnits {
 class HUD
 {
 public:
-    HUD(SDL_Renderer *renderer, Humanoid *player, TextureManager *txMan);
+    HUD(SDL_Renderer *renderer, DisplayManager *dispMan, SimClock *clock, TTF_Font *fontNormal, TTF_Font *fontBold);
     ~HUD(void);
+    static TTF_Font *openFont(const AssetBundle &bundle, const char *path);
     void refresh(void);
 
     void startTimer(void);
@@ -50,7 +53,8 @@ private:
     bool isPaused;
 
     SDL_Renderer *renderer;
-    Humanoid *player;
+    DisplayManager *dispMan;
+    SimClock *clock; // The timer shows simulated time
 
     TTF_Font *fontNormal;
     TTF_Font *fontBold;
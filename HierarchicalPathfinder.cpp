@@ -0,0 +1,1131 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "HierarchicalPathfinder.h"
+#include <algorithm>
+#include <functional>
+#include <stdlib.h>
+
+// Neighbour offsets, orthogonal first
+static const int STEP_ROW[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+static const int STEP_COL[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+
+/**
+ * Constructor, starts with an empty graph
+ */
+HierarchicalPathfinder::HierarchicalPathfinder(void):
+    grid(NULL),
+    rows(0),
+    columns(0),
+    sectorsX(0),
+    sectorsY(0),
+    deadNodes(0),
+    deadRegions(0),
+    queryStamp(0),
+    cacheHits(0),
+    cacheMisses(0)
+{
+}
+
+/**
+ * Builds the sector regions and portal graph for a grid
+ * The grid must outlive the pathfinder or be rebuilt before the next query
+ *
+ * @param walkSource Walkable tiles
+ */
+void HierarchicalPathfinder::build(WalkSource &walkSource)
+{
+    grid = &walkSource;
+    rows = grid->getRows();
+    columns = grid->getColumns();
+    sectorsX = (columns + HPA_SECTOR_SIZE - 1) / HPA_SECTOR_SIZE;
+    sectorsY = (rows + HPA_SECTOR_SIZE - 1) / HPA_SECTOR_SIZE;
+
+    tileRegion.assign(static_cast<size_t>(rows) * columns, HPA_NO_REGION);
+    sectorFirstRegion.assign(sectorsX * sectorsY, 0);
+    sectorRegionCount.assign(sectorsX * sectorsY, 0);
+    regions.clear();
+    nodeTile.clear();
+    nodeRegion.clear();
+    edges.clear();
+    tileNode.clear();
+    localDist.assign(HPA_SECTOR_SIZE * HPA_SECTOR_SIZE, -1);
+    localParent.assign(HPA_SECTOR_SIZE * HPA_SECTOR_SIZE, -1);
+    localQueue.resize(HPA_SECTOR_SIZE * HPA_SECTOR_SIZE);
+
+    // Split every sector into regions of mutually reachable tiles
+    for (int sy = 0; sy < sectorsY; ++sy)
+    {
+        for (int sx = 0; sx < sectorsX; ++sx)
+        {
+            sectorFirstRegion[sy * sectorsX + sx] = regions.size();
+            labelSector(sx, sy);
+            sectorRegionCount[sy * sectorsX + sx] = regions.size() - sectorFirstRegion[sy * sectorsX + sx];
+        }
+    }
+
+    // Find openings along every border shared by two sectors
+    for (int sy = 0; sy < sectorsY; ++sy)
+    {
+        for (int sx = 0; sx < sectorsX; ++sx)
+        {
+            if (sx + 1 < sectorsX)
+                scanBorderRight(sx, sy);
+            if (sy + 1 < sectorsY)
+                scanBorderBelow(sx, sy);
+        }
+    }
+
+    // Link the portals inside each region with their walking distance
+    for (int sy = 0; sy < sectorsY; ++sy)
+    {
+        for (int sx = 0; sx < sectorsX; ++sx)
+            relinkSector(sx, sy);
+    }
+
+    labelComponents();
+    deadNodes = 0;
+    deadRegions = 0;
+
+    int nodes = nodeTile.size();
+    cost.assign(nodes + 1, 0);
+    parent.assign(nodes + 1, -1);
+    visited.assign(nodes + 1, 0);
+    queryStamp = 0;
+    clearCache();
+}
+
+/**
+ * Brings the graph up to date after a tile became walkable or blocked
+ * Only the tile's sector is labelled again, along with the portals on its
+ * borders and the links inside its neighbours. Routes and trees are forgotten.
+ *
+ * @param tile Tile index of the tile that changed in the grid
+ */
+void HierarchicalPathfinder::updateTile(int tile)
+{
+    if (grid == NULL || tile < 0 || tile >= static_cast<int>(tileRegion.size()))
+        return;
+
+    int sector = sectorOf(tile);
+    int sx = sector % sectorsX;
+    int sy = sector / sectorsX;
+    bool opened = grid->isWalkable(tile / columns, tile % columns);
+    std::vector<int> partners;
+
+    // Every portal of the sector goes, along with those across its borders that only served it
+    for (int r = sectorFirstRegion[sector]; r < sectorFirstRegion[sector] + sectorRegionCount[sector]; ++r)
+    {
+        std::vector<int> nodes = regions[r].nodes;
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            for (size_t e = 0; e < edges[nodes[i]].size(); ++e)
+            {
+                if (sectorOf(nodeTile[edges[nodes[i]][e].to]) != sector)
+                    partners.push_back(edges[nodes[i]][e].to);
+            }
+            dropNode(nodes[i]);
+        }
+    }
+    for (size_t i = 0; i < partners.size(); ++i)
+    {
+        if (nodeRegion[partners[i]] >= 0 && !hasCrossing(partners[i]))
+            dropNode(partners[i]);
+    }
+
+    // The sector's old regions are left unused, new ones go on the end
+    deadRegions += sectorRegionCount[sector];
+    sectorFirstRegion[sector] = regions.size();
+    labelSector(sx, sy);
+    sectorRegionCount[sector] = regions.size() - sectorFirstRegion[sector];
+
+    if (sx > 0)
+        scanBorderRight(sx - 1, sy);
+    if (sx + 1 < sectorsX)
+        scanBorderRight(sx, sy);
+    if (sy > 0)
+        scanBorderBelow(sx, sy - 1);
+    if (sy + 1 < sectorsY)
+        scanBorderBelow(sx, sy);
+
+    relinkSector(sx, sy);
+    if (sx > 0)
+        relinkSector(sx - 1, sy);
+    if (sx + 1 < sectorsX)
+        relinkSector(sx + 1, sy);
+    if (sy > 0)
+        relinkSector(sx, sy - 1);
+    if (sy + 1 < sectorsY)
+        relinkSector(sx, sy + 1);
+
+    // Once more than half the graph is left over from updates, building it again is cheaper to keep
+    if (deadNodes > static_cast<int>(nodeTile.size()) / 2 || deadRegions > static_cast<int>(regions.size()) / 2)
+    {
+        build(*grid);
+        return;
+    }
+
+    // Opening a tile can only join areas, closing one may split them and needs a full pass
+    if (opened)
+        joinComponents(sector);
+    else
+        labelComponents();
+    int nodes = nodeTile.size();
+    cost.resize(nodes + 1, 0);
+    parent.resize(nodes + 1, -1);
+    visited.resize(nodes + 1, 0);
+    clearCache();
+}
+
+/**
+ * Finds a route as a list of portal tiles ending at the goal
+ * Walking straight between consecutive waypoints is not always possible, use refine or findTilePath for that
+ *
+ * @param startTile Tile to start from
+ * @param goalTile Tile to reach
+ * @param waypoints Filled with the waypoints, not including the start
+ * @returns False if the goal cannot be reached
+ */
+bool HierarchicalPathfinder::findPath(int startTile, int goalTile, std::vector<int> &waypoints)
+{
+    waypoints.clear();
+    if (!isReachable(startTile, goalTile))
+        return false;
+
+    int startRegion = regionOf(startTile);
+    int goalRegion = regionOf(goalTile);
+
+    if (startRegion != goalRegion)
+    {
+        GoalTree *tree = findTree(goalRegion);
+        if (tree == NULL && ++goalQueries[goalRegion] >= HPA_TREE_AFTER)
+            tree = buildTree(goalRegion, goalTile);
+
+        if (tree != NULL)
+        {
+            ++cacheHits;
+            if (!readTree(tree, startTile, waypoints))
+                return false;
+            waypoints.push_back(goalTile);
+            return true;
+        }
+
+        uint64_t key = (static_cast<uint64_t>(startRegion) << 32) | static_cast<uint32_t>(goalRegion);
+        std::unordered_map<uint64_t, std::vector<int> >::iterator cached = routeCache.find(key);
+
+        if (cached != routeCache.end())
+        {
+            ++cacheHits;
+            waypoints = cached->second;
+        }
+        else
+        {
+            ++cacheMisses;
+            if (!search(startTile, goalTile, waypoints))
+                return false;
+
+            if (routeCache.size() >= HPA_CACHE_SIZE)
+                routeCache.clear();
+            routeCache[key] = waypoints;
+        }
+    }
+
+    waypoints.push_back(goalTile);
+    return true;
+}
+
+/**
+ * Finds a route as a list of neighbouring tiles ending at the goal
+ *
+ * @param startTile Tile to start from
+ * @param goalTile Tile to reach
+ * @param tiles Filled with every tile to walk through, not including the start
+ * @returns False if the goal cannot be reached
+ */
+bool HierarchicalPathfinder::findTilePath(int startTile, int goalTile, std::vector<int> &tiles)
+{
+    std::vector<int> waypoints;
+
+    tiles.clear();
+    if (!findPath(startTile, goalTile, waypoints))
+        return false;
+
+    int from = startTile;
+    for (size_t i = 0; i < waypoints.size(); ++i)
+    {
+        if (!refine(from, waypoints[i], tiles))
+            return false;
+        from = waypoints[i];
+    }
+    return true;
+}
+
+/**
+ * Indicates whether one tile can be reached from another, in O(1)
+ *
+ * @param startTile Tile to start from
+ * @param goalTile Tile to reach
+ * @returns True if a path exists
+ */
+bool HierarchicalPathfinder::isReachable(int startTile, int goalTile)
+{
+    int startRegion = regionOf(startTile);
+    int goalRegion = regionOf(goalTile);
+
+    if (startRegion < 0 || goalRegion < 0)
+        return false;
+    return regions[startRegion].component == regions[goalRegion].component;
+}
+
+/**
+ * Picks a reachable tile far away from a threat by sampling portal tiles
+ *
+ * @param fromTile Tile the fleeing agent stands on
+ * @param threatTile Tile of whatever is being fled from
+ * @param samples Number of candidate tiles to look at
+ * @param seed Picks which tiles are sampled, the same seed samples the same tiles
+ * @returns A tile farther from the threat than the agent is, or -1 if none was found
+ */
+int HierarchicalPathfinder::findFleeTarget(int fromTile, int threatTile, int samples, uint32_t seed)
+{
+    int fromRegion = regionOf(fromTile);
+    int nodes = nodeTile.size();
+
+    if (fromRegion < 0 || nodes == 0)
+        return -1;
+
+    int component = regions[fromRegion].component;
+    int best = -1;
+    int bestDist = distanceEstimate(fromTile, threatTile);
+
+    // Small LCG, the caller's seed keeps the sampling repeatable per simulation
+    uint32_t state = seed;
+    for (int i = 0; i < samples; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        int n = (state >> 8) % nodes;
+        if (nodeRegion[n] < 0 || regions[nodeRegion[n]].component != component)
+            continue;
+
+        int dist = distanceEstimate(nodeTile[n], threatTile);
+        if (dist > bestDist)
+        {
+            bestDist = dist;
+            best = nodeTile[n];
+        }
+    }
+    return best;
+}
+
+/**
+ * Forgets all cached routes and goal trees
+ */
+void HierarchicalPathfinder::clearCache(void)
+{
+    routeCache.clear();
+    goalQueries.clear();
+    trees.clear();
+}
+
+/**
+ * Getter for the number of portal nodes
+ *
+ * @returns Nodes in the abstract graph
+ */
+int HierarchicalPathfinder::getNodeCount(void)
+{
+    return nodeTile.size();
+}
+
+/**
+ * Getter for the number of sector regions
+ *
+ * @returns Regions across all sectors
+ */
+int HierarchicalPathfinder::getRegionCount(void)
+{
+    return regions.size();
+}
+
+/**
+ * Getter for the number of queries answered from the cache
+ *
+ * @returns Cache hits since the last build
+ */
+long HierarchicalPathfinder::getCacheHits(void)
+{
+    return cacheHits;
+}
+
+/**
+ * Getter for the number of queries that needed a search
+ *
+ * @returns Cache misses since the last build
+ */
+long HierarchicalPathfinder::getCacheMisses(void)
+{
+    return cacheMisses;
+}
+
+/**
+ * Sector a tile belongs to
+ *
+ * @param tile Tile index
+ * @returns Sector index
+ */
+int HierarchicalPathfinder::sectorOf(int tile)
+{
+    int row = tile / columns;
+    int col = tile % columns;
+    return (row / HPA_SECTOR_SIZE) * sectorsX + col / HPA_SECTOR_SIZE;
+}
+
+/**
+ * Region a tile belongs to
+ *
+ * @param tile Tile index
+ * @returns Region index, or -1 if the tile is blocked or outside the grid
+ */
+int HierarchicalPathfinder::regionOf(int tile)
+{
+    if (grid == NULL || tile < 0 || tile >= static_cast<int>(tileRegion.size()))
+        return -1;
+    if (tileRegion[tile] == HPA_NO_REGION)
+        return -1;
+    return sectorFirstRegion[sectorOf(tile)] + tileRegion[tile];
+}
+
+/**
+ * Lower bound on the steps between two tiles (diagonal steps cost the same as straight ones)
+ *
+ * @param tileA First tile
+ * @param tileB Second tile
+ * @returns Chebyshev distance in tiles
+ */
+int HierarchicalPathfinder::distanceEstimate(int tileA, int tileB)
+{
+    int dRow = abs(tileA / columns - tileB / columns);
+    int dCol = abs(tileA % columns - tileB % columns);
+    return std::max(dRow, dCol);
+}
+
+/**
+ * Indicates whether a single step is allowed
+ * Diagonal steps need both orthogonal tiles open so agents don't squeeze between walls
+ *
+ * @param row Row stepping from
+ * @param col Column stepping from
+ * @param dRow Row offset
+ * @param dCol Column offset
+ * @returns True if the step is allowed
+ */
+bool HierarchicalPathfinder::canStep(int row, int col, int dRow, int dCol)
+{
+    if (!isOpen(row + dRow, col + dCol))
+        return false;
+    if (dRow != 0 && dCol != 0)
+        return isOpen(row + dRow, col) && isOpen(row, col + dCol);
+    return true;
+}
+
+/**
+ * Indicates whether a tile can be walked on, from its region rather than
+ * the grid so searches never go back to the map
+ *
+ * @param row Row of the tile
+ * @param col Column of the tile
+ * @returns False if the tile is blocked, outside the grid, or in a sector not labelled yet
+ */
+bool HierarchicalPathfinder::isOpen(int row, int col)
+{
+    return row >= 0 && col >= 0 && row < rows && col < columns && tileRegion[row * columns + col] != HPA_NO_REGION;
+}
+
+/**
+ * Flood fills a sector into regions of tiles that can reach each other without leaving it
+ *
+ * @param sectorX Sector column
+ * @param sectorY Sector row
+ */
+void HierarchicalPathfinder::labelSector(int sectorX, int sectorY)
+{
+    int top = sectorY * HPA_SECTOR_SIZE;
+    int left = sectorX * HPA_SECTOR_SIZE;
+    int bottom = std::min(top + HPA_SECTOR_SIZE, rows);
+    int right = std::min(left + HPA_SECTOR_SIZE, columns);
+    int local = 0;
+
+    // The grid is read once per tile here, everything after goes by the regions
+    for (int row = top; row < bottom; ++row)
+    {
+        for (int col = left; col < right; ++col)
+            tileRegion[row * columns + col] = grid->isWalkable(row, col) ? HPA_UNLABELLED : HPA_NO_REGION;
+    }
+
+    for (int row = top; row < bottom; ++row)
+    {
+        for (int col = left; col < right; ++col)
+        {
+            int tile = row * columns + col;
+            if (tileRegion[tile] != HPA_UNLABELLED)
+                continue;
+
+            Region region;
+            region.component = regions.size();
+            regions.push_back(region);
+
+            size_t head = 0;
+            size_t tail = 0;
+            tileRegion[tile] = local;
+            localQueue[tail++] = tile;
+
+            while (head < tail)
+            {
+                int current = localQueue[head++];
+                int cRow = current / columns;
+                int cCol = current % columns;
+
+                for (int n = 0; n < 8; ++n)
+                {
+                    int nRow = cRow + STEP_ROW[n];
+                    int nCol = cCol + STEP_COL[n];
+                    if (nRow < top || nRow >= bottom || nCol < left || nCol >= right)
+                        continue;
+                    if (!canStep(cRow, cCol, STEP_ROW[n], STEP_COL[n]))
+                        continue;
+
+                    int next = nRow * columns + nCol;
+                    if (tileRegion[next] != HPA_UNLABELLED)
+                        continue;
+                    tileRegion[next] = local;
+                    localQueue[tail++] = next;
+                }
+            }
+            ++local;
+        }
+    }
+}
+
+/**
+ * Adds a pair of portal nodes on either side of a sector border
+ *
+ * @param tileA Tile on one side of the border
+ * @param tileB Neighbouring tile on the other side
+ */
+void HierarchicalPathfinder::addEntrance(int tileA, int tileB)
+{
+    int a = nodeAt(tileA);
+    int b = nodeAt(tileB);
+    Edge ab = { b, 1 };
+    Edge ba = { a, 1 };
+
+    edges[a].push_back(ab);
+    edges[b].push_back(ba);
+}
+
+/**
+ * Finds the portal node on a tile, creating it if needed
+ *
+ * @param tile Tile index
+ * @returns Node index
+ */
+int HierarchicalPathfinder::nodeAt(int tile)
+{
+    std::unordered_map<int, int>::iterator found = tileNode.find(tile);
+    if (found != tileNode.end())
+        return found->second;
+
+    int node = nodeTile.size();
+    int region = regionOf(tile);
+
+    nodeTile.push_back(tile);
+    nodeRegion.push_back(region);
+    edges.push_back(std::vector<Edge>());
+    regions[region].nodes.push_back(node);
+    tileNode[tile] = node;
+    return node;
+}
+
+/**
+ * Links every pair of portals in a region with the steps between them
+ *
+ * @param region Region index
+ * @param sectorX Sector column the region is in
+ * @param sectorY Sector row the region is in
+ */
+void HierarchicalPathfinder::linkRegion(int region, int sectorX, int sectorY)
+{
+    std::vector<int> &nodes = regions[region].nodes;
+    int top = sectorY * HPA_SECTOR_SIZE;
+    int left = sectorX * HPA_SECTOR_SIZE;
+    int bottom = std::min(top + HPA_SECTOR_SIZE, rows);
+    int right = std::min(left + HPA_SECTOR_SIZE, columns);
+
+    if (nodes.size() < 2)
+        return;
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        // Breadth-first search from this portal, staying inside the sector
+        std::fill(localDist.begin(), localDist.end(), -1);
+        int startTile = nodeTile[nodes[i]];
+        size_t head = 0;
+        size_t tail = 0;
+
+        localDist[(startTile / columns - top) * HPA_SECTOR_SIZE + startTile % columns - left] = 0;
+        localQueue[tail++] = startTile;
+
+        while (head < tail)
+        {
+            int current = localQueue[head++];
+            int cRow = current / columns;
+            int cCol = current % columns;
+            int cDist = localDist[(cRow - top) * HPA_SECTOR_SIZE + cCol - left];
+
+            for (int n = 0; n < 8; ++n)
+            {
+                int nRow = cRow + STEP_ROW[n];
+                int nCol = cCol + STEP_COL[n];
+                if (nRow < top || nRow >= bottom || nCol < left || nCol >= right)
+                    continue;
+                if (!canStep(cRow, cCol, STEP_ROW[n], STEP_COL[n]))
+                    continue;
+
+                int local = (nRow - top) * HPA_SECTOR_SIZE + nCol - left;
+                if (localDist[local] >= 0)
+                    continue;
+                localDist[local] = cDist + 1;
+                localQueue[tail++] = nRow * columns + nCol;
+            }
+        }
+
+        for (size_t j = 0; j < nodes.size(); ++j)
+        {
+            if (i == j)
+                continue;
+            int tile = nodeTile[nodes[j]];
+            int dist = localDist[(tile / columns - top) * HPA_SECTOR_SIZE + tile % columns - left];
+            if (dist > 0)
+            {
+                Edge e = { nodes[j], dist };
+                edges[nodes[i]].push_back(e);
+            }
+        }
+    }
+}
+
+/**
+ * Removes the links between portals inside a region, keeping those across sector borders
+ *
+ * @param region Region index
+ */
+void HierarchicalPathfinder::unlinkRegion(int region)
+{
+    std::vector<int> &nodes = regions[region].nodes;
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        std::vector<Edge> &out = edges[nodes[i]];
+        int sector = sectorOf(nodeTile[nodes[i]]);
+        size_t kept = 0;
+        for (size_t e = 0; e < out.size(); ++e)
+        {
+            if (sectorOf(nodeTile[out[e].to]) != sector)
+                out[kept++] = out[e];
+        }
+        out.resize(kept);
+    }
+}
+
+/**
+ * Links the portals of every region in a sector again
+ *
+ * @param sectorX Sector column
+ * @param sectorY Sector row
+ */
+void HierarchicalPathfinder::relinkSector(int sectorX, int sectorY)
+{
+    int sector = sectorY * sectorsX + sectorX;
+
+    for (int r = sectorFirstRegion[sector]; r < sectorFirstRegion[sector] + sectorRegionCount[sector]; ++r)
+    {
+        unlinkRegion(r);
+        linkRegion(r, sectorX, sectorY);
+    }
+}
+
+/**
+ * Adds portals for the openings along the border between a sector and the one to its right
+ *
+ * @param sectorX Sector column, not the last
+ * @param sectorY Sector row
+ */
+void HierarchicalPathfinder::scanBorderRight(int sectorX, int sectorY)
+{
+    int top = sectorY * HPA_SECTOR_SIZE;
+    int bottom = std::min(top + HPA_SECTOR_SIZE, rows);
+    int col = std::min((sectorX + 1) * HPA_SECTOR_SIZE, columns) - 1;
+    int runStart = -1;
+
+    for (int row = top; row <= bottom; ++row)
+    {
+        bool open = row < bottom && isOpen(row, col) && isOpen(row, col + 1);
+        if (open && runStart < 0)
+            runStart = row;
+        else if (!open && runStart >= 0)
+        {
+            int runEnd = row - 1;
+            if (runEnd - runStart + 1 >= HPA_WIDE_ENTRANCE)
+            {
+                addEntrance(runStart * columns + col, runStart * columns + col + 1);
+                addEntrance(runEnd * columns + col, runEnd * columns + col + 1);
+            }
+            else
+            {
+                int mid = (runStart + runEnd) / 2;
+                addEntrance(mid * columns + col, mid * columns + col + 1);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+/**
+ * Adds portals for the openings along the border between a sector and the one below it
+ *
+ * @param sectorX Sector column
+ * @param sectorY Sector row, not the last
+ */
+void HierarchicalPathfinder::scanBorderBelow(int sectorX, int sectorY)
+{
+    int left = sectorX * HPA_SECTOR_SIZE;
+    int right = std::min(left + HPA_SECTOR_SIZE, columns);
+    int row = std::min((sectorY + 1) * HPA_SECTOR_SIZE, rows) - 1;
+    int runStart = -1;
+
+    for (int col = left; col <= right; ++col)
+    {
+        bool open = col < right && isOpen(row, col) && isOpen(row + 1, col);
+        if (open && runStart < 0)
+            runStart = col;
+        else if (!open && runStart >= 0)
+        {
+            int runEnd = col - 1;
+            if (runEnd - runStart + 1 >= HPA_WIDE_ENTRANCE)
+            {
+                addEntrance(row * columns + runStart, (row + 1) * columns + runStart);
+                addEntrance(row * columns + runEnd, (row + 1) * columns + runEnd);
+            }
+            else
+            {
+                int mid = (runStart + runEnd) / 2;
+                addEntrance(row * columns + mid, (row + 1) * columns + mid);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+/**
+ * Takes a portal out of the graph, its index is left unused
+ *
+ * @param node Node index
+ */
+void HierarchicalPathfinder::dropNode(int node)
+{
+    for (size_t e = 0; e < edges[node].size(); ++e)
+    {
+        std::vector<Edge> &back = edges[edges[node][e].to];
+        for (size_t b = 0; b < back.size(); ++b)
+        {
+            if (back[b].to == node)
+            {
+                back[b] = back.back();
+                back.pop_back();
+                break;
+            }
+        }
+    }
+    edges[node].clear();
+
+    std::vector<int> &inRegion = regions[nodeRegion[node]].nodes;
+    inRegion.erase(std::find(inRegion.begin(), inRegion.end(), node));
+    tileNode.erase(nodeTile[node]);
+    nodeRegion[node] = -1;
+    ++deadNodes;
+}
+
+/**
+ * Indicates whether a portal still leads into another sector
+ *
+ * @param node Node index
+ * @returns True if any of its links crosses a sector border
+ */
+bool HierarchicalPathfinder::hasCrossing(int node)
+{
+    int sector = sectorOf(nodeTile[node]);
+
+    for (size_t e = 0; e < edges[node].size(); ++e)
+    {
+        if (sectorOf(nodeTile[edges[node][e].to]) != sector)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Groups regions that can reach each other so reachability checks are O(1)
+ */
+void HierarchicalPathfinder::labelComponents(void)
+{
+    // Union-find over regions, joined by portal edges
+    std::vector<int> root(regions.size());
+    for (size_t r = 0; r < regions.size(); ++r)
+        root[r] = r;
+
+    auto find = [&root](int r) {
+        while (root[r] != r)
+        {
+            root[r] = root[root[r]];
+            r = root[r];
+        }
+        return r;
+    };
+
+    for (size_t n = 0; n < edges.size(); ++n)
+    {
+        for (size_t e = 0; e < edges[n].size(); ++e)
+        {
+            int a = find(nodeRegion[n]);
+            int b = find(nodeRegion[edges[n][e].to]);
+            if (a != b)
+                root[a] = b;
+        }
+    }
+
+    for (size_t r = 0; r < regions.size(); ++r)
+        regions[r].component = find(r);
+}
+
+/**
+ * Gives a relabelled sector's regions the components they connect to, merging
+ * components the sector now joins
+ * Only valid when every route across the sector before the update still exists,
+ * that is when tiles were made walkable
+ *
+ * @param sector Sector whose regions were just relabelled and linked
+ */
+void HierarchicalPathfinder::joinComponents(int sector)
+{
+    int first = sectorFirstRegion[sector];
+    int last = first + sectorRegionCount[sector];
+
+    for (int r = first; r < last; ++r)
+    {
+        int component = r;
+
+        regions[r].component = r;
+        for (size_t i = 0; i < regions[r].nodes.size(); ++i)
+        {
+            int node = regions[r].nodes[i];
+            for (size_t e = 0; e < edges[node].size(); ++e)
+            {
+                int other = regions[nodeRegion[edges[node][e].to]].component;
+                if (other == component)
+                    continue;
+
+                // The first component found is joined, any other meeting it has to be relabelled
+                if (component == r)
+                {
+                    component = other;
+                    regions[r].component = component;
+                    continue;
+                }
+                for (size_t o = 0; o < regions.size(); ++o)
+                {
+                    if (regions[o].component == other)
+                        regions[o].component = component;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * A* over the portal graph
+ * The start tile connects to every portal in its region, and every portal in the
+ * goal's region connects to the goal, both using the distance estimate as cost
+ *
+ * @param startTile Tile to start from
+ * @param goalTile Tile to reach
+ * @param route Filled with the portal tiles to walk through
+ * @returns False if no route was found
+ */
+bool HierarchicalPathfinder::search(int startTile, int goalTile, std::vector<int> &route)
+{
+    int goalNode = nodeTile.size(); // Virtual node standing in for the goal tile
+    int goalRegion = regionOf(goalTile);
+    std::vector<int> &startNodes = regions[regionOf(startTile)].nodes;
+    std::greater<std::pair<int, int> > later;
+
+    ++queryStamp;
+    open.clear();
+
+    for (size_t i = 0; i < startNodes.size(); ++i)
+    {
+        int n = startNodes[i];
+        visited[n] = queryStamp;
+        cost[n] = distanceEstimate(startTile, nodeTile[n]);
+        parent[n] = -1;
+        open.push_back(std::make_pair(cost[n] + distanceEstimate(nodeTile[n], goalTile), n));
+    }
+    std::make_heap(open.begin(), open.end(), later);
+
+    while (!open.empty())
+    {
+        std::pop_heap(open.begin(), open.end(), later);
+        std::pair<int, int> top = open.back();
+        open.pop_back();
+        int n = top.second;
+
+        if (n == goalNode)
+        {
+            // Walk the parents back to the start
+            route.clear();
+            for (int p = parent[goalNode]; p >= 0; p = parent[p])
+                route.push_back(nodeTile[p]);
+            std::reverse(route.begin(), route.end());
+            return true;
+        }
+
+        // Skip stale heap entries
+        if (top.first > cost[n] + distanceEstimate(nodeTile[n], goalTile))
+            continue;
+
+        if (nodeRegion[n] == goalRegion)
+        {
+            int total = cost[n] + distanceEstimate(nodeTile[n], goalTile);
+            if (visited[goalNode] != queryStamp || total < cost[goalNode])
+            {
+                visited[goalNode] = queryStamp;
+                cost[goalNode] = total;
+                parent[goalNode] = n;
+                open.push_back(std::make_pair(total, goalNode));
+                std::push_heap(open.begin(), open.end(), later);
+            }
+        }
+
+        for (size_t e = 0; e < edges[n].size(); ++e)
+        {
+            int next = edges[n][e].to;
+            int total = cost[n] + edges[n][e].cost;
+            if (visited[next] == queryStamp && total >= cost[next])
+                continue;
+
+            visited[next] = queryStamp;
+            cost[next] = total;
+            parent[next] = n;
+            open.push_back(std::make_pair(total + distanceEstimate(nodeTile[next], goalTile), next));
+            std::push_heap(open.begin(), open.end(), later);
+        }
+    }
+    return false;
+}
+
+/**
+ * Expands one leg of a route into single tile steps
+ * Legs either stay inside one sector or cross a border between two neighbouring tiles
+ *
+ * @param fromTile Tile the leg starts on
+ * @param toTile Tile the leg ends on
+ * @param tiles Tiles are appended here, not including the starting tile
+ * @returns False if the leg could not be walked
+ */
+bool HierarchicalPathfinder::refine(int fromTile, int toTile, std::vector<int> &tiles)
+{
+    if (fromTile == toTile)
+        return true;
+
+    int sector = sectorOf(fromTile);
+    int top = (sector / sectorsX) * HPA_SECTOR_SIZE;
+    int left = (sector % sectorsX) * HPA_SECTOR_SIZE;
+    int bottom = std::min(top + HPA_SECTOR_SIZE, rows);
+    int right = std::min(left + HPA_SECTOR_SIZE, columns);
+    int toRow = toTile / columns;
+    int toCol = toTile % columns;
+
+    std::fill(localDist.begin(), localDist.end(), -1);
+    size_t head = 0;
+    size_t tail = 0;
+    int startLocal = (fromTile / columns - top) * HPA_SECTOR_SIZE + fromTile % columns - left;
+    localDist[startLocal] = 0;
+    localParent[startLocal] = -1;
+    localQueue[tail++] = fromTile;
+
+    while (head < tail)
+    {
+        int current = localQueue[head++];
+        int cRow = current / columns;
+        int cCol = current % columns;
+        int cLocal = (cRow - top) * HPA_SECTOR_SIZE + cCol - left;
+
+        for (int n = 0; n < 8; ++n)
+        {
+            int nRow = cRow + STEP_ROW[n];
+            int nCol = cCol + STEP_COL[n];
+            if (!canStep(cRow, cCol, STEP_ROW[n], STEP_COL[n]))
+                continue;
+
+            if (nRow == toRow && nCol == toCol)
+            {
+                // Walk the parents back to the start, then append in order
+                size_t first = tiles.size();
+                tiles.push_back(toTile);
+                for (int l = cLocal; l != startLocal; l = localParent[l])
+                    tiles.push_back((top + l / HPA_SECTOR_SIZE) * columns + left + l % HPA_SECTOR_SIZE);
+                std::reverse(tiles.begin() + first, tiles.end());
+                return true;
+            }
+
+            if (nRow < top || nRow >= bottom || nCol < left || nCol >= right)
+                continue;
+            int local = (nRow - top) * HPA_SECTOR_SIZE + nCol - left;
+            if (localDist[local] >= 0)
+                continue;
+            localDist[local] = localDist[cLocal] + 1;
+            localParent[local] = cLocal;
+            localQueue[tail++] = nRow * columns + nCol;
+        }
+    }
+    return false;
+}
+
+/**
+ * Looks up the shortest-path tree toward a goal region
+ *
+ * @param goalRegion Region index
+ * @returns The tree, or NULL if there is none
+ */
+HierarchicalPathfinder::GoalTree *HierarchicalPathfinder::findTree(int goalRegion)
+{
+    for (size_t i = 0; i < trees.size(); ++i)
+    {
+        if (trees[i].region == goalRegion)
+        {
+            trees[i].lastUse = ++queryStamp;
+            return &trees[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Runs Dijkstra outward from a goal region over the whole portal graph
+ * Replaces the least recently used tree once HPA_MAX_TREES are held
+ *
+ * @param goalRegion Region index
+ * @param goalTile Tile inside the region that seeds the distances
+ * @returns The new tree
+ */
+HierarchicalPathfinder::GoalTree *HierarchicalPathfinder::buildTree(int goalRegion, int goalTile)
+{
+    GoalTree *tree = NULL;
+
+    if (trees.size() < HPA_MAX_TREES)
+    {
+        trees.push_back(GoalTree());
+        tree = &trees.back();
+    }
+    else
+    {
+        tree = &trees[0];
+        for (size_t i = 1; i < trees.size(); ++i)
+        {
+            if (trees[i].lastUse < tree->lastUse)
+                tree = &trees[i];
+        }
+    }
+
+    std::greater<std::pair<int, int> > later;
+    std::vector<int> &goalNodes = regions[goalRegion].nodes;
+    int unreached = 0x7fffffff;
+
+    goalQueries.erase(goalRegion);
+    tree->region = goalRegion;
+    tree->lastUse = ++queryStamp;
+    tree->dist.assign(nodeTile.size(), unreached);
+    tree->next.assign(nodeTile.size(), -1);
+    open.clear();
+
+    for (size_t i = 0; i < goalNodes.size(); ++i)
+    {
+        int n = goalNodes[i];
+        tree->dist[n] = distanceEstimate(nodeTile[n], goalTile);
+        open.push_back(std::make_pair(tree->dist[n], n));
+    }
+    std::make_heap(open.begin(), open.end(), later);
+
+    while (!open.empty())
+    {
+        std::pop_heap(open.begin(), open.end(), later);
+        std::pair<int, int> top = open.back();
+        open.pop_back();
+        int n = top.second;
+
+        if (top.first > tree->dist[n])
+            continue;
+
+        // Portal edges go both ways, so walking them outward gives distances toward the goal
+        for (size_t e = 0; e < edges[n].size(); ++e)
+        {
+            int prev = edges[n][e].to;
+            int total = tree->dist[n] + edges[n][e].cost;
+            if (total >= tree->dist[prev])
+                continue;
+
+            tree->dist[prev] = total;
+            tree->next[prev] = n;
+            open.push_back(std::make_pair(total, prev));
+            std::push_heap(open.begin(), open.end(), later);
+        }
+    }
+    return tree;
+}
+
+/**
+ * Reads a route out of a goal tree
+ *
+ * @param tree Tree toward the goal region
+ * @param startTile Tile to start from
+ * @param route Filled with the portal tiles to walk through
+ * @returns False if the start cannot reach the tree's goal
+ */
+bool HierarchicalPathfinder::readTree(GoalTree *tree, int startTile, std::vector<int> &route)
+{
+    std::vector<int> &startNodes = regions[regionOf(startTile)].nodes;
+    int best = -1;
+    int bestCost = 0x7fffffff;
+
+    // Best portal to leave the start region through
+    for (size_t i = 0; i < startNodes.size(); ++i)
+    {
+        int n = startNodes[i];
+        if (tree->dist[n] == 0x7fffffff)
+            continue;
+
+        int total = distanceEstimate(startTile, nodeTile[n]) + tree->dist[n];
+        if (total < bestCost)
+        {
+            bestCost = total;
+            best = n;
+        }
+    }
+
+    route.clear();
+    for (int n = best; n >= 0; n = tree->next[n])
+        route.push_back(nodeTile[n]);
+    return best >= 0;
+}
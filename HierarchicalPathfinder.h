@@ -0,0 +1,151 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _HIERARCHICALPATHFINDER_
+#define _HIERARCHICALPATHFINDER_
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+#include "WalkGrid.h"
+
+// Width and height of a sector in tiles
+#define HPA_SECTOR_SIZE 16
+
+// Most routes kept in the cache before it is flushed
+#define HPA_CACHE_SIZE 4096
+
+// Routes toward a goal region that has been asked for this many times come from a shared tree
+#define HPA_TREE_AFTER 8
+
+// Most goal trees kept at once
+#define HPA_MAX_TREES 8
+
+// Openings at least this wide get a portal at each end instead of one in the middle
+#define HPA_WIDE_ENTRANCE 8
+
+// Local region label for blocked tiles
+#define HPA_NO_REGION 255
+
+// Local region label for walkable tiles while their sector is being labelled
+#define HPA_UNLABELLED 254
+
+/**
+ * Hierarchical pathfinder (HPA*) over the tile grid
+ *
+ * The grid is cut into square sectors. Inside each sector, tiles that can
+ * reach each other form a region. Openings between neighbouring sectors
+ * become portal nodes, and portals of the same region are linked with their
+ * walking distance. Searches run over the small portal graph instead of the
+ * raw tiles, and the resulting routes are cached per (start region, goal
+ * region) pair so agents standing in the same region share one search.
+ * Popular goals (like the player) get a shortest-path tree over the whole
+ * portal graph, after which any agent's route is read off in O(route length).
+ *
+ * When tiles change, updateTile redoes only the sector they are in and the
+ * portals along its borders, leaving the rest of the graph alone.
+ *
+ * The region of every tile is kept, a byte each, so unlike the streamed
+ * tiles the pathfinder's memory grows with the map.
+ *
+ * Tiles are addressed by index: row * columns + column
+ */
+class HierarchicalPathfinder
+{
+public:
+    HierarchicalPathfinder(void);
+
+    void build(WalkSource &walkSource);
+    void updateTile(int tile);
+    bool findPath(int startTile, int goalTile, std::vector<int> &waypoints);
+    bool findTilePath(int startTile, int goalTile, std::vector<int> &tiles);
+    bool isReachable(int startTile, int goalTile);
+    int findFleeTarget(int fromTile, int threatTile, int samples, uint32_t seed);
+    void clearCache(void);
+
+    int getNodeCount(void);
+    int getRegionCount(void);
+    long getCacheHits(void);
+    long getCacheMisses(void);
+
+private:
+    struct Edge
+    {
+        int to;
+        int cost;
+    };
+
+    struct GoalTree
+    {
+        int region;            // Goal region the tree leads to
+        int lastUse;           // Query stamp of the last use, for eviction
+        std::vector<int> dist; // Steps from each node to the goal
+        std::vector<int> next; // Next node toward the goal, -1 at the goal region
+    };
+
+    struct Region
+    {
+        int component;          // Regions that can reach each other share a component
+        std::vector<int> nodes; // Portal nodes inside this region
+    };
+
+    int sectorOf(int tile);
+    int regionOf(int tile);
+    int distanceEstimate(int tileA, int tileB);
+    void labelSector(int sectorX, int sectorY);
+    void addEntrance(int tileA, int tileB);
+    int nodeAt(int tile);
+    void linkRegion(int region, int sectorX, int sectorY);
+    void unlinkRegion(int region);
+    void scanBorderRight(int sectorX, int sectorY);
+    void scanBorderBelow(int sectorX, int sectorY);
+    void dropNode(int node);
+    bool hasCrossing(int node);
+    void relinkSector(int sectorX, int sectorY);
+    void labelComponents(void);
+    void joinComponents(int sector);
+    bool search(int startTile, int goalTile, std::vector<int> &route);
+    GoalTree *findTree(int goalRegion);
+    GoalTree *buildTree(int goalRegion, int goalTile);
+    bool readTree(GoalTree *tree, int startTile, std::vector<int> &route);
+    bool refine(int fromTile, int toTile, std::vector<int> &tiles);
+    bool canStep(int row, int col, int dRow, int dCol);
+    bool isOpen(int row, int col);
+
+    WalkSource *grid;
+    int rows;
+    int columns;
+    int sectorsX;
+    int sectorsY;
+
+    std::vector<unsigned char> tileRegion; // Region of each tile, relative to its sector
+    std::vector<int> sectorFirstRegion;    // First region of each sector
+    std::vector<int> sectorRegionCount;    // Regions in each sector, numbered on from the first
+    std::vector<Region> regions;
+    std::vector<int> nodeTile;    // Tile each portal node sits on
+    std::vector<int> nodeRegion;  // Region each portal node belongs to
+    std::vector<std::vector<Edge> > edges;
+    std::unordered_map<int, int> tileNode; // Portal node on a tile, if any
+    int deadNodes;   // Nodes and regions left behind by updateTile, until the next build
+    int deadRegions;
+
+    // Search scratch space, reused between queries
+    std::vector<int> cost;
+    std::vector<int> parent;
+    std::vector<int> visited; // Query stamp of the last query to touch a node
+    std::vector<std::pair<int, int> > open;
+    std::vector<int> localDist;
+    std::vector<int> localParent;
+    std::vector<int> localQueue;
+    int queryStamp;
+
+    std::unordered_map<uint64_t, std::vector<int> > routeCache;
+    std::unordered_map<int, int> goalQueries; // Searches per goal region without a tree
+    std::vector<GoalTree> trees;
+    long cacheHits;
+    long cacheMisses;
+};
+#endif
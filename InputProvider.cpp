@@ -0,0 +1,27 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "InputProvider.h"
+#include <SDL2/SDL.h>
+
+/**
+ * Interprets the keyboard state
+ *
+ * @param dispMan Unused, the keyboard doesn't look at the game
+ * @returns Directions of the arrow keys held, and whether space is held
+ */
+PlayerInput KeyboardInput::read(DisplayManager *dispMan)
+{
+    const Uint8 *keystate = SDL_GetKeyboardState(NULL);
+    PlayerInput input;
+
+    input.move.left = (keystate[SDL_SCANCODE_LEFT] != 0);
+    input.move.up = (keystate[SDL_SCANCODE_UP] != 0);
+    input.move.right = (keystate[SDL_SCANCODE_RIGHT] != 0);
+    input.move.down = (keystate[SDL_SCANCODE_DOWN] != 0);
+    input.fire = (keystate[SDL_SCANCODE_SPACE] != 0);
+    return input;
+}
@@ -0,0 +1,52 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _INPUTPROVIDER_
+#define _INPUTPROVIDER_
+
+#include "movement.h"
+
+class DisplayManager;
+
+/**
+ * What the player does on one tick
+ */
+struct PlayerInput
+{
+    Movement move; // Directions held
+    bool fire;     // Fire the soulgun
+};
+
+/**
+ * Source of the player's input, read once per frame
+ *
+ * The game loop only sees PlayerInput, so the player can be driven by the
+ * keyboard, a bot, or anything else that can look at the game.
+ */
+class InputProvider
+{
+public:
+    virtual ~InputProvider(void) {}
+
+    /**
+     * Decides the player's input for the coming tick
+     *
+     * @param dispMan Display manager holding the entities, to look at the game
+     * @returns Input to apply
+     */
+    virtual PlayerInput read(DisplayManager *dispMan) = 0;
+};
+
+/**
+ * Input from the keyboard: the arrow keys move and space fires
+ * SDL events must be polled each frame for the keyboard state to be current
+ */
+class KeyboardInput : public InputProvider
+{
+public:
+    PlayerInput read(DisplayManager *dispMan);
+};
+#endif
@@ -96,81 +96,120 @@ SDL_Texture* MapTile::getTileTexture(void)
  */
 Map::~Map(void) 
 {
-	for(int i = 0; i < MAX_TILES; ++i)
-	{
-		gameMap[i].clear();
-	}
-	gameMap.clear();
+	chunks.close();
+	mapFile.close();
 }
 
 /**
- * Constructor that preloads textures and map
+ * Constructor that loads a map, or the first level
+ * Doesn't touch SDL, so it can run while textures are still being loaded
  * 
- * @param txMan Pointer to texture manager
+ * @param txMan Pointer to texture manager, NULL for a map that is never drawn
+ * @param path Map file to load, the first level is loaded instead if it is NULL or can't be used
  */
-Map::Map(TextureManager * txMan) 
+Map::Map(TextureManager * txMan, const char *path) 
 {	
-	mapTextures.resize(3);
+	bundle = (txMan != NULL) ? &txMan->getBundle() : NULL;
+	for (int i = 0; i <= TID_PIT && txMan != NULL; ++i)
+		tileTextures[i] = txMan->acquire(tileToTexture(i));
 
-	// Preloads texture set
-	for(int i = 0; i < 3; ++i)
-	{
-		mapTextures[i] = txMan->getTexture(tileToTexture(i));
-	}
-
-	loadLevel(1);
+	// Only the map asked for is loaded, so starting on a large map doesn't pay for the first level too
+	if (path == NULL || !load(path))
+		loadLevel(1);
 }
 
 /**
  * Retrieve MapTile
  * 
- * @param x x-coord
- * @param y y-coord
+ * @param row Row of the tile
+ * @param col Column of the tile
  * @returns Map Tile object
  */
-MapTile *Map::getTile(int x, int y) {
-	return gameMap[x][y];
+MapTile Map::getTile(int row, int col) {
+	tileID type = getTileType(row, col);
+	return MapTile(col * TILE_WIDTH, row * TILE_HEIGHT, type, getTileTexture(type));
+}
+
+/**
+ * Retrieve the type of a tile
+ * 
+ * @param row Row of the tile
+ * @param col Column of the tile
+ * @returns Tile identifier, TID_PIT off the map
+ */
+tileID Map::getTileType(int row, int col)
+{
+	if (!chunks.inBounds(row, col))
+		return TID_PIT;
+	return paletteTypes[chunks.tileAt(row, col)];
 }
 
 /**
- * Loads a map file and tiles into memory
+ * Loads a level's map
  * 
  * @param level Indicates which map to load
  */
 void Map::loadLevel(int level)
 {	
-	std::ifstream mapFile;
-	int tile_type;
-
-	// Load map file
+	// Load map file, falling back to the text it was converted from
 	switch (level)
 	{
 		case 1:
-			mapFile.open("assets/maps/levelone.txt");
+			if (!load("assets/maps/levelone.map"))
+				load("assets/maps/levelone.txt");
 			break;
  	}
-	gameMap.resize(MAX_TILES);
+}
 
-	// Load map tile objects
-	if(mapFile.is_open()) 
+/**
+ * Loads a map file, binary and chunked maps are streamed in around the
+ * player and text maps are imported
+ * Binary maps packed in the asset bundle are used from there
+ * Maps can be any size
+ * 
+ * @param path Path to the map file
+ * @returns False if the map failed to load, leaving an empty map
+ */
+bool Map::load(const char *path)
+{
+	bool loaded;
+
+	// Map files are never read whole, maps already in memory are chunked as they are looked up
+	const AssetEntry *entry = (bundle != NULL) ? bundle->find(path) : NULL;
+	if (entry != NULL)
 	{
-		for(int i = 0; i < MAX_TILES; ++i)
-		{
-			gameMap[i].resize(MAX_TILES);
-			for(int j = 0; j < MAX_TILES; ++j)
-			{
-				mapFile >> tile_type;
-				gameMap[i][j] = new MapTile(j * TILE_WIDTH, i * TILE_HEIGHT, textureToTile(tile_type), getTileTexture(tile_type));
-			}
-		}
+		loaded = mapFile.openMemory(bundle->getData(entry), entry->size, path) && chunks.open(&mapFile, CHUNK_BUDGET, TID_TERRAIN);
+	}
+	else if (ChunkCache::isStreamable(path))
+	{
+		mapFile.close();
+		loaded = chunks.openFile(path, CHUNK_BUDGET, TID_TERRAIN);
 	}
 	else
 	{
-		std::cout << "Map file failed to load" << std::endl;
+		loaded = mapFile.open(path) && chunks.open(&mapFile, CHUNK_BUDGET, TID_TERRAIN);
 	}
 
-	mapFile.close(); 
+	// Palette indices the map doesn't define, and unknown tile types, are pits
+	const std::vector<MapPaletteEntry> &palette = chunks.getPalette();
+	for (int i = 0; i <= TID_PIT; ++i)
+		paletteIndex[i] = -1;
+	for (int i = 0; i < MAP_MAX_PALETTE; ++i)
+	{
+		int type = (i < static_cast<int>(palette.size())) ? palette[i].type : TID_PIT;
+		paletteTypes[i] = (type <= TID_PIT) ? static_cast<tileID>(type) : TID_PIT;
+		if (i < static_cast<int>(palette.size()) && paletteIndex[paletteTypes[i]] < 0)
+			paletteIndex[paletteTypes[i]] = i;
+	}
+
+	// A new map starts undamaged
+	wallDamage.clear();
+	original.clear();
+	edits.clear();
+
+	return loaded;
 }
+
 /**
  * Retrieves a map texture
  * 
@@ -178,7 +217,7 @@ void Map::loadLevel(int level)
  */
 SDL_Texture* Map::getTileTexture(int tile_type)
 {
-	return mapTextures[tile_type];
+	return tileTextures[tile_type].get();
 }
 
 /**
@@ -191,29 +230,189 @@ bool Map::isPlayerColliding(Position player)
 {
 	// TO-DO: Calculate camera offset for both tiles and player
 
-	if (player.x <= 0 || player.y <= 0 || player.x + 20 >= MAX_TILES * TILE_WIDTH || player.y + 25 >= MAX_TILES * TILE_HEIGHT) 
+	if (player.x <= 0 || player.y <= 0 || player.x + ENTITY_FOOT_WIDTH >= getColumns() * TILE_WIDTH || player.y + ENTITY_FOOT_HEIGHT >= getRows() * TILE_HEIGHT) 
 		return false;
 
-	if (gameMap[player.y / TILE_WIDTH][player.x / TILE_HEIGHT]->getType() == TID_WALL ||
-		gameMap[(player.y + 25) / TILE_WIDTH][(player.x + 20) / TILE_HEIGHT]->getType() == TID_WALL ||
-		gameMap[(player.y + 25) / TILE_WIDTH][(player.x) / TILE_HEIGHT]->getType() == TID_WALL ||
-		gameMap[(player.y) / TILE_WIDTH][(player.x + 20) / TILE_HEIGHT]->getType() == TID_WALL)
-	{
+	int top = static_cast<int>(player.y) / TILE_HEIGHT;
+	int bottom = static_cast<int>(player.y + ENTITY_FOOT_HEIGHT) / TILE_HEIGHT;
+	int left = static_cast<int>(player.x) / TILE_WIDTH;
+	int right = static_cast<int>(player.x + ENTITY_FOOT_WIDTH) / TILE_WIDTH;
+
+	// Walls and pits both block, so every corner of the feet must be on terrain
+	return chunks.isWalkable(top, left) && chunks.isWalkable(top, right) &&
+		chunks.isWalkable(bottom, left) && chunks.isWalkable(bottom, right);
+}
+
+/**
+ * Keeps the map loaded around a position, call once per tick with the player's
+ * 
+ * @param pos Entity position
+ */
+void Map::streamAround(Position pos)
+{
+	chunks.prefetchAround(static_cast<int>(pos.y) / TILE_HEIGHT, static_cast<int>(pos.x) / TILE_WIDTH);
+}
+
+/**
+ * Damages a wall, which crumbles to terrain once it has taken WALL_HEALTH
+ * 
+ * @param tile Tile index (row * columns + column), anything but a wall is left alone
+ * @param damage Damage dealt
+ * @returns True if the wall crumbled
+ */
+bool Map::damageWall(int tile, int damage)
+{
+	if (tile < 0 || tile >= getRows() * getColumns())
 		return false;
-	}
 
-	if (gameMap[player.y / TILE_WIDTH][player.x / TILE_HEIGHT]->getType() == TID_PIT ||
-		gameMap[(player.y + 25) / TILE_WIDTH][(player.x + 20) / TILE_HEIGHT]->getType() == TID_PIT ||
-		gameMap[(player.y + 25) / TILE_WIDTH][(player.x) / TILE_HEIGHT]->getType() == TID_PIT ||
-		gameMap[(player.y) / TILE_WIDTH][(player.x + 20) / TILE_HEIGHT]->getType() == TID_PIT)
-	{
+	int row = tile / getColumns();
+	int col = tile % getColumns();
+	if (getTileType(row, col) != TID_WALL)
 		return false;
-	}
-	else
-	{
-		return true;
-	}
 
+	int &taken = wallDamage[tile];
+	taken += damage;
+	if (taken < WALL_HEALTH)
+		return false;
+
+	wallDamage.erase(tile);
+	return setTileType(row, col, TID_TERRAIN);
+}
+
+/**
+ * Changes a tile's type and records the change in the edit list
+ * Only the tile itself is touched, whatever was built from the map is left
+ * to catch up from getEdits
+ * 
+ * @param row Row of the tile
+ * @param col Column of the tile
+ * @param type New tile type
+ * @returns False if the tile is off the map, already that type, or the map has no palette entry for the type
+ */
+bool Map::setTileType(int row, int col, tileID type)
+{
+	if (!chunks.inBounds(row, col) || paletteIndex[type] < 0)
+		return false;
+
+	tileID before = getTileType(row, col);
+	if (before == type)
+		return false;
+
+	// Remember what the tile was loaded as, so the map can be put back
+	int tile = row * getColumns() + col;
+	std::unordered_map<int, tileID>::iterator first = original.find(tile);
+	if (first == original.end())
+		original[tile] = before;
+	else if (first->second == type)
+		original.erase(first);
+
+	chunks.setTile(row, col, static_cast<uint8_t>(paletteIndex[type]));
+
+	MapEdit edit = { row, col, before, type };
+	edits.push_back(edit);
+	return true;
+}
+
+/**
+ * Getter for the tiles changed since the last clearEdits
+ * 
+ * @returns Changes in the order they were made
+ */
+const std::vector<MapEdit> &Map::getEdits(void)
+{
+	return edits;
+}
+
+/**
+ * Forgets the changes returned by getEdits, call once they have been applied
+ */
+void Map::clearEdits(void)
+{
+	edits.clear();
+}
+
+/**
+ * Puts every changed tile back to how it was loaded, for restarting a run
+ * The changes back go in the edit list like any other
+ */
+void Map::revertEdits(void)
+{
+	std::unordered_map<int, tileID> changed;
+	changed.swap(original);
+	for (std::unordered_map<int, tileID>::iterator it = changed.begin(); it != changed.end(); ++it)
+		setTileType(it->first / getColumns(), it->first % getColumns(), it->second);
+
+	original.clear();
+	wallDamage.clear();
+}
+
+/**
+ * Getter for which tiles can be walked on, used by pathfinding
+ * Read through the chunk cache, so only the chunks looked at are in memory
+ * 
+ * @returns Walkable tiles of the loaded level
+ */
+WalkSource &Map::getWalkSource(void)
+{
+	return chunks;
+}
+
+/**
+ * Getter for the map height
+ * 
+ * @returns Rows of tiles
+ */
+int Map::getRows(void)
+{
+	return chunks.getRows();
+}
+
+/**
+ * Getter for the map width
+ * 
+ * @returns Tiles per row
+ */
+int Map::getColumns(void)
+{
+	return chunks.getColumns();
+}
+
+/**
+ * Tile index (row * columns + column) under the middle of an entity's feet
+ * 
+ * @param pos Entity position
+ * @returns Tile index, or -1 if off the map
+ */
+int Map::getTileIndex(Position pos)
+{
+	int row = static_cast<int>(pos.y + ENTITY_FOOT_HEIGHT / 2) / TILE_HEIGHT;
+	int col = static_cast<int>(pos.x + ENTITY_FOOT_WIDTH / 2) / TILE_WIDTH;
+
+	if (pos.x < 0 || pos.y < 0 || !chunks.inBounds(row, col))
+		return -1;
+	return row * getColumns() + col;
+}
+
+/**
+ * Directions that bring an entity's feet to the middle of a tile
+ * Steering to the middle instead of just toward the tile keeps hitboxes from clipping corners
+ * 
+ * @param pos Entity position
+ * @param row Row of the tile to walk to
+ * @param col Column of the tile to walk to
+ * @returns Directions to move, all false once the entity is there
+ */
+Movement steerTowardTile(Position pos, int row, int col)
+{
+	Movement dir;
+	double goalX = col * TILE_WIDTH + (TILE_WIDTH - ENTITY_FOOT_WIDTH) / 2;
+	double goalY = row * TILE_HEIGHT + (TILE_HEIGHT - ENTITY_FOOT_HEIGHT) / 2;
+
+	dir.right = (goalX - pos.x > STEER_SLACK);
+	dir.left = (pos.x - goalX > STEER_SLACK);
+	dir.down = (goalY - pos.y > STEER_SLACK);
+	dir.up = (pos.y - goalY > STEER_SLACK);
+	return dir;
 }
 
 /**
@@ -7,14 +7,29 @@
 #pragma once
 #include <SDL2/SDL.h>
 #include <vector>
+#include <unordered_map>
 #include <iostream>
 #include <fstream>
-#include "Entity.h"
+#include "movement.h"
 #include "TextureManager.h"
+#include "WalkGrid.h"
+#include "MapFile.h"
+#include "ChunkCache.h"
 
 const int TILE_HEIGHT = 100;
 const int TILE_WIDTH = 100;
-const int MAX_TILES = 30;
+
+// Part of an entity that collides with the map, measured from its position
+const int ENTITY_FOOT_WIDTH = 20;
+const int ENTITY_FOOT_HEIGHT = 25;
+
+// Damage a wall takes before it crumbles to terrain
+const int WALL_HEALTH = 10;
+
+// Pixels an entity may be off the centre of a tile before steering corrects it
+const int STEER_SLACK = 2;
+
+Movement steerTowardTile(Position pos, int row, int col);
 
 // Identifiers for tile types
 enum tileID 
@@ -24,6 +39,17 @@ enum tileID
 	TID_PIT,
 };
 
+/**
+ * A tile that changed type, for everything that keeps its own copy of the map to catch up on
+ */
+struct MapEdit
+{
+	int row;
+	int col;
+	tileID before;
+	tileID after;
+};
+
 /**
  * Represents a single map tile
  */
@@ -50,17 +76,38 @@ private:
 class Map 
 {
 public:	
-	Map(TextureManager * txMan);
+	Map(TextureManager * txMan, const char *path = NULL);
 	~Map(void);
 	
 	void loadLevel(int level);
-	MapTile *getTile(int x, int y);
+	bool load(const char *path);
+	MapTile getTile(int row, int col);
+	tileID getTileType(int row, int col);
 	SDL_Texture* getTileTexture(int tile_type);
 	bool isPlayerColliding(Position player);
+	void streamAround(Position pos);
+	bool damageWall(int tile, int damage);
+	bool setTileType(int row, int col, tileID type);
+	const std::vector<MapEdit> &getEdits(void);
+	void clearEdits(void);
+	void revertEdits(void);
+	WalkSource &getWalkSource(void);
+	int getTileIndex(Position pos);
+	int getRows(void);
+	int getColumns(void);
 
 	tileID textureToTile(int tile_type);
 	TextureID tileToTexture(int texture_type);
 private:
-	std::vector<SDL_Texture*> mapTextures;
-	std::vector<std::vector<MapTile*> > gameMap;
+	TextureHandle tileTextures[TID_PIT + 1]; // Looked up as tiles are drawn, so they can be uploaded after the map loads
+	const AssetBundle *bundle;          // Checked for maps before their own files, NULL without a texture manager
+	MapFile mapFile;                    // Tiles of a level that was imported or packed in the bundle
+	ChunkCache chunks;                  // Tiles around the player, every tile and walkability lookup goes through it
+	tileID paletteTypes[MAP_MAX_PALETTE]; // Tile type of every palette index
+	int paletteIndex[TID_PIT + 1];        // First palette index of every tile type, -1 if it has none
+
+	// Destructible walls
+	std::unordered_map<int, int> wallDamage;    // Damage taken by each wall that has been hit
+	std::unordered_map<int, tileID> original;   // Type each changed tile had when the map was loaded
+	std::vector<MapEdit> edits;                 // Changes not yet picked up
 };
@@ -0,0 +1,347 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "MapFile.h"
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Constructor, starts with no map
+ */
+MapFile::MapFile(void):
+    mapped(NULL),
+    mappedSize(0),
+    width(0),
+    height(0),
+    tiles(NULL)
+{
+}
+
+/**
+ * Destructor, unmaps the file
+ */
+MapFile::~MapFile(void)
+{
+    close();
+}
+
+/**
+ * Opens a map, binary if the file starts with MAP_FILE_MAGIC and text otherwise
+ *
+ * @param path Path to the map
+ * @returns False if the map could not be used, the previous map is closed either way
+ */
+bool MapFile::open(const char *path)
+{
+    char magic[4] = { 0, 0, 0, 0 };
+    std::ifstream probe(path, std::ios::binary);
+
+    close();
+    if (!probe.is_open())
+    {
+        std::cout << "Map file failed to load: " << path << std::endl;
+        return false;
+    }
+    probe.read(magic, sizeof(magic));
+    probe.close();
+
+    if (memcmp(magic, MAP_FILE_MAGIC, sizeof(magic)) == 0)
+        return mapFile(path);
+    return importText(path);
+}
+
+/**
+ * Uses a binary map that is already in memory, without copying it
+ *
+ * @param data Start of the map, must stay valid until the map is closed
+ * @param size Bytes of map
+ * @param name Where the map came from, for error messages
+ * @returns False if it isn't a binary map or is malformed, the previous map is closed either way
+ */
+bool MapFile::openMemory(const uint8_t *data, size_t size, const char *name)
+{
+    close();
+    if (size < sizeof(MapFileHeader) || memcmp(data, MAP_FILE_MAGIC, 4) != 0)
+    {
+        std::cout << "Not a binary map: " << name << std::endl;
+        return false;
+    }
+    return useBinary(data, size, name);
+}
+
+/**
+ * Maps a binary map into memory and checks its header
+ *
+ * @param path Path to the binary map
+ * @returns False if the file is unreadable or malformed
+ */
+bool MapFile::mapFile(const char *path)
+{
+    int fd = ::open(path, O_RDONLY);
+    struct stat info;
+
+    if (fd < 0 || fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(MapFileHeader))
+    {
+        if (fd >= 0)
+            ::close(fd);
+        std::cout << "Map file failed to load: " << path << std::endl;
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    mappedSize = info.st_size;
+    mapped = mmap(NULL, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        mapped = NULL;
+        std::cout << "Map file failed to map: " << path << std::endl;
+        return false;
+    }
+
+    if (!useBinary(static_cast<const uint8_t *>(mapped), mappedSize, path))
+        return false;
+
+    // Every tile is read straight away to find the walkable ones, so start reading it all in now
+    madvise(mapped, mappedSize, MADV_WILLNEED);
+    return true;
+}
+
+/**
+ * Checks a binary map's header and points the tiles at its tile array
+ *
+ * @param bytes Start of the map
+ * @param size Bytes of map
+ * @param name Where the map came from, for error messages
+ * @returns False if the header is malformed, closing the map
+ */
+bool MapFile::useBinary(const uint8_t *bytes, size_t size, const char *name)
+{
+    MapFileHeader header;
+    memcpy(&header, bytes, sizeof(header));
+
+    uint64_t paletteEnd = sizeof(header) + static_cast<uint64_t>(header.paletteSize) * sizeof(MapPaletteEntry);
+    uint64_t tileEnd = header.tileOffset + static_cast<uint64_t>(header.width) * header.height;
+    if (header.version != MAP_FILE_VERSION || header.width == 0 || header.height == 0
+        || header.width > INT32_MAX / header.height || header.paletteSize == 0
+        || header.paletteSize > MAP_MAX_PALETTE || header.tileOffset < paletteEnd || tileEnd > size)
+    {
+        std::cout << "Bad map file header: " << name << std::endl;
+        close();
+        return false;
+    }
+
+    width = header.width;
+    height = header.height;
+    palette.resize(header.paletteSize);
+    memcpy(palette.data(), bytes + sizeof(header), header.paletteSize * sizeof(MapPaletteEntry));
+    tiles = bytes + header.tileOffset;
+    return true;
+}
+
+/**
+ * Reads a text map, one row of whitespace-separated tile types per line
+ *
+ * @param path Path to the text map
+ * @returns False if the file is unreadable or the rows differ in length
+ */
+bool MapFile::importText(const char *path)
+{
+    std::ifstream mapFile(path);
+    std::string line;
+    int maxType = 0;
+
+    close();
+    if (!mapFile.is_open())
+    {
+        std::cout << "Map file failed to load: " << path << std::endl;
+        return false;
+    }
+
+    while (std::getline(mapFile, line))
+    {
+        std::istringstream row(line);
+        int type;
+        int columns = 0;
+
+        while (row >> type)
+        {
+            if (type < 0 || type >= MAP_MAX_PALETTE)
+            {
+                std::cout << "Bad map tile: " << line << std::endl;
+                close();
+                return false;
+            }
+            imported.push_back(type);
+            if (type > maxType)
+                maxType = type;
+            ++columns;
+        }
+
+        // Skip blank lines, every other row must match the first
+        if (columns == 0)
+            continue;
+        if (width != 0 && columns != width)
+        {
+            std::cout << "Map rows differ in length: " << path << std::endl;
+            close();
+            return false;
+        }
+        width = columns;
+        ++height;
+    }
+
+    if (height == 0)
+    {
+        std::cout << "Map file has no tiles: " << path << std::endl;
+        return false;
+    }
+
+    // Text maps store tile types directly, so the palette maps each type to itself
+    palette.resize(maxType + 1);
+    for (int i = 0; i <= maxType; ++i)
+    {
+        MapPaletteEntry entry = { static_cast<uint8_t>(i), { 0, 0, 0 } };
+        palette[i] = entry;
+    }
+    tiles = imported.data();
+    return true;
+}
+
+/**
+ * Releases the current map
+ */
+void MapFile::close(void)
+{
+    if (mapped != NULL)
+        munmap(mapped, mappedSize);
+    mapped = NULL;
+    mappedSize = 0;
+    imported.clear();
+    palette.clear();
+    width = 0;
+    height = 0;
+    tiles = NULL;
+}
+
+/**
+ * Writes the current map in the binary format
+ *
+ * @param path Where to write it
+ * @returns False if there is no map or the file could not be written
+ */
+bool MapFile::save(const char *path) const
+{
+    if (tiles == NULL)
+    {
+        std::cout << "No map to save: " << path << std::endl;
+        return false;
+    }
+    return write(path, width, height, palette, tiles);
+}
+
+/**
+ * Writes tiles in the binary format
+ *
+ * @param path Where to write them
+ * @param width Tiles per row
+ * @param height Rows
+ * @param palette What each palette index stands for
+ * @param tiles Palette indices, row-major
+ * @returns False if the file could not be written
+ */
+bool MapFile::write(const char *path, int width, int height, const std::vector<MapPaletteEntry> &palette, const uint8_t *tiles)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    MapFileHeader header;
+
+    if (!out.is_open())
+    {
+        std::cout << "Map file failed to save: " << path << std::endl;
+        return false;
+    }
+
+    memcpy(header.magic, MAP_FILE_MAGIC, sizeof(header.magic));
+    header.version = MAP_FILE_VERSION;
+    header.width = width;
+    header.height = height;
+    header.paletteSize = palette.size();
+    header.tileOffset = sizeof(header) + palette.size() * sizeof(MapPaletteEntry);
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(palette.data()), palette.size() * sizeof(MapPaletteEntry));
+    out.write(reinterpret_cast<const char *>(tiles), static_cast<size_t>(width) * height);
+    return out.good();
+}
+
+/**
+ * Marks which tiles can be walked on
+ *
+ * @param grid Receives the map's size and walkable tiles
+ * @param walkableType The one tile type that can be walked on
+ */
+void MapFile::fillWalkGrid(WalkGrid &grid, uint8_t walkableType) const
+{
+    unsigned char walkable[MAP_MAX_PALETTE];
+
+    // Looked up per palette index, indices the palette doesn't cover can't be walked on
+    for (int i = 0; i < MAP_MAX_PALETTE; ++i)
+        walkable[i] = (i < static_cast<int>(palette.size()) && palette[i].type == walkableType);
+
+    // Plain pointers, byte stores would otherwise make the compiler reload the vector every tile
+    grid.resize(height, width);
+    unsigned char *out = grid.walkable.data();
+    const uint8_t *in = tiles;
+    size_t count = grid.walkable.size();
+    for (size_t i = 0; i < count; ++i)
+        out[i] = walkable[in[i]];
+}
+
+/**
+ * Getter for the map width
+ *
+ * @returns Tiles per row, 0 if no map is open
+ */
+int MapFile::getWidth(void) const
+{
+    return width;
+}
+
+/**
+ * Getter for the map height
+ *
+ * @returns Rows, 0 if no map is open
+ */
+int MapFile::getHeight(void) const
+{
+    return height;
+}
+
+/**
+ * Getter for the tiles
+ *
+ * @returns Palette indices, row-major, valid until the map is closed
+ */
+const uint8_t *MapFile::getTiles(void) const
+{
+    return tiles;
+}
+
+/**
+ * Getter for the palette
+ *
+ * @returns What each palette index stands for
+ */
+const std::vector<MapPaletteEntry> &MapFile::getPalette(void) const
+{
+    return palette;
+}
@@ -0,0 +1,93 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _MAPFILE_
+#define _MAPFILE_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "WalkGrid.h"
+
+// First bytes of every binary map
+#define MAP_FILE_MAGIC "SGMP"
+
+// Bumped whenever the layout below changes
+#define MAP_FILE_VERSION 1
+
+// Most palette entries a map can have, tiles are one byte
+#define MAP_MAX_PALETTE 256
+
+/**
+ * Binary map layout, little-endian:
+ *
+ *   MapFileHeader
+ *   MapPaletteEntry[paletteSize]
+ *   uint8_t tiles[height][width]  (at tileOffset, palette indices, row-major)
+ *
+ * The tile array is used straight from the mapped file, nothing is parsed.
+ */
+struct MapFileHeader
+{
+    char magic[4];         // MAP_FILE_MAGIC
+    uint32_t version;      // MAP_FILE_VERSION
+    uint32_t width;        // Tiles per row
+    uint32_t height;       // Rows
+    uint32_t paletteSize;  // Palette entries after the header
+    uint32_t tileOffset;   // Byte offset of the tile array from the start of the file
+};
+
+// What a palette index stands for
+struct MapPaletteEntry
+{
+    uint8_t type;        // Tile type, a tileID
+    uint8_t reserved[3]; // Zero
+};
+
+/**
+ * A map's tiles, either mapped from a binary file or imported from text
+ * Binary maps already in memory, e.g. in the asset bundle, are used where they are
+ *
+ * Kept free of SDL so maps can be converted and benchmarked without a renderer
+ */
+class MapFile
+{
+public:
+    MapFile(void);
+    ~MapFile(void);
+
+    bool open(const char *path);
+    bool openMemory(const uint8_t *data, size_t size, const char *name);
+    bool importText(const char *path);
+    void close(void);
+
+    bool save(const char *path) const;
+    static bool write(const char *path, int width, int height, const std::vector<MapPaletteEntry> &palette, const uint8_t *tiles);
+
+    void fillWalkGrid(WalkGrid &grid, uint8_t walkableType) const;
+
+    int getWidth(void) const;
+    int getHeight(void) const;
+    const uint8_t *getTiles(void) const;
+    const std::vector<MapPaletteEntry> &getPalette(void) const;
+
+private:
+    MapFile(const MapFile &) = delete; // Would unmap the file twice
+    MapFile &operator=(const MapFile &) = delete;
+
+    bool mapFile(const char *path);
+    bool useBinary(const uint8_t *bytes, size_t size, const char *name);
+
+    void *mapped;       // Whole file while a binary map file is open, NULL otherwise
+    size_t mappedSize;
+    std::vector<uint8_t> imported; // Tiles of a text map
+
+    int width;
+    int height;
+    const uint8_t *tiles;
+    std::vector<MapPaletteEntry> palette;
+};
+#endif
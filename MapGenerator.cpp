@@ -0,0 +1,601 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "MapGenerator.h"
+#include <atomic>
+#include <iostream>
+#include <stdint.h>
+#include <thread>
+#include "ChunkCache.h"
+#include "SplitMix.h"
+
+// Sides of a square that doors are placed on, each door belongs to the square west or north of it
+#define SIDE_EAST 0
+#define SIDE_SOUTH 1
+
+/**
+ * Draws a number from a generator
+ *
+ * @param state Generator state, advanced
+ * @param n Exclusive upper bound, at least 1
+ * @returns Number from 0 to n - 1
+ */
+static int randomBelow(uint64_t &state, int n)
+{
+    // Scales the top bits instead of taking a remainder, which would be a division per tile
+    return static_cast<int>(((splitMix64(state) >> 32) * static_cast<uint64_t>(n)) >> 32);
+}
+
+/**
+ * Seeds a square's generator from the map seed
+ *
+ * @param seed Map seed
+ * @param chunk Square index
+ * @param salt Tells apart generators for different purposes
+ * @returns Generator state
+ */
+static uint64_t chunkSeed(uint64_t seed, int chunk, int salt)
+{
+    uint64_t state = seed ^ (static_cast<uint64_t>(chunk) << 32) ^ static_cast<uint64_t>(salt);
+    splitMix64(state);
+    return state;
+}
+
+/**
+ * Follows a component to its root, halving the path on the way
+ *
+ * @param parent Parent of every component
+ * @param i Component
+ * @returns Root component
+ */
+static int findRoot(std::vector<int> &parent, int i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+/**
+ * Constructor, starts with no map
+ */
+MapGenerator::MapGenerator(void):
+    width(0),
+    height(0),
+    seed(0),
+    chunkColumns(0),
+    chunkRows(0)
+{
+}
+
+/**
+ * Generates a map, replacing the previous one
+ *
+ * @param width Tiles per row
+ * @param height Rows
+ * @param seed The same seed always gives the same map
+ * @param threads Threads to share the squares between, the calling thread included
+ * @returns False if the size is too small or too large
+ */
+bool MapGenerator::generate(int width, int height, uint64_t seed, int threads)
+{
+    if (width < GEN_MIN_SIZE || height < GEN_MIN_SIZE || width > INT32_MAX / height)
+    {
+        std::cout << "Can't generate a " << width << "x" << height << " map" << std::endl;
+        return false;
+    }
+
+    this->width = width;
+    this->height = height;
+    this->seed = seed;
+    chunkColumns = (width + GEN_CHUNK_SIZE - 1) / GEN_CHUNK_SIZE;
+    chunkRows = (height + GEN_CHUNK_SIZE - 1) / GEN_CHUNK_SIZE;
+    tiles.assign(static_cast<size_t>(width) * height, GEN_WALL);
+
+    forEachChunk(threads, [this](int chunk) { fillChunk(chunk); });
+    connect(threads);
+    return true;
+}
+
+/**
+ * Writes the map so Map::load can open it
+ *
+ * @param path Where to write it
+ * @param chunked Write a chunked map the game streams in, instead of a binary map
+ * @returns False if there is no map or the file could not be written
+ */
+bool MapGenerator::save(const char *path, bool chunked) const
+{
+    if (tiles.empty())
+    {
+        std::cout << "No map to save: " << path << std::endl;
+        return false;
+    }
+
+    if (chunked)
+        return ChunkCache::write(path, width, height, getPalette(), tiles.data());
+    return MapFile::write(path, width, height, getPalette(), tiles.data());
+}
+
+/**
+ * Runs a task once for every square, sharing the squares out between threads as they finish
+ *
+ * @param threads Threads to use, the calling thread included
+ * @param task Called with each square's index, must only touch that square's tiles
+ */
+template <typename Task>
+void MapGenerator::forEachChunk(int threads, Task task)
+{
+    std::atomic<int> next(0);
+    int count = chunkColumns * chunkRows;
+    std::vector<std::thread> helpers;
+
+    auto work = [&next, count, &task]() {
+        for (int chunk = next++; chunk < count; chunk = next++)
+            task(chunk);
+    };
+
+    for (int i = 1; i < threads && i < count; ++i)
+        helpers.push_back(std::thread(work));
+    work();
+    for (size_t i = 0; i < helpers.size(); ++i)
+        helpers[i].join();
+}
+
+/**
+ * Tiles a square covers, squares along the right and bottom edges may be cut short
+ *
+ * @param chunk Square index
+ * @returns First row and column, and size
+ */
+MapGenerator::Rect MapGenerator::chunkRect(int chunk) const
+{
+    Rect area;
+
+    area.row = (chunk / chunkColumns) * GEN_CHUNK_SIZE;
+    area.col = (chunk % chunkColumns) * GEN_CHUNK_SIZE;
+    area.rows = (height - area.row < GEN_CHUNK_SIZE) ? height - area.row : GEN_CHUNK_SIZE;
+    area.cols = (width - area.col < GEN_CHUNK_SIZE) ? width - area.col : GEN_CHUNK_SIZE;
+    return area;
+}
+
+/**
+ * Fills one square with a cave or rooms, then carves corridors from its middle to its doors
+ *
+ * @param chunk Square index
+ */
+void MapGenerator::fillChunk(int chunk)
+{
+    Rect area = chunkRect(chunk);
+    uint64_t rng = chunkSeed(seed, chunk, 0);
+    int cx = chunk % chunkColumns;
+    int cy = chunk / chunkColumns;
+    int hubRow = area.row + area.rows / 2;
+    int hubCol = area.col + area.cols / 2;
+
+    // Squares cut too short by the map edge to fit two rooms are always caves
+    if (area.rows >= 2 * GEN_MIN_LEAF && area.cols >= 2 * GEN_MIN_LEAF && randomBelow(rng, 2) == 0)
+    {
+        splitRooms(area, rng, hubRow, hubCol);
+    }
+    else
+    {
+        growCave(area, rng);
+
+        // Clear a little space in the middle for the corridors to meet in
+        for (int row = hubRow - 1; row <= hubRow + 1; ++row)
+        {
+            for (int col = hubCol - 1; col <= hubCol + 1; ++col)
+            {
+                if (row >= area.row && col >= area.col && row < area.row + area.rows && col < area.col + area.cols)
+                    tiles[static_cast<size_t>(row) * width + col] = GEN_TERRAIN;
+            }
+        }
+    }
+
+    // Doors are shared, so both squares carve up to the same spot on their common edge
+    if (cx > 0)
+        carveCorridor(hubRow, hubCol, area.row + doorOffset(chunk - 1, SIDE_EAST, area.rows), area.col, randomBelow(rng, 2) == 0);
+    if (cx < chunkColumns - 1)
+        carveCorridor(hubRow, hubCol, area.row + doorOffset(chunk, SIDE_EAST, area.rows), area.col + area.cols - 1, randomBelow(rng, 2) == 0);
+    if (cy > 0)
+        carveCorridor(hubRow, hubCol, area.row, area.col + doorOffset(chunk - chunkColumns, SIDE_SOUTH, area.cols), randomBelow(rng, 2) == 0);
+    if (cy < chunkRows - 1)
+        carveCorridor(hubRow, hubCol, area.row + area.rows - 1, area.col + doorOffset(chunk, SIDE_SOUTH, area.cols), randomBelow(rng, 2) == 0);
+
+    // The player always starts on floor that leads somewhere
+    if (GEN_START_ROW >= area.row && GEN_START_ROW < area.row + area.rows && GEN_START_COL >= area.col && GEN_START_COL < area.col + area.cols)
+        carveCorridor(hubRow, hubCol, GEN_START_ROW, GEN_START_COL, true);
+
+    // Wall around the edge of the map
+    for (int row = area.row; row < area.row + area.rows; ++row)
+    {
+        for (int col = area.col; col < area.col + area.cols; ++col)
+        {
+            if (row == 0 || col == 0 || row == height - 1 || col == width - 1)
+                tiles[static_cast<size_t>(row) * width + col] = GEN_WALL;
+        }
+    }
+}
+
+/**
+ * Fills an area with random walls, then smooths them into caves: a cell becomes
+ * wall when most of the cells around it are, with everything outside the area counting as wall
+ *
+ * @param area Tiles to fill
+ * @param rng Square's generator
+ */
+void MapGenerator::growCave(const Rect &area, uint64_t &rng)
+{
+    // A border of wall around the cells saves checking for the area's edge
+    int stride = area.cols + 2;
+    std::vector<uint8_t> cells(static_cast<size_t>(area.rows + 2) * stride, 1);
+
+    for (int r = 1; r <= area.rows; ++r)
+    {
+        for (int c = 1; c <= area.cols; ++c)
+            cells[static_cast<size_t>(r) * stride + c] = randomBelow(rng, 100) < GEN_CAVE_FILL;
+    }
+
+    std::vector<uint8_t> next(cells);
+    for (int pass = 0; pass < GEN_CAVE_PASSES; ++pass)
+    {
+        for (int r = 1; r <= area.rows; ++r)
+        {
+            const uint8_t *above = &cells[static_cast<size_t>(r - 1) * stride];
+            const uint8_t *row = above + stride;
+            const uint8_t *below = row + stride;
+            uint8_t *out = &next[static_cast<size_t>(r) * stride];
+
+            for (int c = 1; c <= area.cols; ++c)
+            {
+                int walls = above[c - 1] + above[c] + above[c + 1] + row[c - 1] + row[c] + row[c + 1]
+                    + below[c - 1] + below[c] + below[c + 1];
+                out[c] = walls >= 5;
+            }
+        }
+        cells.swap(next);
+    }
+
+    for (int r = 0; r < area.rows; ++r)
+    {
+        const uint8_t *in = &cells[static_cast<size_t>(r + 1) * stride + 1];
+        uint8_t *out = &tiles[static_cast<size_t>(area.row + r) * width + area.col];
+        for (int c = 0; c < area.cols; ++c)
+            out[c] = in[c] ? GEN_WALL : GEN_TERRAIN;
+    }
+}
+
+/**
+ * Splits an area in two along its longer side until the pieces are small,
+ * puts a room in each piece and joins the rooms of each split with a corridor
+ *
+ * @param area Tiles to lay out, at least GEN_MIN_LEAF along each side
+ * @param rng Square's generator
+ * @param hubRow Receives the row of the middle of one of the rooms
+ * @param hubCol Receives the column of the middle of that room
+ */
+void MapGenerator::splitRooms(const Rect &area, uint64_t &rng, int &hubRow, int &hubCol)
+{
+    bool splitRows = area.rows >= area.cols;
+    int length = splitRows ? area.rows : area.cols;
+
+    if (length < 2 * GEN_MIN_LEAF)
+    {
+        // Leave at least a tile of wall on every side of the room
+        int roomRows = GEN_MIN_LEAF / 2 + randomBelow(rng, area.rows - 1 - GEN_MIN_LEAF / 2);
+        int roomCols = GEN_MIN_LEAF / 2 + randomBelow(rng, area.cols - 1 - GEN_MIN_LEAF / 2);
+        int top = area.row + 1 + randomBelow(rng, area.rows - 1 - roomRows);
+        int left = area.col + 1 + randomBelow(rng, area.cols - 1 - roomCols);
+
+        for (int row = top; row < top + roomRows; ++row)
+        {
+            for (int col = left; col < left + roomCols; ++col)
+                tiles[static_cast<size_t>(row) * width + col] = (randomBelow(rng, 100) < GEN_PIT_CHANCE) ? GEN_PIT : GEN_TERRAIN;
+        }
+
+        hubRow = top + roomRows / 2;
+        hubCol = left + roomCols / 2;
+        return;
+    }
+
+    int at = GEN_MIN_LEAF + randomBelow(rng, length - 2 * GEN_MIN_LEAF + 1);
+    Rect first = area;
+    Rect second = area;
+    if (splitRows)
+    {
+        first.rows = at;
+        second.row += at;
+        second.rows -= at;
+    }
+    else
+    {
+        first.cols = at;
+        second.col += at;
+        second.cols -= at;
+    }
+
+    int otherRow, otherCol;
+    splitRooms(first, rng, hubRow, hubCol);
+    splitRooms(second, rng, otherRow, otherCol);
+    carveCorridor(hubRow, hubCol, otherRow, otherCol, randomBelow(rng, 2) == 0);
+}
+
+/**
+ * Carves an L-shaped corridor of floor between two tiles
+ *
+ * @param fromRow Row of the first tile
+ * @param fromCol Column of the first tile
+ * @param toRow Row of the second tile
+ * @param toCol Column of the second tile
+ * @param rowsFirst Go along the first tile's row before turning, instead of its column
+ */
+void MapGenerator::carveCorridor(int fromRow, int fromCol, int toRow, int toCol, bool rowsFirst)
+{
+    int cornerRow = rowsFirst ? fromRow : toRow;
+    int cornerCol = rowsFirst ? toCol : fromCol;
+
+    carveLine(fromRow, fromCol, cornerRow, cornerCol);
+    carveLine(cornerRow, cornerCol, toRow, toCol);
+}
+
+/**
+ * Carves a straight line of floor between two tiles on the same row or column
+ *
+ * @param fromRow Row of the first tile
+ * @param fromCol Column of the first tile
+ * @param toRow Row of the second tile
+ * @param toCol Column of the second tile
+ */
+void MapGenerator::carveLine(int fromRow, int fromCol, int toRow, int toCol)
+{
+    int stepRow = (toRow > fromRow) - (toRow < fromRow);
+    int stepCol = (toCol > fromCol) - (toCol < fromCol);
+
+    for (int row = fromRow, col = fromCol; ; row += stepRow, col += stepCol)
+    {
+        tiles[static_cast<size_t>(row) * width + col] = GEN_TERRAIN;
+        if (row == toRow && col == toCol)
+            break;
+    }
+}
+
+/**
+ * Where along an edge a square's door is, the same for both squares sharing the edge
+ *
+ * @param chunk Square west or north of the edge
+ * @param side SIDE_EAST or SIDE_SOUTH of that square
+ * @param length Tiles along the edge
+ * @returns Offset from the first tile of the edge, clear of its ends
+ */
+int MapGenerator::doorOffset(int chunk, int side, int length) const
+{
+    uint64_t rng = chunkSeed(seed, chunk, 1 + side);
+
+    if (length < 3)
+        return length / 2;
+    return 1 + randomBelow(rng, length - 2);
+}
+
+/**
+ * Labels the floor of a square by which tiles can walk to each other without leaving it
+ *
+ * @param chunk Square index
+ * @param labels Receives a label per tile of the square, row-major: 0 for anything
+ *               but floor, otherwise 1 up to the number of groups
+ * @returns Number of groups
+ */
+int MapGenerator::labelChunk(int chunk, std::vector<uint16_t> &labels) const
+{
+    const uint16_t blocked = 0xFFFF;
+    Rect area = chunkRect(chunk);
+    int stride = area.cols + 2;
+    std::vector<uint16_t> grid(static_cast<size_t>(area.rows + 2) * stride, blocked);
+    std::vector<int> stack;
+    int count = 0;
+
+    // Flooded with a border of blocked tiles around the square, so neighbours need no edge checks
+    for (int r = 0; r < area.rows; ++r)
+    {
+        const uint8_t *in = &tiles[static_cast<size_t>(area.row + r) * width + area.col];
+        uint16_t *out = &grid[static_cast<size_t>(r + 1) * stride + 1];
+        for (int c = 0; c < area.cols; ++c)
+            out[c] = (in[c] == GEN_TERRAIN) ? 0 : blocked;
+    }
+
+    const int offsets[4] = { -stride, stride, -1, 1 };
+    for (int r = 1; r <= area.rows; ++r)
+    {
+        for (int c = 1; c <= area.cols; ++c)
+        {
+            int first = r * stride + c;
+            if (grid[first] != 0)
+                continue;
+
+            // Flood the group this tile starts
+            grid[first] = ++count;
+            stack.push_back(first);
+            while (!stack.empty())
+            {
+                int tile = stack.back();
+                stack.pop_back();
+                for (int n = 0; n < 4; ++n)
+                {
+                    if (grid[tile + offsets[n]] == 0)
+                    {
+                        grid[tile + offsets[n]] = count;
+                        stack.push_back(tile + offsets[n]);
+                    }
+                }
+            }
+        }
+    }
+
+    labels.resize(static_cast<size_t>(area.rows) * area.cols);
+    for (int r = 0; r < area.rows; ++r)
+    {
+        const uint16_t *in = &grid[static_cast<size_t>(r + 1) * stride + 1];
+        uint16_t *out = &labels[static_cast<size_t>(r) * area.cols];
+        for (int c = 0; c < area.cols; ++c)
+            out[c] = (in[c] == blocked) ? 0 : in[c];
+    }
+    return count;
+}
+
+/**
+ * Walls off every floor tile that can't be walked to from the start tile
+ *
+ * Groups of floor are labelled inside each square in parallel, then the
+ * groups touching across square edges are merged, and finally each square
+ * walls off its groups that didn't end up with the start tile's. Only the
+ * square edges are kept between passes, not a label for every tile.
+ *
+ * @param threads Threads to share the squares between
+ */
+void MapGenerator::connect(int threads)
+{
+    int count = chunkColumns * chunkRows;
+    std::vector<int> groups(count);
+    std::vector<std::vector<uint16_t> > edges(count); // Top row, bottom row, left column, right column
+    int startChunk = (GEN_START_ROW / GEN_CHUNK_SIZE) * chunkColumns + GEN_START_COL / GEN_CHUNK_SIZE;
+    int startLabel = 0;
+
+    forEachChunk(threads, [this, &groups, &edges, startChunk, &startLabel](int chunk) {
+        Rect area = chunkRect(chunk);
+        std::vector<uint16_t> labels;
+        std::vector<uint16_t> &edge = edges[chunk];
+
+        groups[chunk] = labelChunk(chunk, labels);
+        edge.resize(2 * area.cols + 2 * area.rows);
+        for (int c = 0; c < area.cols; ++c)
+        {
+            edge[c] = labels[c];
+            edge[area.cols + c] = labels[static_cast<size_t>(area.rows - 1) * area.cols + c];
+        }
+        for (int r = 0; r < area.rows; ++r)
+        {
+            edge[2 * area.cols + r] = labels[static_cast<size_t>(r) * area.cols];
+            edge[2 * area.cols + area.rows + r] = labels[static_cast<size_t>(r) * area.cols + area.cols - 1];
+        }
+        if (chunk == startChunk)
+            startLabel = labels[(GEN_START_ROW - area.row) * area.cols + GEN_START_COL - area.col];
+    });
+
+    // Every group gets a number across the whole map
+    std::vector<int> firstGroup(count + 1, 0);
+    for (int i = 0; i < count; ++i)
+        firstGroup[i + 1] = firstGroup[i] + groups[i];
+
+    std::vector<int> parent(firstGroup[count]);
+    for (size_t i = 0; i < parent.size(); ++i)
+        parent[i] = i;
+
+    // Floor on both sides of a square edge joins the two groups
+    for (int chunk = 0; chunk < count; ++chunk)
+    {
+        Rect area = chunkRect(chunk);
+        const std::vector<uint16_t> &edge = edges[chunk];
+
+        if (chunk % chunkColumns < chunkColumns - 1)
+        {
+            const std::vector<uint16_t> &east = edges[chunk + 1];
+            int eastCols = chunkRect(chunk + 1).cols;
+            for (int r = 0; r < area.rows; ++r)
+            {
+                int a = edge[2 * area.cols + area.rows + r];
+                int b = east[2 * eastCols + r];
+                if (a != 0 && b != 0)
+                    parent[findRoot(parent, firstGroup[chunk] + a - 1)] = findRoot(parent, firstGroup[chunk + 1] + b - 1);
+            }
+        }
+        if (chunk / chunkColumns < chunkRows - 1)
+        {
+            const std::vector<uint16_t> &south = edges[chunk + chunkColumns];
+            for (int c = 0; c < area.cols; ++c)
+            {
+                int a = edge[area.cols + c];
+                int b = south[c];
+                if (a != 0 && b != 0)
+                    parent[findRoot(parent, firstGroup[chunk] + a - 1)] = findRoot(parent, firstGroup[chunk + chunkColumns] + b - 1);
+            }
+        }
+    }
+
+    // Decided up front so the last pass only reads it
+    std::vector<unsigned char> keep(parent.size(), 1);
+    if (startLabel != 0)
+    {
+        int startRoot = findRoot(parent, firstGroup[startChunk] + startLabel - 1);
+        for (size_t i = 0; i < parent.size(); ++i)
+            keep[i] = findRoot(parent, i) == startRoot;
+    }
+
+    forEachChunk(threads, [this, &firstGroup, &keep](int chunk) {
+        Rect area = chunkRect(chunk);
+        std::vector<uint16_t> labels;
+
+        labelChunk(chunk, labels);
+        for (int r = 0; r < area.rows; ++r)
+        {
+            const uint16_t *in = &labels[static_cast<size_t>(r) * area.cols];
+            uint8_t *out = &tiles[static_cast<size_t>(area.row + r) * width + area.col];
+            for (int c = 0; c < area.cols; ++c)
+            {
+                if (in[c] != 0 && !keep[firstGroup[chunk] + in[c] - 1])
+                    out[c] = GEN_WALL;
+            }
+        }
+    });
+}
+
+/**
+ * Getter for the map width
+ *
+ * @returns Tiles per row, 0 before a map is generated
+ */
+int MapGenerator::getWidth(void) const
+{
+    return width;
+}
+
+/**
+ * Getter for the map height
+ *
+ * @returns Rows, 0 before a map is generated
+ */
+int MapGenerator::getHeight(void) const
+{
+    return height;
+}
+
+/**
+ * Getter for the tiles
+ *
+ * @returns Tile types, row-major
+ */
+const std::vector<uint8_t> &MapGenerator::getTiles(void) const
+{
+    return tiles;
+}
+
+/**
+ * Palette for saving, tiles already hold their types so each maps to itself
+ *
+ * @returns One entry per tile type
+ */
+std::vector<MapPaletteEntry> MapGenerator::getPalette(void) const
+{
+    std::vector<MapPaletteEntry> palette(GEN_PIT + 1);
+
+    for (int i = 0; i <= GEN_PIT; ++i)
+    {
+        MapPaletteEntry entry = { static_cast<uint8_t>(i), { 0, 0, 0 } };
+        palette[i] = entry;
+    }
+    return palette;
+}
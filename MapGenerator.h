@@ -0,0 +1,98 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _MAPGENERATOR_
+#define _MAPGENERATOR_
+
+#include <stdint.h>
+#include <vector>
+#include "MapFile.h"
+
+// Tile types the generator writes, the same values as tileID
+#define GEN_TERRAIN 0
+#define GEN_WALL 1
+#define GEN_PIT 2
+
+// Tiles along each side of the squares the map is generated in, one per task
+#define GEN_CHUNK_SIZE 64
+
+// Tile the player spawns on, the middle of the first screen
+#define GEN_START_ROW 5
+#define GEN_START_COL 5
+
+// Smallest map that can be generated, enough to fit the start tile and a wall around it
+#define GEN_MIN_SIZE 12
+
+// Chance in percent that a cave cell starts out as wall, and smoothing passes after
+#define GEN_CAVE_FILL 45
+#define GEN_CAVE_PASSES 4
+
+// Rooms are split until both sides are under twice this, then get a room with a wall around it
+#define GEN_MIN_LEAF 10
+
+// Chance in percent of a pit on a room's floor
+#define GEN_PIT_CHANCE 2
+
+/**
+ * Procedural map generator
+ *
+ * The map is cut into GEN_CHUNK_SIZE squares that are each filled on their
+ * own, so they can be shared out between threads: either a cave grown with a
+ * cellular automaton or rooms laid out by binary space partitioning. Every
+ * square carves corridors from its middle to doors on the edges it shares
+ * with its neighbours, which the neighbour carves to as well. Finally any
+ * floor that can't be reached from the start tile is walled off.
+ *
+ * Every square draws its random numbers from its own seed, so the same seed
+ * gives the same map however many threads make it. Tiles use the TID_* types
+ * directly (0 terrain, 1 wall, 2 pit), like text maps.
+ *
+ * Kept free of SDL so maps can be generated and benchmarked without a renderer.
+ */
+class MapGenerator
+{
+public:
+    MapGenerator(void);
+
+    bool generate(int width, int height, uint64_t seed, int threads);
+    bool save(const char *path, bool chunked) const;
+
+    int getWidth(void) const;
+    int getHeight(void) const;
+    const std::vector<uint8_t> &getTiles(void) const;
+    std::vector<MapPaletteEntry> getPalette(void) const;
+
+private:
+    struct Rect
+    {
+        int row;
+        int col;
+        int rows;
+        int cols;
+    };
+
+    template <typename Task>
+    void forEachChunk(int threads, Task task);
+
+    Rect chunkRect(int chunk) const;
+    void fillChunk(int chunk);
+    void growCave(const Rect &area, uint64_t &rng);
+    void splitRooms(const Rect &area, uint64_t &rng, int &hubRow, int &hubCol);
+    void carveCorridor(int fromRow, int fromCol, int toRow, int toCol, bool rowsFirst);
+    void carveLine(int fromRow, int fromCol, int toRow, int toCol);
+    int doorOffset(int chunk, int side, int length) const;
+
+    int labelChunk(int chunk, std::vector<uint16_t> &labels) const;
+    void connect(int threads);
+
+    int width;
+    int height;
+    uint64_t seed;
+    int chunkColumns;
+    int chunkRows;
+    std::vector<uint8_t> tiles;
+};
+#endif
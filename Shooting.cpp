@@ -0,0 +1,166 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "Shooting.h"
+
+/**
+ * Fills in one projectile fired from a shot
+ *
+ * @param shot Projectile to fill in
+ * @param lifetime Ticks before the projectile disappears
+ * @param x X-coord the projectile starts at
+ * @param y Y-coord the projectile starts at
+ * @param direction Radians the projectile is aimed toward
+ * @param soulBullet True if fired by the soulgun
+ * @param move Projectile movement function
+ */
+static void aim(Projectile &shot, int lifetime, double x, double y, double direction, bool soulBullet, moveProjectileFunc move)
+{
+    shot.startx = x;
+    shot.starty = y;
+    shot.direction = direction;
+    shot.speed = 1; // control all bullet speeds from here
+    shot.lifetime = lifetime;
+    shot.power = 1;
+    shot.soulBullet = soulBullet;
+    shot.move = move;
+}
+
+/**
+ * Works out the spacing of an emitter's bursts for a shooter
+ *
+ * @param emitter Pattern emitter
+ * @param timer Shooter's cooldown length
+ * @returns Ticks between bursts, 0 if the emitter only fires once
+ */
+static int burstInterval(const PatternEmitter &emitter, int timer)
+{
+    if (emitter.divisor > 0)
+        return timer / emitter.divisor;
+    return emitter.interval;
+}
+
+/**
+ * Finds which burst of an emitter fires at a cooldown value
+ *
+ * @param emitter Pattern emitter
+ * @param timer Shooter's cooldown length
+ * @param cooldown Current cooldown value
+ * @returns Burst number, or -1 if the emitter doesn't fire
+ */
+static int burstAt(const PatternEmitter &emitter, int timer, int cooldown)
+{
+    int interval = burstInterval(emitter, timer);
+    int since = cooldown - emitter.at;
+
+    if (since < 0)
+        return -1;
+    if (interval <= 0)
+        return (since == 0) ? 0 : -1;
+    if (since % interval != 0)
+        return -1;
+    if (emitter.bursts > 0 && since / interval >= emitter.bursts)
+        return -1;
+    return since / interval;
+}
+
+/**
+ * Spawns a list of projectiles based on the shooter's bullet pattern
+ * The shooter's cooldown is counted down by the fire and player movement systems,
+ * every emitter whose burst lines up with the current cooldown fires
+ *
+ * @param shooter Shooter component, its cooldown is reset once it runs out
+ * @param pattern Bullet pattern of the shooter
+ * @param pos Position of the entity shooting
+ * @param aimDirection Radians toward the target
+ * @param soulBullet If true, this is a soul bullet (currently the only type of bullet the player fires)
+ * @param shots Array of at least MAX_SHOTS projectiles, filled with the projectiles fired
+ * @returns Number of projectiles fired
+ */
+int shoot(Shooter &shooter, const BulletPattern &pattern, Position pos, double aimDirection, bool soulBullet, Projectile *shots)
+{
+    moveProjectileFunc projectileMove = shooter.projectileMove;
+    double aposx = pos.x;
+    double aposy = pos.y;
+    int count = 0;
+
+    // adjust for function offsets
+    if (projectileMove == moveSine)
+    {
+        aposx += 50;
+        aposy -= 28;
+    }
+    if (projectileMove == moveCorkscrew)
+    {
+        aposx += 22;
+        aposy += 38;
+    }
+
+    // pick projectile lifetime based on movement function
+    int lifetime = 700;
+    if (projectileMove == moveSpiral
+        || projectileMove == moveCorkscrew
+        || projectileMove == moveBoomerang)
+        lifetime = 1200;
+
+    // A cooldown that ran out counts as the end of the cycle
+    int cooldown = (shooter.cooldown < 0) ? 0 : shooter.cooldown;
+
+    for (int e = 0; e < pattern.emitterCount; ++e)
+    {
+        const PatternEmitter &emitter = pattern.emitters[e];
+        int burst = burstAt(emitter, shooter.timer, cooldown);
+        if (burst < 0)
+            continue;
+
+        double base = (emitter.aimed ? aimDirection : 0) + burst * emitter.sweep;
+        for (int i = 0; i < emitter.angleCount && count < MAX_SHOTS; ++i)
+            aim(shots[count++], lifetime, aposx, aposy, base + pattern.angles[emitter.firstAngle + i], soulBullet, projectileMove);
+    }
+
+    if (shooter.cooldown <= 0)
+        shooter.cooldown = shooter.timer;
+    return count;
+}
+
+/**
+ * Works out how long until a shooter's pattern fires again
+ * Lets the fire system wake a shooter only when it has something to do,
+ * lowering the cooldown by the result before calling shoot() makes it fire
+ *
+ * @param shooter Shooter component
+ * @param pattern Bullet pattern of the shooter
+ * @returns Ticks until the next shot, at least 1
+ */
+int ticksToNextShot(const Shooter &shooter, const BulletPattern &pattern)
+{
+    int cooldown = shooter.cooldown;
+    int next = 0; // The cycle always ends at 0
+
+    if (cooldown <= 1)
+        return 1;
+
+    // Latest burst of each emitter before the current cooldown value
+    for (int e = 0; e < pattern.emitterCount; ++e)
+    {
+        const PatternEmitter &emitter = pattern.emitters[e];
+        int interval = burstInterval(emitter, shooter.timer);
+        int burst = 0;
+
+        if (cooldown - 1 < emitter.at)
+            continue;
+        if (interval > 0)
+            burst = (cooldown - 1 - emitter.at) / interval;
+        if (emitter.bursts > 0 && burst >= emitter.bursts)
+            burst = emitter.bursts - 1;
+
+        int at = emitter.at + burst * interval;
+        if (at > next)
+            next = at;
+    }
+
+    return cooldown - next;
+}
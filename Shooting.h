@@ -0,0 +1,21 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _SHOOTING_
+#define _SHOOTING_
+
+#include "Components.h"
+#include "BulletPattern.h"
+
+// Most projectiles a single shot can create
+#define MAX_SHOTS PATTERN_MAX_ANGLES
+
+// Fires a shooter's projectiles if its cooldown allows
+int shoot(Shooter &shooter, const BulletPattern &pattern, Position pos, double aimDirection, bool soulBullet, Projectile *shots);
+
+// Ticks until a shooter's pattern fires again
+int ticksToNextShot(const Shooter &shooter, const BulletPattern &pattern);
+#endif
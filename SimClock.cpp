@@ -0,0 +1,162 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "SimClock.h"
+#include "SplitMix.h"
+#include <thread>
+#include <time.h>
+
+/**
+ * Constructor, starts at tick 0 in real time
+ */
+SimClock::SimClock(void):
+    mode(CM_REAL_TIME),
+    scale(1),
+    ticks(0),
+    seed(time(NULL)),
+    randomState(seed),
+    paced(false)
+{
+}
+
+/**
+ * Paces frames at normal speed
+ */
+void SimClock::setRealTime(void)
+{
+    mode = CM_REAL_TIME;
+    scale = 1;
+    paced = false;
+}
+
+/**
+ * Paces frames faster or slower than normal
+ *
+ * @param speed Simulated time per real time, clamped to SIM_MIN_SCALE to SIM_MAX_SCALE
+ */
+void SimClock::setScale(double speed)
+{
+    if (speed < SIM_MIN_SCALE)
+        speed = SIM_MIN_SCALE;
+    if (speed > SIM_MAX_SCALE)
+        speed = SIM_MAX_SCALE;
+
+    mode = (speed == 1) ? CM_REAL_TIME : CM_SCALED;
+    scale = speed;
+    paced = false;
+}
+
+/**
+ * Stops pacing frames, every frame starts as soon as the last one ends
+ */
+void SimClock::setUnlimited(void)
+{
+    mode = CM_UNLIMITED;
+    scale = 0;
+    paced = false;
+}
+
+/**
+ * Getter for the pacing mode
+ *
+ * @returns Real time, scaled or unlimited
+ */
+ClockMode SimClock::getMode(void) const
+{
+    return mode;
+}
+
+/**
+ * Getter for the speed
+ *
+ * @returns Simulated time per real time, 0 when unlimited
+ */
+double SimClock::getScale(void) const
+{
+    return scale;
+}
+
+/**
+ * Steps simulated time by one tick, call once per simulation step
+ */
+void SimClock::advance(void)
+{
+    ++ticks;
+}
+
+/**
+ * Waits until the next frame is due in real time, call once per frame
+ * A frame that runs late pushes the ones after it back rather than having them rush to catch up
+ */
+void SimClock::pace(void)
+{
+    if (mode == CM_UNLIMITED)
+        return;
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(SIM_TICK_MS / scale));
+
+    if (paced && now < nextFrame)
+    {
+        std::this_thread::sleep_until(nextFrame);
+        nextFrame += period;
+    }
+    else
+        nextFrame = now + period;
+    paced = true;
+}
+
+/**
+ * Getter for the ticks stepped
+ *
+ * @returns Ticks since the clock was created
+ */
+uint64_t SimClock::getTicks(void) const
+{
+    return ticks;
+}
+
+/**
+ * Getter for the simulated time
+ *
+ * @returns Simulated milliseconds since the clock was created
+ */
+uint64_t SimClock::getMs(void) const
+{
+    return ticks * SIM_TICK_MS;
+}
+
+/**
+ * Sets the seed for the simulation's random numbers, for runs that must repeat
+ *
+ * @param value Seed to use from now on
+ */
+void SimClock::setSeed(uint32_t value)
+{
+    seed = value;
+    randomState = value;
+}
+
+/**
+ * Getter for the seed for the simulation's random numbers
+ *
+ * @returns Seed set with setSeed, or the wall clock time the clock was created at
+ */
+uint32_t SimClock::getSeed(void) const
+{
+    return seed;
+}
+
+/**
+ * Draws the simulation's next random number, in place of rand()
+ *
+ * @returns Number from 0 to INT32_MAX
+ */
+int SimClock::nextRandom(void)
+{
+    return static_cast<int>(splitMix64(randomState) >> 33);
+}
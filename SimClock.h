@@ -0,0 +1,71 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _SIMCLOCK_
+#define _SIMCLOCK_
+
+#include <chrono>
+#include <stdint.h>
+
+// Simulated milliseconds per tick, and real milliseconds per frame at normal speed
+#define SIM_TICK_MS 15
+
+// Range of speeds the clock can be scaled to
+#define SIM_MIN_SCALE 0.25
+#define SIM_MAX_SCALE 100.0
+
+// How the clock paces frames against real time
+enum ClockMode
+{
+    CM_REAL_TIME, // One tick per SIM_TICK_MS of real time
+    CM_SCALED,    // Real time sped up or slowed down by the scale
+    CM_UNLIMITED, // No waiting at all, as fast as the machine goes
+};
+
+/**
+ * Virtual clock for the simulation
+ *
+ * Simulated time only moves when a tick is stepped, by SIM_TICK_MS each
+ * time, so gameplay reads the same times whatever speed the game runs at.
+ * Separately the clock paces frames against real time: at normal speed,
+ * scaled between SIM_MIN_SCALE and SIM_MAX_SCALE, or not at all.
+ *
+ * Gameplay code reads time and random numbers from here rather than from SDL
+ * and rand(), so every clock is its own repeatable simulation and many can
+ * run side by side on different threads. Kept free of SDL so headless runs
+ * can use it.
+ */
+class SimClock
+{
+public:
+    SimClock(void);
+
+    void setRealTime(void);
+    void setScale(double speed);
+    void setUnlimited(void);
+    ClockMode getMode(void) const;
+    double getScale(void) const;
+
+    void advance(void);
+    void pace(void);
+
+    uint64_t getTicks(void) const;
+    uint64_t getMs(void) const;
+
+    void setSeed(uint32_t value);
+    uint32_t getSeed(void) const;
+    int nextRandom(void);
+
+private:
+    ClockMode mode;
+    double scale;     // Simulated time per real time, 1 in real time and 0 when unlimited
+    uint64_t ticks;   // Ticks stepped so far
+    uint32_t seed;    // Seed for the simulation's random numbers, the wall clock unless set
+    uint64_t randomState; // splitmix64 generator state, starts at the seed
+    bool paced;       // A frame has been paced, so nextFrame means something
+    std::chrono::steady_clock::time_point nextFrame; // When the next frame is due in real time
+};
+#endif
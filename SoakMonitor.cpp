@@ -0,0 +1,338 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "SoakMonitor.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+// Counted by the replacement operator new and delete below, zero before anything else is constructed
+static std::atomic<uint64_t> allocationCount(0);
+static std::atomic<uint64_t> freeCount(0);
+
+/**
+ * Allocates and counts, for the replacement operator new below
+ *
+ * @param size Bytes wanted
+ * @returns The memory, NULL if there is none
+ */
+static void *countedAlloc(size_t size)
+{
+    void *memory = malloc(size == 0 ? 1 : size);
+    if (memory != NULL)
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return memory;
+}
+
+/**
+ * Frees and counts, for the replacement operator delete below
+ *
+ * @param memory Memory from countedAlloc, or NULL
+ */
+static void countedFree(void *memory)
+{
+    if (memory == NULL)
+        return;
+    freeCount.fetch_add(1, std::memory_order_relaxed);
+    free(memory);
+}
+
+// Replacements for every form of the global operator new and delete but the aligned ones, so all allocations are counted
+void *operator new(size_t size)
+{
+    void *memory = countedAlloc(size);
+    if (memory == NULL)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void *operator new[](size_t size)
+{
+    void *memory = countedAlloc(size);
+    if (memory == NULL)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size); }
+void operator delete(void *memory) noexcept { countedFree(memory); }
+void operator delete[](void *memory) noexcept { countedFree(memory); }
+void operator delete(void *memory, size_t) noexcept { countedFree(memory); }
+void operator delete[](void *memory, size_t) noexcept { countedFree(memory); }
+void operator delete(void *memory, const std::nothrow_t &) noexcept { countedFree(memory); }
+void operator delete[](void *memory, const std::nothrow_t &) noexcept { countedFree(memory); }
+
+/**
+ * Constructor, the soak is timed from here
+ *
+ * @param seconds Wall time to run for, 0 to run until quit
+ * @param interval Wall time between samples
+ * @param csvPath File the samples are written to, replaced if it exists
+ */
+SoakMonitor::SoakMonitor(double seconds, double interval, const char *csvPath):
+    seconds(seconds),
+    interval(interval > 0 ? interval : SOAK_INTERVAL),
+    frames(0),
+    csv(csvPath)
+{
+    started = std::chrono::steady_clock::now();
+    frameStarted = started;
+    nextSample = this->interval;
+    frameMs.reserve(4096);
+
+    if (!csv)
+        std::cout << "Soak: can't write " << csvPath << ", samples will only be judged" << std::endl;
+
+    // Say so now rather than hours later when the samples can't be judged
+    size_t planned = static_cast<size_t>(seconds / this->interval);
+    if (seconds > 0 && planned < getWarmupCount(planned) + SOAK_MIN_SAMPLES)
+        std::cout << "Soak: only " << planned << " samples in " << seconds << " s, too few to judge, "
+            << "use a longer --soak-time or a shorter --soak-interval" << std::endl;
+    csv << "seconds,frames,runs,rss_kb,allocations,frees,live_allocations,entities,projectiles,"
+        << "entity_capacity,projectile_capacity,slot_capacity,p99_frame_ms,max_frame_ms" << std::endl;
+}
+
+/**
+ * Marks the start of a frame's work, call after waiting for the frame to be due
+ */
+void SoakMonitor::startFrame(void)
+{
+    frameStarted = std::chrono::steady_clock::now();
+}
+
+/**
+ * Marks the end of a frame's work and takes a sample if one is due
+ *
+ * @param dispMan Display manager holding the entities
+ * @param runs Runs started so far
+ */
+void SoakMonitor::endFrame(DisplayManager *dispMan, int runs)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    frameMs.push_back(std::chrono::duration<double, std::milli>(now - frameStarted).count());
+    ++frames;
+
+    if (std::chrono::duration<double>(now - started).count() >= nextSample)
+    {
+        sample(dispMan, runs);
+        nextSample += interval;
+    }
+}
+
+/**
+ * Indicates whether the soak has run for as long as it was asked to
+ *
+ * @returns True once the wall time is up, never when running until quit
+ */
+bool SoakMonitor::isFinished(void) const
+{
+    return seconds > 0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count() >= seconds;
+}
+
+/**
+ * Judges the trends of the samples taken and prints the verdict
+ *
+ * @returns SOAK_PASSED, SOAK_GREW if anything grew past its limit, or
+ *          SOAK_UNJUDGED if there were too few samples to tell
+ */
+int SoakMonitor::finish(void)
+{
+    std::vector<double> rss, live, frame;
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        rss.push_back(samples[i].rssKB);
+        live.push_back(static_cast<double>(samples[i].allocations - samples[i].frees));
+        frame.push_back(samples[i].p99FrameMs);
+    }
+
+    std::cout << "Soak: " << frames << " frames, " << samples.size() << " samples" << std::endl;
+    int verdicts[3];
+    verdicts[0] = judge("resident memory", rss, SOAK_MAX_RSS_GROWTH, 0);
+    verdicts[1] = judge("live allocations", live, SOAK_MAX_LIVE_ALLOC_GROWTH, 0);
+    verdicts[2] = judge("p99 frame time", frame, SOAK_MAX_FRAME_GROWTH, SOAK_MIN_FRAME_GROWTH_MS);
+
+    // Growth is the stronger verdict, it was seen rather than not ruled out
+    int verdict = SOAK_PASSED;
+    for (int i = 0; i < 3; ++i)
+    {
+        if (verdicts[i] == SOAK_GREW || (verdicts[i] == SOAK_UNJUDGED && verdict == SOAK_PASSED))
+            verdict = verdicts[i];
+    }
+
+    if (verdict == SOAK_PASSED)
+        std::cout << "Soak passed" << std::endl;
+    else if (verdict == SOAK_GREW)
+        std::cout << "Soak FAILED" << std::endl;
+    else
+        std::cout << "Soak FAILED, too few samples to judge" << std::endl;
+    return verdict;
+}
+
+/**
+ * Measures the memory the process has resident
+ *
+ * @returns Resident kilobytes, 0 where it can't be measured
+ */
+size_t SoakMonitor::getResidentKB(void)
+{
+#if defined(__linux__)
+    long pages = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm == NULL)
+        return 0;
+    if (fscanf(statm, "%*s %ld", &pages) != 1)
+        pages = 0;
+    fclose(statm);
+    return static_cast<size_t>(pages) * sysconf(_SC_PAGESIZE) / 1024;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+        return 0;
+    return info.resident_size / 1024;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Getter for the allocations made
+ *
+ * @returns Calls to operator new since the program started
+ */
+uint64_t SoakMonitor::getAllocationCount(void)
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * Getter for the allocations freed
+ *
+ * @returns Calls to operator delete since the program started
+ */
+uint64_t SoakMonitor::getFreeCount(void)
+{
+    return freeCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * Samples everything watched and appends it to the CSV
+ *
+ * @param dispMan Display manager holding the entities
+ * @param runs Runs started so far
+ */
+void SoakMonitor::sample(DisplayManager *dispMan, int runs)
+{
+    World *world = dispMan->getWorld();
+    std::vector<Archetype *> &archetypes = world->getArchetypes();
+    SoakSample s;
+
+    s.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    s.frames = frames;
+    s.runs = runs;
+    s.rssKB = getResidentKB();
+    s.allocations = getAllocationCount();
+    s.frees = getFreeCount();
+    s.entities = world->getEntityCount();
+    s.projectiles = 0;
+    s.entityCapacity = 0;
+    s.projectileCapacity = 0;
+    s.slotCapacity = world->getSlotCapacity();
+    for (size_t a = 0; a < archetypes.size(); ++a)
+    {
+        if (archetypes[a]->has(CB_PROJECTILE))
+        {
+            s.projectiles += archetypes[a]->size();
+            s.projectileCapacity += archetypes[a]->getCapacity();
+        }
+        else
+            s.entityCapacity += archetypes[a]->getCapacity();
+    }
+
+    // Frame times are only needed in order for the percentile, and are started over after each sample
+    s.p99FrameMs = 0;
+    s.maxFrameMs = 0;
+    if (!frameMs.empty())
+    {
+        size_t p99 = frameMs.size() * 99 / 100;
+        std::nth_element(frameMs.begin(), frameMs.begin() + p99, frameMs.end());
+        s.p99FrameMs = frameMs[p99];
+        s.maxFrameMs = *std::max_element(frameMs.begin(), frameMs.end());
+    }
+    frameMs.clear();
+
+    samples.push_back(s);
+    csv << s.seconds << ',' << s.frames << ',' << s.runs << ',' << s.rssKB << ',' << s.allocations << ','
+        << s.frees << ',' << s.allocations - s.frees << ',' << s.entities << ',' << s.projectiles << ','
+        << s.entityCapacity << ',' << s.projectileCapacity << ',' << s.slotCapacity << ','
+        << s.p99FrameMs << ',' << s.maxFrameMs << std::endl;
+}
+
+/**
+ * Counts the samples at the start that are left out of the trends
+ *
+ * @param count Samples taken
+ * @returns Samples in the warm-up, at least one
+ */
+size_t SoakMonitor::getWarmupCount(size_t count)
+{
+    size_t first = static_cast<size_t>(count * SOAK_WARMUP_FRACTION);
+    return (first < 1) ? 1 : first;
+}
+
+/**
+ * Fits a line through one value over the samples after the warm-up and
+ * checks how much it grew along it
+ *
+ * @param what Name of the value, for the verdict
+ * @param values The value at every sample
+ * @param maxGrowth Growth allowed as a share of where the line starts
+ * @param minGrowth Growth below this always passes
+ * @returns SOAK_PASSED if it grew no more than allowed, SOAK_GREW if it grew
+ *          more, SOAK_UNJUDGED if there weren't enough samples to tell
+ */
+int SoakMonitor::judge(const char *what, const std::vector<double> &values, double maxGrowth, double minGrowth)
+{
+    size_t first = getWarmupCount(values.size());
+    if (values.size() < first + SOAK_MIN_SAMPLES)
+    {
+        std::cout << "  " << what << ": " << values.size() << " samples, too few to judge" << std::endl;
+        return SOAK_UNJUDGED;
+    }
+
+    // Least squares over time
+    double n = values.size() - first;
+    double sumT = 0, sumV = 0, sumTT = 0, sumTV = 0;
+    for (size_t i = first; i < values.size(); ++i)
+    {
+        double t = samples[i].seconds;
+        sumT += t;
+        sumV += values[i];
+        sumTT += t * t;
+        sumTV += t * values[i];
+    }
+    double spread = n * sumTT - sumT * sumT;
+    double slope = (spread > 0) ? (n * sumTV - sumT * sumV) / spread : 0;
+    double startT = samples[first].seconds;
+    double start = (sumV - slope * sumT) / n + slope * startT;
+    double growth = slope * (samples.back().seconds - startT);
+    double share = (start > 0) ? growth / start : 0;
+    bool passed = growth <= minGrowth || share <= maxGrowth;
+
+    std::cout << "  " << what << ": " << start << " growing by " << growth << " (" << share * 100 << "%, limit "
+        << maxGrowth * 100 << "%) " << (passed ? "ok" : "TOO MUCH") << std::endl;
+    return passed ? SOAK_PASSED : SOAK_GREW;
+}
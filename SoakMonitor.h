@@ -0,0 +1,104 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _SOAKMONITOR_
+#define _SOAKMONITOR_
+
+#include <chrono>
+#include <fstream>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "DisplayManager.h"
+
+// Seconds between samples unless set with --soak-interval
+#define SOAK_INTERVAL 10
+
+// Where samples go unless set with --soak-csv
+#define SOAK_CSV_PATH "soak.csv"
+
+// Share of the samples at the start left out of the trends, while storage grows to its working size
+#define SOAK_WARMUP_FRACTION 0.2
+
+// Fewest samples after the warm-up needed to judge a trend
+#define SOAK_MIN_SAMPLES 4
+
+// Growth allowed along each fitted trend line, from the end of the warm-up to the last sample
+#define SOAK_MAX_RSS_GROWTH 0.10        // Share of resident memory
+#define SOAK_MAX_LIVE_ALLOC_GROWTH 0.10 // Share of allocations not yet freed
+#define SOAK_MAX_FRAME_GROWTH 0.25      // Share of the 99th percentile frame time
+#define SOAK_MIN_FRAME_GROWTH_MS 0.5    // Frame time growing by less than this is noise, whatever its share
+
+// Verdicts of a soak, used as the game's exit status
+#define SOAK_PASSED 0     // Nothing grew past its limit
+#define SOAK_GREW 1       // Something grew past its limit
+#define SOAK_UNJUDGED 2   // Too few samples to tell, the soak was too short for its interval
+
+/**
+ * One row of the soak CSV
+ */
+struct SoakSample
+{
+    double seconds;            // Wall time since the soak started
+    uint64_t frames;           // Frames so far
+    int runs;                  // Runs started so far
+    size_t rssKB;              // Resident memory
+    uint64_t allocations;      // Calls to operator new so far
+    uint64_t frees;            // Calls to operator delete so far
+    size_t entities;           // Live entities, projectiles included
+    size_t projectiles;        // Live projectiles
+    size_t entityCapacity;     // Rows allocated for entities other than projectiles
+    size_t projectileCapacity; // Rows allocated for projectiles
+    size_t slotCapacity;       // Entity slots allocated
+    double p99FrameMs;         // 99th percentile frame time since the last sample
+    double maxFrameMs;         // Longest frame since the last sample
+};
+
+/**
+ * Watches a long unattended session for leaks and slowdowns
+ *
+ * Every interval it samples resident memory, allocation counts, live
+ * entities and projectiles, the capacity of their storage and the frame
+ * times since the last sample, and appends a row to a CSV file. When the
+ * soak ends it fits a line through each of resident memory, live
+ * allocations and the 99th percentile frame time, leaving out the warm-up,
+ * and fails if any of them grew past its limit. A soak too short to take
+ * enough samples fails too, with its own verdict, rather than passing
+ * without having checked anything.
+ *
+ * Allocations are counted by replacing the global operator new and delete,
+ * so they are counted whether or not a soak is running.
+ */
+class SoakMonitor
+{
+public:
+    SoakMonitor(double seconds, double interval, const char *csvPath);
+
+    void startFrame(void);
+    void endFrame(DisplayManager *dispMan, int runs);
+    bool isFinished(void) const;
+    int finish(void);
+
+    static size_t getResidentKB(void);
+    static uint64_t getAllocationCount(void);
+    static uint64_t getFreeCount(void);
+
+private:
+    void sample(DisplayManager *dispMan, int runs);
+    int judge(const char *what, const std::vector<double> &values, double maxGrowth, double minGrowth);
+    static size_t getWarmupCount(size_t count);
+
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point frameStarted;
+    double seconds;             // Wall time to run for, 0 to run until quit
+    double interval;            // Wall time between samples
+    double nextSample;          // Wall time the next sample is due
+    uint64_t frames;
+    std::vector<double> frameMs; // Frame times since the last sample
+    std::vector<SoakSample> samples;
+    std::ofstream csv;
+};
+#endif
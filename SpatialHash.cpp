@@ -0,0 +1,147 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "SpatialHash.h"
+
+/**
+ * Constructor, starts empty
+ *
+ * @param cellSize Width and height of a cell in pixels, about the usual query radius works best
+ */
+SpatialHash::SpatialHash(int cellSize):
+    cellSize(cellSize),
+    count(0),
+    buckets(SPATIAL_HASH_BUCKETS)
+{
+}
+
+/**
+ * Removes every point, keeping the allocated space
+ */
+void SpatialHash::clear(void)
+{
+    for (size_t i = 0; i < used.size(); ++i)
+        buckets[used[i]].clear();
+    used.clear();
+    count = 0;
+}
+
+/**
+ * Adds a point
+ *
+ * @param id Identifier handed back by queries
+ * @param pos Position of the point
+ */
+void SpatialHash::insert(int id, Position pos)
+{
+    SpatialEntry entry = { pos, id, cellOf(pos.x), cellOf(pos.y) };
+    std::vector<SpatialEntry> &bucket = buckets[bucketOf(entry.cellX, entry.cellY)];
+
+    if (bucket.empty())
+        used.push_back(bucketOf(entry.cellX, entry.cellY));
+    bucket.push_back(entry);
+    ++count;
+}
+
+/**
+ * Finds every point within a distance of a position
+ *
+ * @param center Position to search around
+ * @param radius Points closer than this are found
+ * @param found Receives the points, cleared first
+ */
+void SpatialHash::query(Position center, double radius, std::vector<SpatialEntry> &found) const
+{
+    int minX = cellOf(center.x - radius);
+    int maxX = cellOf(center.x + radius);
+    int minY = cellOf(center.y - radius);
+    int maxY = cellOf(center.y + radius);
+    double radiusSq = radius * radius;
+
+    found.clear();
+    for (int cy = minY; cy <= maxY; ++cy)
+    {
+        for (int cx = minX; cx <= maxX; ++cx)
+        {
+            const std::vector<SpatialEntry> &bucket = buckets[bucketOf(cx, cy)];
+            for (size_t i = 0; i < bucket.size(); ++i)
+            {
+                const SpatialEntry &entry = bucket[i];
+                double dx = entry.pos.x - center.x;
+                double dy = entry.pos.y - center.y;
+                if (entry.cellX == cx && entry.cellY == cy && dx * dx + dy * dy < radiusSq)
+                    found.push_back(entry);
+            }
+        }
+    }
+}
+
+/**
+ * Checks for any point within a distance of a position
+ *
+ * @param center Position to search around
+ * @param radius Points closer than this count
+ * @returns True if there is at least one such point
+ */
+bool SpatialHash::any(Position center, double radius) const
+{
+    int minX = cellOf(center.x - radius);
+    int maxX = cellOf(center.x + radius);
+    int minY = cellOf(center.y - radius);
+    int maxY = cellOf(center.y + radius);
+    double radiusSq = radius * radius;
+
+    for (int cy = minY; cy <= maxY; ++cy)
+    {
+        for (int cx = minX; cx <= maxX; ++cx)
+        {
+            const std::vector<SpatialEntry> &bucket = buckets[bucketOf(cx, cy)];
+            for (size_t i = 0; i < bucket.size(); ++i)
+            {
+                double dx = bucket[i].pos.x - center.x;
+                double dy = bucket[i].pos.y - center.y;
+                if (dx * dx + dy * dy < radiusSq)
+                    return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Getter for the number of points
+ *
+ * @returns Points inserted since the last clear
+ */
+size_t SpatialHash::size(void) const
+{
+    return count;
+}
+
+/**
+ * Finds the cell a coordinate falls in, rounding down for negative coordinates too
+ *
+ * @param coord X or Y coordinate in pixels
+ * @returns Cell coordinate
+ */
+int SpatialHash::cellOf(double coord) const
+{
+    return static_cast<int>(floor(coord / cellSize));
+}
+
+/**
+ * Hashes a cell to a bucket
+ *
+ * @param cellX Cell column
+ * @param cellY Cell row
+ * @returns Bucket index
+ */
+int SpatialHash::bucketOf(int cellX, int cellY)
+{
+    unsigned int hash = static_cast<unsigned int>(cellX) * 73856093u ^ static_cast<unsigned int>(cellY) * 19349663u;
+    return hash & (SPATIAL_HASH_BUCKETS - 1);
+}
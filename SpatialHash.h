@@ -0,0 +1,53 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _SPATIALHASH_
+#define _SPATIALHASH_
+
+#include <vector>
+#include "movement.h"
+
+// Number of buckets cells are hashed into, a power of two
+#define SPATIAL_HASH_BUCKETS 4096
+
+// A point stored in the hash
+struct SpatialEntry
+{
+    Position pos;
+    int id;      // Caller's identifier for the point
+    int cellX;   // Cell the point is in, told apart from other cells sharing the bucket
+    int cellY;
+};
+
+/**
+ * Uniform grid of points, hashed so it covers any area without sizing it
+ *
+ * Radius queries only look at the cells the circle touches, so their cost
+ * depends on how many points are nearby rather than how many there are in
+ * total. Clearing only empties the buckets that were used.
+ */
+class SpatialHash
+{
+public:
+    SpatialHash(int cellSize);
+
+    void clear(void);
+    void insert(int id, Position pos);
+
+    void query(Position center, double radius, std::vector<SpatialEntry> &found) const;
+    bool any(Position center, double radius) const;
+    size_t size(void) const;
+
+private:
+    int cellOf(double coord) const;
+    static int bucketOf(int cellX, int cellY);
+
+    int cellSize;
+    size_t count;
+    std::vector<std::vector<SpatialEntry> > buckets;
+    std::vector<int> used; // Buckets holding at least one point
+};
+#endif
@@ -0,0 +1,229 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "SpawnDirector.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+
+/**
+ * Constructor, starts with the built-in wave table
+ */
+SpawnDirector::SpawnDirector(void)
+{
+    clearCounts();
+    useDefaultWaves();
+}
+
+/**
+ * Loads a spawn wave table, replacing the current one
+ *
+ * Each non-comment line holds one wave:
+ * start interval step min_interval reset_interval batch human% max_pop min_pop
+ *
+ * @param path Path to the wave table
+ * @returns False if the file could not be used (the built-in waves are kept)
+ */
+bool SpawnDirector::loadWaves(const char *path)
+{
+    std::ifstream waveFile(path);
+    std::vector<SpawnWave> loaded;
+    std::string line;
+
+    if (!waveFile.is_open())
+    {
+        std::cout << "Spawn wave file failed to load" << std::endl;
+        return false;
+    }
+
+    while (std::getline(waveFile, line))
+    {
+        // Strip comments and skip blank lines
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        std::istringstream row(line);
+        SpawnWave w;
+        row >> w.startTick >> w.interval >> w.intervalStep >> w.minInterval >> w.resetInterval
+            >> w.batchSize >> w.humanChance >> w.maxPopulation >> w.minPopulation;
+
+        if (row.fail() || w.startTick < 0 || w.batchSize < 0 || w.interval < 0)
+        {
+            std::cout << "Bad spawn wave: " << line << std::endl;
+            return false;
+        }
+        loaded.push_back(w);
+    }
+
+    if (loaded.empty())
+    {
+        std::cout << "Spawn wave file has no waves" << std::endl;
+        return false;
+    }
+
+    std::stable_sort(loaded.begin(), loaded.end(),
+        [](const SpawnWave &a, const SpawnWave &b) { return a.startTick < b.startTick; });
+    waves = loaded;
+    reset();
+    return true;
+}
+
+/**
+ * Restarts the wave table from the beginning (population counts are kept)
+ */
+void SpawnDirector::reset(void)
+{
+    startWave(0, 0);
+}
+
+/**
+ * Forgets every entity, for when they were all removed at once
+ */
+void SpawnDirector::clearCounts(void)
+{
+    for (int i = 0; i < ET_TOTAL; ++i)
+        counts[i] = 0;
+}
+
+/**
+ * Records that an entity is now being managed
+ *
+ * @param type Type of the entity that was added
+ */
+void SpawnDirector::onAdd(EntityType type)
+{
+    ++counts[type];
+}
+
+/**
+ * Records that an entity is no longer being managed
+ *
+ * @param type Type of the entity that was removed
+ */
+void SpawnDirector::onRemove(EntityType type)
+{
+    if (counts[type] > 0)
+        --counts[type];
+}
+
+/**
+ * Getter for the population of one entity type
+ *
+ * @param type Entity type to count
+ * @returns Number of managed entities of this type
+ */
+int SpawnDirector::getCount(EntityType type)
+{
+    return counts[type];
+}
+
+/**
+ * Getter for the number of enemies alive
+ *
+ * @returns Number of humans and robots
+ */
+int SpawnDirector::getEnemyCount(void)
+{
+    return counts[ET_HUMAN] + counts[ET_ROBOT];
+}
+
+/**
+ * Decides which enemies should spawn on this tick
+ *
+ * @param tick Current sim tick
+ * @param requests Array of at least SPAWN_MAX_BATCH entries to fill
+ * @param clock Simulation clock, draws the random numbers
+ * @returns Number of requests written
+ */
+int SpawnDirector::update(int tick, SpawnRequest *requests, SimClock *clock)
+{
+    while (waveIndex + 1 < static_cast<int>(waves.size()) && waves[waveIndex + 1].startTick <= tick)
+        startWave(waveIndex + 1, tick);
+
+    const SpawnWave &w = waves[waveIndex];
+    int enemies = getEnemyCount();
+    int spawned = 0;
+
+    // Nearly empty, refill straight away with enemies the player can learn on
+    if (enemies < w.minPopulation)
+    {
+        while (enemies + spawned < w.minPopulation && spawned < SPAWN_MAX_BATCH)
+        {
+            requests[spawned].type = ET_ROBOT;
+            requests[spawned].basic = true;
+            ++spawned;
+        }
+
+        // The refill counts as a spawn, so a timed batch doesn't land right on top of it
+        nextSpawnTick = tick + interval;
+        return spawned;
+    }
+
+    if (tick < nextSpawnTick)
+        return 0;
+
+    // Keep the number of spawns constrained
+    if (enemies >= w.maxPopulation)
+    {
+        nextSpawnTick = tick + SPAWN_RETRY_TICKS;
+        return 0;
+    }
+
+    int batch = std::min(w.batchSize, w.maxPopulation - enemies);
+    batch = std::min(batch, SPAWN_MAX_BATCH);
+    for (; spawned < batch; ++spawned)
+    {
+        requests[spawned].type = (clock->nextRandom() % 100 < w.humanChance) ? ET_HUMAN : ET_ROBOT;
+        requests[spawned].basic = false;
+    }
+
+    // Spawn at a generally increasing rate
+    nextSpawnTick = tick + interval;
+    interval -= w.intervalStep;
+    if (interval < w.minInterval)
+        interval = w.resetInterval;
+
+    return spawned;
+}
+
+/**
+ * Wave table used when no file is available, matches the original spawn pacing
+ */
+void SpawnDirector::useDefaultWaves(void)
+{
+    SpawnWave w;
+    w.startTick = 0;
+    w.interval = 1000;
+    w.intervalStep = 15;
+    w.minInterval = 500;
+    w.resetInterval = 600;
+    w.batchSize = 1;
+    w.humanChance = 25;
+    w.maxPopulation = 40;
+    w.minPopulation = 2;
+
+    waves.clear();
+    waves.push_back(w);
+    reset();
+}
+
+/**
+ * Hands control to a wave
+ *
+ * @param index Index of the wave in the table
+ * @param tick Sim tick the wave is starting on
+ */
+void SpawnDirector::startWave(int index, int tick)
+{
+    waveIndex = index;
+    interval = waves[index].interval;
+    nextSpawnTick = tick + interval;
+}
@@ -0,0 +1,82 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _SPAWNDIRECTOR_
+#define _SPAWNDIRECTOR_
+
+#include <vector>
+#include "Components.h"
+#include "SimClock.h"
+
+// Default location of the spawn wave table
+#define SPAWN_WAVE_PATH "assets/spawns/waves.txt"
+
+// Ticks to wait before trying again when the population is capped
+#define SPAWN_RETRY_TICKS 50
+
+// Most spawns that can be requested in a single tick
+#define SPAWN_MAX_BATCH 64
+
+/**
+ * One row of the spawn wave table
+ *
+ * A wave takes over once the simulation reaches its start tick and stays
+ * in control until the next wave starts
+ */
+struct SpawnWave
+{
+    int startTick;     // Sim tick this wave takes over
+    int interval;      // Ticks between spawns when the wave starts
+    int intervalStep;  // Ticks removed from the interval after each spawn
+    int minInterval;   // Once the interval drops below this...
+    int resetInterval; // ...it is set back to this
+    int batchSize;     // Enemies spawned each time the interval elapses
+    int humanChance;   // Percent chance that a spawn is a human instead of a robot
+    int maxPopulation; // No new spawns while this many enemies are alive
+    int minPopulation; // Below this many enemies, basic robots are spawned immediately
+};
+
+// A single spawn the director wants this tick
+struct SpawnRequest
+{
+    EntityType type;
+    bool basic; // If true, spawn with the simplest shooting so the player can learn
+};
+
+/**
+ * Decides when and what enemies spawn
+ *
+ * Population counts are kept up to date as entities are added and removed,
+ * so deciding whether to spawn never has to look at the entities themselves
+ */
+class SpawnDirector
+{
+public:
+    SpawnDirector(void);
+
+    bool loadWaves(const char *path);
+    void reset(void);
+    void clearCounts(void);
+
+    void onAdd(EntityType type);
+    void onRemove(EntityType type);
+    int getCount(EntityType type);
+    int getEnemyCount(void);
+
+    int update(int tick, SpawnRequest *requests, SimClock *clock);
+
+private:
+    void useDefaultWaves(void);
+    void startWave(int index, int tick);
+
+    std::vector<SpawnWave> waves;
+    int counts[ET_TOTAL];
+
+    int waveIndex;     // Index of the wave currently in control
+    int interval;      // Current ticks between spawns
+    int nextSpawnTick; // Sim tick of the next scheduled spawn
+};
+#endif
@@ -0,0 +1,26 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _SPLITMIX_
+#define _SPLITMIX_
+
+#include <stdint.h>
+
+/**
+ * Steps a splitmix64 generator, small and fast enough to keep one per
+ * simulation or per map square, and the same on every platform
+ *
+ * @param state Generator state, advanced
+ * @returns 64 random bits
+ */
+inline uint64_t splitMix64(uint64_t &state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+#endif
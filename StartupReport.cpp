@@ -0,0 +1,91 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "StartupReport.h"
+#include <iomanip>
+#include <iostream>
+
+/**
+ * Constructor, startup is timed from here
+ */
+StartupReport::StartupReport(void)
+{
+    started = std::chrono::steady_clock::now();
+    lastPhase = started;
+}
+
+/**
+ * Ends a phase on the main thread, which began where the last one ended
+ *
+ * @param name What the phase did
+ */
+void StartupReport::phase(const char *name)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    StartupPhase done = { name, std::chrono::duration<double, std::milli>(now - lastPhase).count() };
+
+    phases.push_back(done);
+    lastPhase = now;
+}
+
+/**
+ * Wraps a task for the thread pool so it times itself
+ *
+ * @param name What the task does
+ * @param task The work itself
+ * @returns Task that runs the work and adds it to the report
+ */
+std::function<void(void)> StartupReport::timed(const char *name, std::function<void(void)> task)
+{
+    std::string label = name;
+    return [this, label, task] {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        task();
+        addTask(label, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+    };
+}
+
+/**
+ * Getter for the time startup has taken
+ *
+ * @returns Milliseconds from construction to the end of the last phase
+ */
+double StartupReport::getTotalMs(void) const
+{
+    return std::chrono::duration<double, std::milli>(lastPhase - started).count();
+}
+
+/**
+ * Prints every phase and task with how long it took
+ */
+void StartupReport::print(void)
+{
+    std::lock_guard<std::mutex> guard(taskLock);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Started in " << getTotalMs() << " ms" << std::endl;
+    for (size_t i = 0; i < phases.size(); ++i)
+        std::cout << "  " << std::left << std::setw(40) << phases[i].name << std::right << std::setw(8) << phases[i].ms << " ms" << std::endl;
+
+    if (!tasks.empty())
+        std::cout << "  On the thread pool, alongside the above:" << std::endl;
+    for (size_t i = 0; i < tasks.size(); ++i)
+        std::cout << "    " << std::left << std::setw(38) << tasks[i].name << std::right << std::setw(8) << tasks[i].ms << " ms" << std::endl;
+    std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+/**
+ * Records a finished task
+ *
+ * @param name What the task did
+ * @param ms How long it took
+ */
+void StartupReport::addTask(const std::string &name, double ms)
+{
+    std::lock_guard<std::mutex> guard(taskLock);
+    StartupPhase done = { name, ms };
+    tasks.push_back(done);
+}
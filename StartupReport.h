@@ -0,0 +1,49 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _STARTUPREPORT_
+#define _STARTUPREPORT_
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// How long one part of startup took
+struct StartupPhase
+{
+    std::string name;
+    double ms;
+};
+
+/**
+ * Times the phases of startup and prints them as a table
+ *
+ * Phases on the main thread follow one another, each lasting from the end of
+ * the one before. Tasks on the thread pool overlap them and are timed on
+ * their own.
+ */
+class StartupReport
+{
+public:
+    StartupReport(void);
+
+    void phase(const char *name);
+    std::function<void(void)> timed(const char *name, std::function<void(void)> task);
+    double getTotalMs(void) const;
+    void print(void);
+
+private:
+    void addTask(const std::string &name, double ms);
+
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point lastPhase;
+    std::vector<StartupPhase> phases;
+    std::vector<StartupPhase> tasks;
+    std::mutex taskLock; // Tasks finish on the pool's threads
+};
+#endif
@@ -7,13 +7,102 @@
 #include "TextureManager.h"
 
 /**
- * Loads all pre-defined textures
+ * Texture handle members
+ */
+
+/**
+ * Constructor for a handle to nothing
+ */
+TextureHandle::TextureHandle(void): owner(NULL), id(TX_TOTAL)
+{
+}
+
+/**
+ * Constructor, use TextureManager::acquire instead
  *
- * @param renderer An external renderer needed to create textures
+ * @param owner Texture manager holding the texture
+ * @param id The texture ID to reference
  */
-TextureManager::TextureManager(SDL_Renderer *xRenderer)
+TextureHandle::TextureHandle(TextureManager *owner, TextureID id): owner(owner), id(id)
 {
-    renderer = xRenderer;
+    if (owner != NULL)
+        ++owner->refs[id];
+}
+
+/**
+ * Copy constructor, adds a reference
+ *
+ * @param other Handle to copy
+ */
+TextureHandle::TextureHandle(const TextureHandle &other): owner(other.owner), id(other.id)
+{
+    if (owner != NULL)
+        ++owner->refs[id];
+}
+
+/**
+ * Assignment, moves the reference to the other handle's texture
+ *
+ * @param other Handle to copy
+ * @returns This handle
+ */
+TextureHandle &TextureHandle::operator=(const TextureHandle &other)
+{
+    if (other.owner != NULL)
+        ++other.owner->refs[other.id];
+    if (owner != NULL)
+        --owner->refs[id];
+    owner = other.owner;
+    id = other.id;
+    return *this;
+}
+
+/**
+ * Destructor, drops the reference
+ */
+TextureHandle::~TextureHandle(void)
+{
+    if (owner != NULL)
+        --owner->refs[id];
+}
+
+/**
+ * Retrieves the texture to draw, see TextureManager::getTexture
+ *
+ * @returns A pointer to the texture, the placeholder while it reloads, or NULL for an empty handle
+ */
+SDL_Texture *TextureHandle::get(void) const
+{
+    return (owner != NULL) ? owner->getTexture(id) : NULL;
+}
+
+/**
+ * Getter for the texture referenced
+ *
+ * @returns The texture ID, TX_TOTAL for an empty handle
+ */
+TextureID TextureHandle::getID(void) const
+{
+    return id;
+}
+
+/**
+ * Texture manager members
+ */
+
+/**
+ * Sets up the pre-defined textures without loading any, see decodeAll and uploadAll
+ * Opens the asset bundle, which doesn't need SDL
+ */
+TextureManager::TextureManager(void):
+    loader(TEXTURE_LOAD_THREADS)
+{
+    renderer = NULL;
+    imagesReady = false;
+    frame = 0;
+    budget = TEXTURE_BUDGET;
+    stats = TextureStats();
+    placeholder = NULL;
 
     int i = 0;
     paths[i++] = "assets/images/openmoji-player.png";
@@ -25,12 +114,21 @@ TextureManager::TextureManager(SDL_Renderer *xRenderer)
     paths[i++] = "assets/images/placeholder-pit.png";
     paths[i++] = "assets/images/game_over.png";
 
+    // Source and destination colours are both already multiplied by their alpha
+    premultipliedBlend = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                                    SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    bundle.open(ASSET_BUNDLE_PATH);
+
     for (int id = 0; id < TX_TOTAL; ++id)
     {
         textures[id] = NULL;
+        decoded[id] = NULL;
+        premultiplied[id] = false;
         dimensions[id].x = 0;
         dimensions[id].y = 0;
-        load(static_cast<TextureID>(id));
+        refs[id] = 0;
+        lastUsed[id] = 0;
+        reloading[id] = false;
     }
 }
 
@@ -39,21 +137,130 @@ TextureManager::TextureManager(SDL_Renderer *xRenderer)
  */
 TextureManager::~TextureManager(void)
 {
+    // Reloads still decoding would add to the list after it is emptied
+    loader.wait();
+    for (size_t i = 0; i < reloaded.size(); ++i)
+        SDL_FreeSurface(reloaded[i].second);
+
     for (int id = 0; id < TX_TOTAL; ++id)
     {
         unload(static_cast<TextureID>(id));
+        if (decoded[id] != NULL)
+            SDL_FreeSurface(decoded[id]);
+    }
+    if (placeholder != NULL)
+        SDL_DestroyTexture(placeholder);
+}
+
+/**
+ * Queues every image the bundle doesn't hold for decoding on a thread pool
+ * SDL_image is only initialized if there is something to decode.
+ * The pool must be waited on before calling uploadAll
+ *
+ * @param pool Pool to decode on
+ * @param report Times each decode if not NULL
+ * @returns Number of images queued
+ */
+int TextureManager::decodeAll(ThreadPool &pool, StartupReport *report)
+{
+    int queued = 0;
+
+    for (int id = 0; id < TX_TOTAL; ++id)
+    {
+        const AssetEntry *entry = bundle.find(paths[id].c_str());
+        if (entry != NULL && entry->kind == AK_IMAGE)
+            continue;
+
+        initImages();
+        ++queued;
+
+        // Each task only touches its own slot
+        SDL_Surface **out = &decoded[id];
+        const char *path = paths[id].c_str();
+        std::function<void(void)> task = [out, path] { *out = IMG_Load(path); };
+        pool.submit(report != NULL ? report->timed(path, task) : task);
     }
+    return queued;
 }
 
 /**
- * Retrieves a texture that has been loaded
+ * Creates every texture, from what decodeAll decoded or straight from the bundle
+ * Must be called on the thread that owns the renderer
+ *
+ * @param xRenderer An external renderer needed to create textures
+ */
+void TextureManager::uploadAll(SDL_Renderer *xRenderer)
+{
+    renderer = xRenderer;
+    createPlaceholder();
+    for (int id = 0; id < TX_TOTAL; ++id)
+        load(static_cast<TextureID>(id));
+}
+
+/**
+ * Uploads textures that finished reloading and evicts the least recently
+ * drawn ones while over budget
+ * Call once per frame after presenting it, so nothing drawn is destroyed before it is shown
+ */
+void TextureManager::endFrame(void)
+{
+    std::vector<std::pair<int, SDL_Surface *> > ready;
+    {
+        std::lock_guard<std::mutex> guard(reloadLock);
+        ready.swap(reloaded);
+    }
+
+    for (size_t i = 0; i < ready.size(); ++i)
+    {
+        TextureID id = static_cast<TextureID>(ready[i].first);
+        reloading[id] = false;
+        if (textures[id] != NULL)
+        {
+            SDL_FreeSurface(ready[i].second);
+            continue;
+        }
+        decoded[id] = ready[i].second;
+        if (load(id) != NULL)
+            ++stats.reloads;
+    }
+
+    while (stats.residentBytes > budget)
+    {
+        int victim = findVictim();
+        if (victim < 0)
+            break;
+        evict(static_cast<TextureID>(victim));
+    }
+    ++frame;
+}
+
+/**
+ * Takes a reference to a texture, held until the handle is destroyed
+ *
+ * @param id The texture ID to reference
+ * @returns Handle to the texture
+ */
+TextureHandle TextureManager::acquire(TextureID id)
+{
+    return TextureHandle(this, id);
+}
+
+/**
+ * Retrieves a texture to draw this frame, reloading it if it was evicted
  *
  * @param id The texture ID to retrieve
- * @returns A pointer to the texture
+ * @returns A pointer to the texture, or the placeholder while it reloads
  */
 SDL_Texture *TextureManager::getTexture(TextureID id)
 {
-    return textures[id];
+    ++stats.lookups;
+    lastUsed[id] = frame;
+    if (textures[id] != NULL)
+        return textures[id];
+
+    ++stats.misses;
+    requestReload(id);
+    return (textures[id] != NULL) ? textures[id] : placeholder;
 }
 
 /**
@@ -67,6 +274,75 @@ SDL_Point TextureManager::getDimensions(TextureID id)
     return dimensions[id];
 }
 
+/**
+ * Fades a texture for the next time it is drawn, or its placeholder while it reloads
+ * Premultiplied textures need their colour scaled along with their alpha
+ * Call after getTexture, which may upload the texture
+ *
+ * @param id The texture ID to fade
+ * @param alpha Opacity to draw it at, 255 to stop fading
+ */
+void TextureManager::setAlpha(TextureID id, Uint8 alpha)
+{
+    SDL_Texture *texture = (textures[id] != NULL) ? textures[id] : placeholder;
+
+    SDL_SetTextureAlphaMod(texture, alpha);
+    if (textures[id] != NULL && premultiplied[id])
+        SDL_SetTextureColorMod(texture, alpha, alpha, alpha);
+    else
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+}
+
+/**
+ * Getter for the asset bundle, for loading fonts and maps from it
+ *
+ * @returns The bundle, which isn't open if the game is running without one
+ */
+const AssetBundle &TextureManager::getBundle(void)
+{
+    return bundle;
+}
+
+/**
+ * Sets how many bytes of textures to keep resident, enforced by the next endFrame
+ *
+ * @param bytes Budget, counted as 4 bytes a pixel
+ */
+void TextureManager::setBudget(size_t bytes)
+{
+    budget = bytes;
+}
+
+/**
+ * Getter for the residency budget
+ *
+ * @returns Bytes of textures kept resident
+ */
+size_t TextureManager::getBudget(void) const
+{
+    return budget;
+}
+
+/**
+ * Getter for the residency counters
+ *
+ * @returns Lookups, misses, reloads, evictions and resident bytes so far
+ */
+const TextureStats &TextureManager::getStats(void) const
+{
+    return stats;
+}
+
+/**
+ * Share of lookups that found their texture evicted
+ *
+ * @returns Misses over lookups, 0 before any lookup
+ */
+double TextureManager::getMissRate(void) const
+{
+    return (stats.lookups > 0) ? static_cast<double>(stats.misses) / stats.lookups : 0;
+}
+
 /**
  * Loads a image into memory and creates a texture from it
  *
@@ -80,10 +356,27 @@ SDL_Texture *TextureManager::load(TextureID id)
         unload(id);
 
     const char *path = paths[id].c_str();
-    SDL_Texture *texture = IMG_LoadTexture(renderer, path);
+    const AssetEntry *entry = bundle.find(path);
+    SDL_Texture *texture;
+
+    // Bundled images were decoded when they were packed, anything else is decoded now unless already done
+    premultiplied[id] = entry != NULL && entry->kind == AK_IMAGE;
+    if (premultiplied[id])
+        texture = upload(entry);
+    else if (decoded[id] != NULL)
+    {
+        texture = SDL_CreateTextureFromSurface(renderer, decoded[id]);
+        SDL_FreeSurface(decoded[id]);
+        decoded[id] = NULL;
+    }
+    else
+        texture = IMG_LoadTexture(renderer, path);
 
     if (!texture)
+    {
         printf("Error creating texture from %s: %s", path, SDL_GetError());
+        return NULL;
+    }
 
     // Get dimensions
     int w = 0;
@@ -96,6 +389,30 @@ SDL_Texture *TextureManager::load(TextureID id)
     dimensions[id] = size;
 
     textures[id] = texture;
+    stats.residentBytes += static_cast<size_t>(w) * h * 4;
+    if (stats.residentBytes > stats.peakBytes)
+        stats.peakBytes = stats.residentBytes;
+    return texture;
+}
+
+/**
+ * Creates a texture from a bundled image's pixels, used in place from the mapped bundle
+ *
+ * @param entry The image's entry in the bundle
+ * @returns A pointer to the texture that was created, or NULL if failed
+ */
+SDL_Texture *TextureManager::upload(const AssetEntry *entry)
+{
+    SDL_Texture *texture = SDL_CreateTexture(renderer, entry->format, SDL_TEXTUREACCESS_STATIC, entry->width, entry->height);
+
+    if (!texture)
+        return NULL;
+    if (SDL_UpdateTexture(texture, NULL, bundle.getData(entry), entry->pitch) != 0)
+    {
+        SDL_DestroyTexture(texture);
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(texture, premultipliedBlend);
     return texture;
 }
 
@@ -107,9 +424,113 @@ SDL_Texture *TextureManager::load(TextureID id)
 void TextureManager::unload(TextureID id)
 {
     if (textures[id] != NULL) {
+        stats.residentBytes -= static_cast<size_t>(dimensions[id].x) * dimensions[id].y * 4;
         SDL_DestroyTexture(textures[id]);
         textures[id] = NULL;
         dimensions[id].x = 0;
         dimensions[id].y = 0;
     }
 }
+
+/**
+ * Starts loading an evicted texture again
+ * Bundled images are uploaded straight away, others are decoded on the loader thread
+ *
+ * @param id The texture ID to reload
+ */
+void TextureManager::requestReload(TextureID id)
+{
+    if (reloading[id] || renderer == NULL)
+        return;
+
+    const AssetEntry *entry = bundle.find(paths[id].c_str());
+    if (entry != NULL && entry->kind == AK_IMAGE)
+    {
+        if (load(id) != NULL)
+            ++stats.reloads;
+        return;
+    }
+
+    initImages();
+    reloading[id] = true;
+
+    const char *path = paths[id].c_str();
+    loader.submit([this, id, path] {
+        SDL_Surface *surface = IMG_Load(path);
+        std::lock_guard<std::mutex> guard(reloadLock);
+        reloaded.push_back(std::make_pair(static_cast<int>(id), surface));
+    });
+}
+
+/**
+ * Drops a texture to save memory, keeping its dimensions for the sprites drawn with it
+ *
+ * @param id The texture ID to evict
+ */
+void TextureManager::evict(TextureID id)
+{
+    SDL_Point size = dimensions[id];
+
+    unload(id);
+    dimensions[id] = size;
+    ++stats.evictions;
+}
+
+/**
+ * Picks the texture to evict next: not drawn in the frame being ended, and of
+ * those the least recently drawn, preferring textures nothing holds a handle to
+ *
+ * @returns The texture ID, or -1 if every resident texture was drawn this frame
+ */
+int TextureManager::findVictim(void) const
+{
+    int victim = -1;
+
+    // Only a handful of textures, so a scan beats keeping them ordered
+    for (int id = 0; id < TX_TOTAL; ++id)
+    {
+        if (textures[id] == NULL || lastUsed[id] == frame)
+            continue;
+        if (victim < 0)
+        {
+            victim = id;
+            continue;
+        }
+
+        bool held = refs[id] > 0;
+        bool victimHeld = refs[victim] > 0;
+        if ((!held && victimHeld) || (held == victimHeld && lastUsed[id] < lastUsed[victim]))
+            victim = id;
+    }
+    return victim;
+}
+
+/**
+ * Initializes SDL_image before the first decode
+ * Decoders register themselves on first use, which isn't safe from several threads at once
+ */
+void TextureManager::initImages(void)
+{
+    if (!imagesReady)
+        IMG_Init(IMG_INIT_PNG);
+    imagesReady = true;
+}
+
+/**
+ * Creates the magenta and black checkerboard drawn in place of textures that are reloading
+ */
+void TextureManager::createPlaceholder(void)
+{
+    Uint32 pixels[TEXTURE_PLACEHOLDER_SIZE * TEXTURE_PLACEHOLDER_SIZE];
+
+    for (int y = 0; y < TEXTURE_PLACEHOLDER_SIZE; ++y)
+    {
+        for (int x = 0; x < TEXTURE_PLACEHOLDER_SIZE; ++x)
+            pixels[y * TEXTURE_PLACEHOLDER_SIZE + x] = ((x + y) % 2 == 0) ? 0xffff00ff : 0xff000000;
+    }
+
+    placeholder = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                    TEXTURE_PLACEHOLDER_SIZE, TEXTURE_PLACEHOLDER_SIZE);
+    if (placeholder != NULL)
+        SDL_UpdateTexture(placeholder, NULL, pixels, TEXTURE_PLACEHOLDER_SIZE * sizeof(Uint32));
+}
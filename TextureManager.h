@@ -9,7 +9,25 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <atomic>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
 #include <string>
+#include <utility>
+#include <vector>
+#include "AssetBundle.h"
+#include "ThreadPool.h"
+#include "StartupReport.h"
+
+// Bytes of textures kept resident by default, counted as 4 bytes a pixel
+#define TEXTURE_BUDGET (64 * 1024 * 1024)
+
+// Threads decoding textures that were evicted and are needed again
+#define TEXTURE_LOAD_THREADS 1
+
+// Pixels along each side of the checkerboard drawn while a texture reloads
+#define TEXTURE_PLACEHOLDER_SIZE 8
 
 // Identifiers for textures
 enum TextureID
@@ -25,29 +43,121 @@ enum TextureID
     TX_TOTAL
 };
 
+// Counters for how well the resident textures cover what is drawn
+struct TextureStats
+{
+    uint64_t lookups;     // Calls to getTexture
+    uint64_t misses;      // Lookups that found their texture evicted
+    uint64_t reloads;     // Evicted textures loaded again
+    uint64_t evictions;   // Textures dropped to get back under the budget
+    size_t residentBytes; // Bytes of textures loaded now
+    size_t peakBytes;     // Most bytes of textures ever loaded at once
+};
+
+class TextureManager;
+
+/**
+ * Reference to a texture, counted by the texture manager
+ *
+ * Hold one for as long as a texture may be drawn. Textures nothing holds
+ * are the first to be evicted when over budget. Copying a handle adds a
+ * reference and destroying it drops one.
+ */
+class TextureHandle
+{
+public:
+    TextureHandle(void);
+    TextureHandle(TextureManager *owner, TextureID id);
+    TextureHandle(const TextureHandle &other);
+    TextureHandle &operator=(const TextureHandle &other);
+    ~TextureHandle(void);
+
+    SDL_Texture *get(void) const;
+    TextureID getID(void) const;
+
+private:
+    TextureManager *owner; // NULL for an empty handle
+    TextureID id;
+};
+
 /**
  * Manages textures in memory
  *
  * A pre-defined set of textures can be loaded, unloaded,
  * and retrieved with its dimension meta data
+ *
+ * Loading is split in two so decoding can overlap creating the window:
+ * decodeAll decodes images on a thread pool, then uploadAll creates the
+ * textures on the main thread once the renderer exists.
+ *
+ * Resident textures are kept under a byte budget. endFrame evicts the least
+ * recently drawn textures once over it, those without handles first, and
+ * never one drawn in the frame just finished. Looking up an evicted texture
+ * starts reloading it and returns a placeholder until the reload is
+ * uploaded by a later endFrame; bundled textures need no decoding and are
+ * uploaded on the spot.
+ *
+ * Textures in the asset bundle are uploaded from its pre-decoded pixels,
+ * the rest are decoded from their image files. Bundled textures have
+ * premultiplied alpha, so use setAlpha rather than SDL_SetTextureAlphaMod
+ * to fade them.
  */
 class TextureManager
 {
 public:
-    TextureManager(SDL_Renderer *xRenderer);
+    TextureManager(void);
     ~TextureManager(void);
 
+    int decodeAll(ThreadPool &pool, StartupReport *report);
+    void uploadAll(SDL_Renderer *xRenderer);
+    void endFrame(void);
+
+    TextureHandle acquire(TextureID id);
     SDL_Texture *getTexture(TextureID id);
     SDL_Point getDimensions(TextureID id);
+    void setAlpha(TextureID id, Uint8 alpha);
+    const AssetBundle &getBundle(void);
+
+    void setBudget(size_t bytes);
+    size_t getBudget(void) const;
+    const TextureStats &getStats(void) const;
+    double getMissRate(void) const;
 
 private:
+    friend class TextureHandle;
+
     std::string paths[TX_TOTAL];
 
     SDL_Texture *textures[TX_TOTAL];
-    SDL_Point dimensions[TX_TOTAL];
+    SDL_Surface *decoded[TX_TOTAL]; // Decoded by decodeAll and waiting for upload, NULL otherwise
+    SDL_Point dimensions[TX_TOTAL]; // Kept while evicted, so sprites keep their size
+    bool premultiplied[TX_TOTAL];
     SDL_Renderer *renderer;
+    AssetBundle bundle;   // Fonts and maps are read from it too
+    SDL_BlendMode premultipliedBlend;
+    bool imagesReady;     // SDL_image has been initialized
+
+    // Residency
+    std::atomic<int> refs[TX_TOTAL]; // Handles held, the map takes its handles on a loading thread
+    uint64_t lastUsed[TX_TOTAL];     // Frame each texture was last looked up in
+    bool reloading[TX_TOTAL];        // Queued for decoding after a miss
+    uint64_t frame;                  // Frames ended so far
+    size_t budget;
+    TextureStats stats;
+    SDL_Texture *placeholder;
+
+    // Reloads decoded on the loader's thread, waiting for endFrame to upload them
+    std::mutex reloadLock;
+    std::vector<std::pair<int, SDL_Surface *> > reloaded;
+    ThreadPool loader; // Last, so it finishes its tasks before anything they use goes
 
     SDL_Texture *load(TextureID id);
+    SDL_Texture *upload(const AssetEntry *entry);
     void unload(TextureID id);
+    void requestReload(TextureID id);
+    void evict(TextureID id);
+    int findVictim(void) const;
+    void initImages(void);
+    void createPlaceholder(void);
 };
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,106 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "ThreadPool.h"
+
+/**
+ * Constructor, starts the workers
+ *
+ * @param threads Number of workers, at least one is started
+ */
+ThreadPool::ThreadPool(int threads):
+    pending(0),
+    stopping(false)
+{
+    if (threads < 1)
+        threads = 1;
+    for (int i = 0; i < threads; ++i)
+        workers.push_back(std::thread(&ThreadPool::work, this));
+}
+
+/**
+ * Destructor, finishes every queued task and stops the workers
+ */
+ThreadPool::~ThreadPool(void)
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    queued.notify_all();
+    for (size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+}
+
+/**
+ * Queues a task for the next free worker
+ *
+ * @param task Work to run, anything it captures must outlive wait
+ */
+void ThreadPool::submit(std::function<void(void)> task)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        tasks.push_back(task);
+        ++pending;
+    }
+    queued.notify_one();
+}
+
+/**
+ * Blocks until every submitted task has finished
+ */
+void ThreadPool::wait(void)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    finished.wait(guard, [this] { return pending == 0; });
+}
+
+/**
+ * Getter for the number of workers
+ *
+ * @returns Threads running tasks
+ */
+int ThreadPool::getThreadCount(void) const
+{
+    return workers.size();
+}
+
+/**
+ * Workers to start for work that should use the whole machine
+ *
+ * @returns One per hardware thread, at least one
+ */
+int ThreadPool::defaultThreadCount(void)
+{
+    int threads = std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+/**
+ * Worker loop, runs tasks until the pool is destroyed
+ */
+void ThreadPool::work(void)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    while (true)
+    {
+        queued.wait(guard, [this] { return stopping || !tasks.empty(); });
+        if (tasks.empty())
+            return;
+
+        std::function<void(void)> task = tasks.front();
+        tasks.pop_front();
+        guard.unlock();
+        task();
+        guard.lock();
+
+        if (--pending == 0)
+            finished.notify_all();
+    }
+}
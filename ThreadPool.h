@@ -0,0 +1,52 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _THREADPOOL_
+#define _THREADPOOL_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads running queued tasks
+ *
+ * Tasks run in the order they were submitted, on whichever worker is free.
+ * wait blocks until every submitted task has finished, after which
+ * everything the tasks wrote can be read safely.
+ *
+ * Kept free of SDL, tasks must not touch the renderer.
+ */
+class ThreadPool
+{
+public:
+    ThreadPool(int threads);
+    ~ThreadPool(void);
+
+    void submit(std::function<void(void)> task);
+    void wait(void);
+    int getThreadCount(void) const;
+
+    static int defaultThreadCount(void);
+
+private:
+    ThreadPool(const ThreadPool &) = delete; // Would share the workers
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void work(void);
+
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable queued;   // A task was submitted, or the workers should stop
+    std::condition_variable finished; // The last outstanding task finished
+    std::deque<std::function<void(void)> > tasks;
+    int pending;                      // Tasks submitted and not yet finished
+    bool stopping;
+};
+#endif
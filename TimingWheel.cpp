@@ -0,0 +1,129 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "TimingWheel.h"
+
+/**
+ * Constructor, starts at tick 0 with no events
+ */
+TimingWheel::TimingWheel(void):
+    now(0),
+    pending(0)
+{
+}
+
+/**
+ * Drops every event and restarts the wheel, keeping slot capacity
+ *
+ * @param tick Tick the wheel is currently at
+ */
+void TimingWheel::reset(uint32_t tick)
+{
+    for (int level = 0; level < WHEEL_LEVELS; ++level)
+    {
+        for (int slot = 0; slot < WHEEL_SLOTS; ++slot)
+            slots[level][slot].clear();
+    }
+    now = tick;
+    pending = 0;
+}
+
+/**
+ * Schedules an event
+ *
+ * @param due Tick the event should fire on, events due now or earlier fire on the next tick
+ * @param kind What the event is for
+ * @param entity Entity the event is about
+ */
+void TimingWheel::schedule(uint32_t due, TimerKind kind, EntityHandle entity)
+{
+    TimerEvent event = { due, kind, entity };
+
+    if (static_cast<int32_t>(due - now) <= 0)
+        event.due = now + 1;
+
+    place(event);
+    ++pending;
+}
+
+/**
+ * Moves to the next tick and hands over every event due on it
+ *
+ * @param fired Receives the events due, in no particular order
+ */
+void TimingWheel::advance(std::vector<TimerEvent> &fired)
+{
+    ++now;
+
+    // Bring higher levels down when the levels below them wrap, highest first
+    for (int level = WHEEL_LEVELS - 1; level > 0; --level)
+    {
+        if ((now & ((1u << (level * WHEEL_SLOT_BITS)) - 1)) == 0)
+            cascade(level);
+    }
+
+    std::vector<TimerEvent> &slot = slots[0][now & (WHEEL_SLOTS - 1)];
+    fired.insert(fired.end(), slot.begin(), slot.end());
+    pending -= slot.size();
+    slot.clear();
+}
+
+/**
+ * Getter for the current tick
+ *
+ * @returns Last tick advanced to
+ */
+uint32_t TimingWheel::getTick(void)
+{
+    return now;
+}
+
+/**
+ * Getter for the number of scheduled events
+ *
+ * @returns Events that have not fired yet
+ */
+size_t TimingWheel::getPending(void)
+{
+    return pending;
+}
+
+/**
+ * Puts an event in the lowest level whose span reaches its due tick
+ *
+ * @param event Event due on or after the current tick
+ */
+void TimingWheel::place(const TimerEvent &event)
+{
+    uint32_t delta = event.due - now;
+    int level = 0;
+
+    while (level < WHEEL_LEVELS - 1 && delta >= (1u << ((level + 1) * WHEEL_SLOT_BITS)))
+        ++level;
+
+    int slot = (event.due >> (level * WHEEL_SLOT_BITS)) & (WHEEL_SLOTS - 1);
+    slots[level][slot].push_back(event);
+}
+
+/**
+ * Redistributes the slot of a level that has come due into the levels below
+ *
+ * @param level Level to cascade from
+ */
+void TimingWheel::cascade(int level)
+{
+    std::vector<TimerEvent> &slot = slots[level][(now >> (level * WHEEL_SLOT_BITS)) & (WHEEL_SLOTS - 1)];
+    std::vector<TimerEvent> moving;
+
+    moving.swap(slot);
+    for (size_t i = 0; i < moving.size(); ++i)
+        place(moving[i]);
+
+    // Hand the capacity back so the slot doesn't reallocate next time around
+    moving.clear();
+    if (slot.capacity() < moving.capacity())
+        slot.swap(moving);
+}
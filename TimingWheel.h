@@ -0,0 +1,66 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _TIMINGWHEEL_
+#define _TIMINGWHEEL_
+
+#include <stdint.h>
+#include <vector>
+#include "World.h"
+
+// Each level has 2^WHEEL_SLOT_BITS slots, four levels cover every 32-bit tick
+#define WHEEL_LEVELS 4
+#define WHEEL_SLOT_BITS 8
+#define WHEEL_SLOTS (1 << WHEEL_SLOT_BITS)
+
+// What should happen when a timer goes off
+enum TimerKind
+{
+    TK_FIRE,     // Enemy shoots
+    TK_RETARGET, // Enemy picks a new direction
+    TK_EXPIRE    // Projectile disappears
+};
+
+// A scheduled event, the entity may be gone by the time it fires
+struct TimerEvent
+{
+    uint32_t due;
+    TimerKind kind;
+    EntityHandle entity;
+};
+
+/**
+ * Hierarchical timing wheel keyed by simulation tick
+ *
+ * Level 0 holds events due in the next 256 ticks, one slot per tick.
+ * Each higher level covers 256 times the span of the one below, and its
+ * slots are moved down a level when the lower wheel wraps around. Advancing
+ * a tick only touches the events due on it (plus an occasional cascade), so
+ * the cost does not depend on how many timers are waiting.
+ *
+ * Events are never cancelled; whoever handles them checks the entity handle.
+ */
+class TimingWheel
+{
+public:
+    TimingWheel(void);
+
+    void reset(uint32_t tick);
+    void schedule(uint32_t due, TimerKind kind, EntityHandle entity);
+    void advance(std::vector<TimerEvent> &fired);
+
+    uint32_t getTick(void);
+    size_t getPending(void);
+
+private:
+    void place(const TimerEvent &event);
+    void cascade(int level);
+
+    std::vector<TimerEvent> slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    uint32_t now;   // Last tick advanced to
+    size_t pending; // Events waiting in the wheel
+};
+#endif
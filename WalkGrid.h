@@ -0,0 +1,74 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _WALKGRID_
+#define _WALKGRID_
+
+#include <stddef.h>
+#include <vector>
+
+/**
+ * Anything that can tell which map tiles can be walked on, so pathfinding
+ * can read a grid held whole or one streamed in around the player
+ */
+class WalkSource
+{
+public:
+    virtual ~WalkSource(void) {}
+
+    virtual int getRows(void) const = 0;
+    virtual int getColumns(void) const = 0;
+
+    // False for tiles off the map
+    virtual bool isWalkable(int row, int col) = 0;
+
+    bool inBounds(int row, int col) const
+    {
+        return row >= 0 && col >= 0 && row < getRows() && col < getColumns();
+    }
+};
+
+/**
+ * Which map tiles can be walked on, stored row-major with one byte per tile
+ *
+ * Kept free of SDL so pathfinding can run (and be benchmarked) without a renderer
+ */
+struct WalkGrid : public WalkSource
+{
+    int rows;
+    int columns;
+    std::vector<unsigned char> walkable;
+
+    WalkGrid(void): rows(0), columns(0) {}
+
+    void resize(int newRows, int newColumns)
+    {
+        rows = newRows;
+        columns = newColumns;
+        walkable.assign(static_cast<size_t>(rows) * columns, 0);
+    }
+
+    int getRows(void) const override
+    {
+        return rows;
+    }
+
+    int getColumns(void) const override
+    {
+        return columns;
+    }
+
+    bool isWalkable(int row, int col) override
+    {
+        return inBounds(row, col) && walkable[static_cast<size_t>(row) * columns + col] != 0;
+    }
+
+    void setWalkable(int row, int col, bool value)
+    {
+        walkable[static_cast<size_t>(row) * columns + col] = value ? 1 : 0;
+    }
+};
+#endif
@@ -0,0 +1,294 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+#include "World.h"
+
+/**
+ * Archetype members
+ */
+
+// Appends a default component to a column if the mask includes it
+template<typename T> static void pushDefault(ComponentMask mask, std::vector<T> &column)
+{
+    if (mask & ComponentBitOf<T>::value)
+        column.push_back(T());
+}
+
+// Moves the last component of a column into a row and shrinks the column
+template<typename T> static void swapRemove(std::vector<T> &column, size_t row)
+{
+    if (column.empty())
+        return;
+    if (row + 1 != column.size())
+        column[row] = std::move(column.back());
+    column.pop_back();
+}
+
+/**
+ * Constructor
+ *
+ * @param mask Components every entity in this archetype has
+ */
+Archetype::Archetype(ComponentMask mask):
+    mask(mask)
+{
+}
+
+/**
+ * Getter for the component mask
+ *
+ * @returns Components every entity in this archetype has
+ */
+ComponentMask Archetype::getMask(void) const
+{
+    return mask;
+}
+
+/**
+ * Indicates whether this archetype has a set of components
+ *
+ * @param required Component bits to check for
+ * @returns True if every required component is present
+ */
+bool Archetype::has(ComponentMask required) const
+{
+    return (mask & required) == required;
+}
+
+/**
+ * Getter for the number of entities stored
+ *
+ * @returns Number of rows
+ */
+size_t Archetype::size(void) const
+{
+    return owners.size();
+}
+
+/**
+ * Getter for how many rows fit before the arrays grow again
+ *
+ * @returns Rows allocated, never shrinks
+ */
+size_t Archetype::getCapacity(void) const
+{
+    return owners.capacity();
+}
+
+/**
+ * Getter for the entity stored in a row
+ *
+ * @param row Row index
+ * @returns Handle of the entity
+ */
+EntityHandle Archetype::getOwner(size_t row) const
+{
+    return owners[row];
+}
+
+/**
+ * Adds a row of default components
+ *
+ * @param owner Entity the row belongs to
+ * @returns Index of the new row
+ */
+size_t Archetype::addRow(EntityHandle owner)
+{
+    owners.push_back(owner);
+    std::apply([this](auto &... column) { (pushDefault(mask, column), ...); }, columns);
+    return owners.size() - 1;
+}
+
+/**
+ * Removes a row by moving the last row into its place
+ *
+ * @param row Row index to remove
+ * @returns True if another entity was moved into the row
+ */
+bool Archetype::removeRow(size_t row)
+{
+    bool moved = (row + 1 != owners.size());
+
+    swapRemove(owners, row);
+    std::apply([row](auto &... column) { (swapRemove(column, row), ...); }, columns);
+    return moved;
+}
+
+/**
+ * Removes every row, keeping the allocated capacity
+ */
+void Archetype::clear(void)
+{
+    owners.clear();
+    std::apply([](auto &... column) { (column.clear(), ...); }, columns);
+}
+
+/**
+ * World members
+ */
+
+// Constructor
+World::World(void):
+    entityCount(0)
+{
+}
+
+/**
+ * Destroys all entities and archetypes
+ */
+World::~World(void)
+{
+    for (size_t i = 0; i < archetypes.size(); ++i)
+        delete archetypes[i];
+    archetypes.clear();
+}
+
+/**
+ * Creates an entity with default components
+ *
+ * @param mask Components the entity is made of
+ * @returns Handle to the new entity
+ */
+EntityHandle World::create(ComponentMask mask)
+{
+    EntityHandle entity;
+
+    if (!freeSlots.empty())
+    {
+        entity.index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        entity.index = slots.size();
+        Slot slot = { 0, NULL, 0 };
+        slots.push_back(slot);
+    }
+
+    Slot &slot = slots[entity.index];
+    entity.generation = slot.generation;
+    slot.archetype = getArchetype(mask);
+    slot.row = slot.archetype->addRow(entity);
+    ++entityCount;
+    return entity;
+}
+
+/**
+ * Destroys an entity, does nothing if it is already gone
+ *
+ * @param entity Entity handle
+ */
+void World::destroy(EntityHandle entity)
+{
+    if (!isAlive(entity))
+        return;
+
+    Slot &slot = slots[entity.index];
+    Archetype *archetype = slot.archetype;
+    uint32_t row = slot.row;
+
+    // Point the entity that took over the row at its new home
+    if (archetype->removeRow(row))
+        slots[archetype->getOwner(row).index].row = row;
+
+    slot.archetype = NULL;
+    ++slot.generation;
+    freeSlots.push_back(entity.index);
+    --entityCount;
+}
+
+/**
+ * Indicates whether a handle still refers to a living entity
+ *
+ * @param entity Entity handle
+ * @returns True if the entity exists
+ */
+bool World::isAlive(EntityHandle entity)
+{
+    return entity.index < slots.size()
+        && slots[entity.index].archetype != NULL
+        && slots[entity.index].generation == entity.generation;
+}
+
+/**
+ * Getter for an entity's components
+ *
+ * @param entity Entity handle
+ * @returns Component mask, or 0 if the entity is gone
+ */
+ComponentMask World::getMask(EntityHandle entity)
+{
+    return isAlive(entity) ? slots[entity.index].archetype->getMask() : 0;
+}
+
+/**
+ * Destroys every entity, keeping archetypes and their capacity for reuse
+ */
+void World::clear(void)
+{
+    freeSlots.clear();
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        if (slots[i].archetype != NULL)
+        {
+            slots[i].archetype = NULL;
+            ++slots[i].generation;
+        }
+        freeSlots.push_back(slots.size() - 1 - i);
+    }
+
+    for (size_t i = 0; i < archetypes.size(); ++i)
+        archetypes[i]->clear();
+    entityCount = 0;
+}
+
+/**
+ * Finds the archetype for a set of components, creating it if needed
+ *
+ * @param mask Component mask
+ * @returns The archetype storing entities with exactly these components
+ */
+Archetype *World::getArchetype(ComponentMask mask)
+{
+    for (size_t i = 0; i < archetypes.size(); ++i)
+    {
+        if (archetypes[i]->getMask() == mask)
+            return archetypes[i];
+    }
+
+    archetypes.push_back(new Archetype(mask));
+    return archetypes.back();
+}
+
+/**
+ * Getter for every archetype, used by systems to find the entities they work on
+ *
+ * @returns All archetypes created so far
+ */
+std::vector<Archetype *> &World::getArchetypes(void)
+{
+    return archetypes;
+}
+
+/**
+ * Getter for the number of living entities
+ *
+ * @returns Entity count
+ */
+size_t World::getEntityCount(void)
+{
+    return entityCount;
+}
+
+/**
+ * Getter for how many entity slots fit before the slot array grows again
+ *
+ * @returns Slots allocated, never shrinks
+ */
+size_t World::getSlotCapacity(void)
+{
+    return slots.capacity();
+}
@@ -0,0 +1,130 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+#ifndef _WORLD_
+#define _WORLD_
+
+#include <tuple>
+#include <vector>
+#include "Components.h"
+
+// Identifies an entity, stays valid (but stale) after the entity is destroyed
+struct EntityHandle
+{
+    uint32_t index;
+    uint32_t generation;
+
+    bool operator==(const EntityHandle &other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const EntityHandle &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+// Handle that never refers to an entity
+const EntityHandle NULL_ENTITY = { 0xFFFFFFFF, 0 };
+
+/**
+ * Storage for every entity that has exactly the same set of components
+ *
+ * Each component type gets its own dense array (only the ones in the
+ * mask are used), and row N of every array belongs to the same entity.
+ * Removing a row moves the last row into its place, so systems that
+ * remove while iterating should walk the rows backwards.
+ */
+class Archetype
+{
+public:
+    Archetype(ComponentMask mask);
+
+    ComponentMask getMask(void) const;
+    bool has(ComponentMask required) const;
+    size_t size(void) const;
+    size_t getCapacity(void) const;
+    EntityHandle getOwner(size_t row) const;
+
+    size_t addRow(EntityHandle owner);
+    bool removeRow(size_t row);
+    void clear(void);
+
+    /**
+     * Dense array of one component type
+     * Pointers into it are invalidated when rows are added or removed
+     *
+     * @returns The component array, empty if the archetype lacks the component
+     */
+    template<typename T> std::vector<T> &column(void)
+    {
+        return std::get<std::vector<T> >(columns);
+    }
+
+private:
+    ComponentMask mask;
+    std::vector<EntityHandle> owners;
+    std::tuple<std::vector<Position>, std::vector<Velocity>, std::vector<Hitbox>,
+               std::vector<Health>, std::vector<Shooter>, std::vector<AIState>,
+               std::vector<Sprite>, std::vector<Projectile>, std::vector<PlayerControl> > columns;
+};
+
+/**
+ * Owns all entities and their components
+ *
+ * Systems ask for the archetypes holding the components they need and walk
+ * those arrays directly, see DisplayManager for the game's systems
+ */
+class World
+{
+public:
+    World(void);
+    ~World(void);
+
+    EntityHandle create(ComponentMask mask);
+    void destroy(EntityHandle entity);
+    bool isAlive(EntityHandle entity);
+    ComponentMask getMask(EntityHandle entity);
+    void clear(void);
+
+    Archetype *getArchetype(ComponentMask mask);
+    std::vector<Archetype *> &getArchetypes(void);
+    size_t getEntityCount(void);
+    size_t getSlotCapacity(void);
+
+    /**
+     * Looks up one component of an entity
+     * The pointer is invalidated when entities with the same components are created or destroyed
+     *
+     * @param entity Entity handle
+     * @returns Pointer to the component, or NULL if the entity is gone or lacks it
+     */
+    template<typename T> T *get(EntityHandle entity)
+    {
+        if (!isAlive(entity))
+            return NULL;
+
+        Slot &slot = slots[entity.index];
+        if (!slot.archetype->has(ComponentBitOf<T>::value))
+            return NULL;
+        return &slot.archetype->column<T>()[slot.row];
+    }
+
+private:
+    // Where an entity's components are stored
+    struct Slot
+    {
+        uint32_t generation;
+        Archetype *archetype; // NULL while the slot is free
+        uint32_t row;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<Archetype *> archetypes;
+    size_t entityCount;
+};
+#endif
@@ -0,0 +1,140 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+/**
+ * Batched AABB overlap benchmark
+ *
+ * Scatters 20,000 bullet-sized boxes over a 4096x4096 area and tests a
+ * player-sized box against all of them each tick, once with the batched
+ * kernel and once with a plain per-box loop, checking both agree. Then
+ * runs a 512 x 512 many-vs-many test like a busy broadphase cell.
+ *
+ * Build and run with: make bench && ./aabb_bench
+ */
+
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+#include "../AABBBatch.h"
+
+#define AREA 4096
+#define BOXES 20000
+#define TICKS 2000
+#define GROUP 512
+
+using namespace std;
+
+static double msSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Bullets are 10 pixels across and some have swept a little distance
+ */
+static void scatter(BoxArray &boxes, int count, int area)
+{
+    boxes.clear();
+    for (int i = 0; i < count; ++i)
+        boxes.add(rand() % area, rand() % area, 10 + rand() % 8, 10 + rand() % 8);
+}
+
+/**
+ * Reference test, one box at a time
+ */
+static void overlapEach(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, const BoxArray &boxes, uint32_t *hits)
+{
+    for (size_t i = 0; i < BOX_HIT_WORDS(boxes.size()); ++i)
+        hits[i] = 0;
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+        if (minX < boxes.maxX[i] && maxX > boxes.minX[i] && minY < boxes.maxY[i] && maxY > boxes.minY[i])
+            hits[i / 32] |= 1u << (i % 32);
+    }
+}
+
+static int countBits(const vector<uint32_t> &hits)
+{
+    int count = 0;
+    for (size_t i = 0; i < hits.size(); ++i)
+    {
+        for (uint32_t bits = hits[i]; bits != 0; bits &= bits - 1)
+            ++count;
+    }
+    return count;
+}
+
+int main(void)
+{
+    BoxArray bullets;
+    vector<uint32_t> batched(BOX_HIT_WORDS(BOXES));
+    vector<uint32_t> each(BOX_HIT_WORDS(BOXES));
+    vector<int32_t> playerX(TICKS);
+    vector<int32_t> playerY(TICKS);
+
+    srand(1);
+    scatter(bullets, BOXES, AREA);
+    for (int tick = 0; tick < TICKS; ++tick)
+    {
+        playerX[tick] = rand() % AREA;
+        playerY[tick] = rand() % AREA;
+    }
+
+    cout << "Kernel: " << getBoxOverlapKernel() << endl;
+
+    // One vs many, the player against every enemy bullet
+    int hits = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int tick = 0; tick < TICKS; ++tick)
+    {
+        boxOverlapOneMany(playerX[tick], playerY[tick], playerX[tick] + 64, playerY[tick] + 64, bullets, batched.data());
+        hits += batched[0] & 1;
+    }
+    double batchedMs = msSince(start);
+
+    start = chrono::steady_clock::now();
+    for (int tick = 0; tick < TICKS; ++tick)
+    {
+        overlapEach(playerX[tick], playerY[tick], playerX[tick] + 64, playerY[tick] + 64, bullets, each.data());
+        hits += each[0] & 1;
+    }
+    double eachMs = msSince(start);
+
+    // Same answers for every tick
+    int mismatches = 0;
+    int overlaps = 0;
+    for (int tick = 0; tick < TICKS; ++tick)
+    {
+        boxOverlapOneMany(playerX[tick], playerY[tick], playerX[tick] + 64, playerY[tick] + 64, bullets, batched.data());
+        overlapEach(playerX[tick], playerY[tick], playerX[tick] + 64, playerY[tick] + 64, bullets, each.data());
+        mismatches += (batched != each);
+        overlaps += countBits(batched);
+    }
+
+    cout << "One vs many: " << TICKS << " ticks x " << BOXES << " boxes, "
+         << batchedMs * 1000.0 / TICKS << " us/tick batched, "
+         << eachMs * 1000.0 / TICKS << " us/tick per box, "
+         << eachMs / batchedMs << "x, " << overlaps << " overlaps, "
+         << mismatches << " mismatched ticks" << endl;
+
+    // Many vs many, every box in one crowded cell against every box in another
+    BoxArray a;
+    BoxArray b;
+    vector<uint32_t> grid(GROUP * BOX_HIT_WORDS(GROUP));
+    scatter(a, GROUP, 256);
+    scatter(b, GROUP, 256);
+
+    size_t pairs = 0;
+    start = chrono::steady_clock::now();
+    for (int tick = 0; tick < TICKS / 10; ++tick)
+        pairs += boxOverlapManyMany(a, b, grid.data());
+    double manyMs = msSince(start);
+
+    cout << "Many vs many: " << GROUP << " x " << GROUP << " boxes, "
+         << manyMs * 10.0 / TICKS << " ms/test, " << pairs * 10 / TICKS << " pairs" << endl;
+
+    return hits < 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+/**
+ * Headless batch simulation benchmark
+ *
+ * Steps many games at once with BatchEnvironment, every player moving and
+ * firing at random, and reports simulation ticks per second over all of
+ * them. Runs from the repository root so the instances find the assets.
+ *
+ * Build and run with: make batch_bench && ./batch_bench [instances] [threads] [seconds]
+ */
+
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+#include "../BatchEnvironment.h"
+
+#define INSTANCES 256
+#define SECONDS 10
+#define SEED 7
+#define ACTION_TICKS 4
+
+using namespace std;
+
+static double msSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    int instances = (argc > 1) ? atoi(argv[1]) : INSTANCES;
+    int threads = (argc > 2) ? atoi(argv[2]) : ThreadPool::defaultThreadCount();
+    double seconds = (argc > 3) ? atof(argv[3]) : SECONDS;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    BatchEnvironment env(instances, threads, SEED);
+    cout << "Loaded " << env.getInstanceCount() << " instances on " << env.getThreadCount() << " threads in "
+        << msSince(start) << " ms, " << BatchEnvironment::getBufferSize(instances) / 1024 << " KB of observations" << endl;
+
+    // New random actions every step, held for ACTION_TICKS ticks like a bot deciding every few frames
+    vector<BatchAction> actions(env.getInstanceCount());
+    uint32_t state = SEED;
+    uint64_t steps = 0;
+    uint64_t startTicks = env.getTickCount();
+    uint64_t startRuns = env.getRunCount();
+
+    start = chrono::steady_clock::now();
+    while (msSince(start) < seconds * 1000)
+    {
+        for (size_t i = 0; i < actions.size(); ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            actions[i].move.left = (state >> 10) & 1;
+            actions[i].move.right = (state >> 11) & 1;
+            actions[i].move.up = (state >> 12) & 1;
+            actions[i].move.down = (state >> 13) & 1;
+            actions[i].fire = (state >> 14) & 1;
+        }
+        env.step(actions.data(), ACTION_TICKS);
+        ++steps;
+    }
+    double ms = msSince(start);
+
+    // Touch the observations so the run is checked to have produced something
+    const BatchObservations &obs = env.getObservations();
+    uint64_t enemies = 0, projectiles = 0;
+    for (int i = 0; i < env.getInstanceCount(); ++i)
+    {
+        enemies += obs.enemyCount[i];
+        projectiles += obs.projectileCount[i];
+    }
+
+    uint64_t ticks = env.getTickCount() - startTicks;
+    cout << steps << " steps, " << ticks << " ticks in " << ms << " ms" << endl;
+    cout << "  " << ticks / (ms / 1000) << " ticks/s total, " << ms * 1000 * env.getThreadCount() / ticks << " us per tick per thread" << endl;
+    cout << "  " << env.getRunCount() - startRuns << " runs ended, " << enemies << " enemies and "
+        << projectiles << " projectiles observed on the last step" << endl;
+    return 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+/**
+ * Chunk streaming benchmark
+ *
+ * Writes an 8192x8192 chunked map, then walks a player across it a tile per
+ * tick. Every tick looks up the tiles a screen shows around the player and
+ * whether the tiles under a crowd of enemies near them can be walked on,
+ * the way rendering and collision do. Runs once with the background prefetch and once without,
+ * and checks every tile looked up against the map that was written.
+ *
+ * Build and run with: make bench && ./chunk_bench
+ */
+
+#include <chrono>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../ChunkCache.h"
+
+#define MAP_SIZE 8192
+#define MAP_PATH "chunk_bench.map"
+#define VIEW_TILES 11 // Tiles across a 1024 pixel window
+#define ENEMIES 200
+#define ENEMY_RANGE 8 // Tiles enemies stay within around the player
+#define TICKS 30000
+
+using namespace std;
+
+struct Result
+{
+    double usPerTick;
+    ChunkStats stats;
+    int resident;
+    long wrong;
+};
+
+static Result walk(const vector<uint8_t> &tiles, bool prefetch)
+{
+    ChunkCache cache;
+    Result result;
+    long wrong = 0;
+
+    cache.openFile(MAP_PATH, CHUNK_BUDGET, 0); // Tile type 0, palette index 0, is the walkable one
+    srand(2);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int tick = 0; tick < TICKS; ++tick)
+    {
+        // Back and forth along rows, dropping a few rows at each end
+        int pass = tick / (MAP_SIZE - 2 * VIEW_TILES);
+        int step = tick % (MAP_SIZE - 2 * VIEW_TILES);
+        int row = VIEW_TILES + (pass * 37) % (MAP_SIZE - 2 * VIEW_TILES);
+        int col = VIEW_TILES + ((pass % 2 == 0) ? step : MAP_SIZE - 2 * VIEW_TILES - 1 - step);
+
+        if (prefetch)
+            cache.prefetchAround(row, col);
+
+        for (int r = row - VIEW_TILES / 2; r <= row + VIEW_TILES / 2; ++r)
+        {
+            for (int c = col - VIEW_TILES / 2; c <= col + VIEW_TILES / 2; ++c)
+                wrong += cache.tileAt(r, c) != tiles[static_cast<size_t>(r) * MAP_SIZE + c];
+        }
+        for (int i = 0; i < ENEMIES; ++i)
+        {
+            int r = row + rand() % (2 * ENEMY_RANGE + 1) - ENEMY_RANGE;
+            int c = col + rand() % (2 * ENEMY_RANGE + 1) - ENEMY_RANGE;
+            wrong += cache.isWalkable(r, c) != (tiles[static_cast<size_t>(r) * MAP_SIZE + c] == 0);
+        }
+    }
+
+    result.usPerTick = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / TICKS;
+    result.stats = cache.getStats();
+    result.resident = cache.getResidentCount();
+    result.wrong = wrong;
+    return result;
+}
+
+static void report(const char *name, const Result &result)
+{
+    cout << name << ": " << result.usPerTick << " us per tick, " << result.stats.misses << " chunks loaded on the spot, "
+         << result.stats.prefetches << " prefetched, " << result.stats.evictions << " evicted, "
+         << result.resident << " resident, " << result.wrong << " wrong tiles" << endl;
+}
+
+int main(void)
+{
+    vector<uint8_t> tiles(static_cast<size_t>(MAP_SIZE) * MAP_SIZE);
+    vector<MapPaletteEntry> palette(3);
+
+    srand(1);
+    for (size_t i = 0; i < tiles.size(); ++i)
+        tiles[i] = (rand() % 10 == 0) ? 1 + rand() % 2 : 0;
+    for (int i = 0; i < 3; ++i)
+        palette[i].type = i;
+    ChunkCache::write(MAP_PATH, MAP_SIZE, MAP_SIZE, palette, tiles.data());
+
+    // The file was just written, so reads come from the page cache rather than the disk
+    Result streamed = walk(tiles, true);
+    Result onDemand = walk(tiles, false);
+
+    cout << MAP_SIZE << "x" << MAP_SIZE << " map (" << tiles.size() / (1024 * 1024) << " MB of tiles), "
+         << CHUNK_BUDGET << " chunks of " << CHUNK_SIZE << "x" << CHUNK_SIZE << " resident at most ("
+         << CHUNK_BUDGET * CHUNK_SIZE * CHUNK_SIZE / 1024 << " KB), " << TICKS << " ticks" << endl;
+    report("prefetched", streamed);
+    report("on demand", onDemand);
+
+    remove(MAP_PATH);
+    return (streamed.wrong == 0 && onDemand.wrong == 0) ? 0 : 1;
+}
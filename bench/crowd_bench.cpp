@@ -0,0 +1,130 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+/**
+ * Crowd neighbour query benchmark
+ *
+ * Puts 2,000 enemies in clusters around a 3000x3000 area, then each tick
+ * rebuilds the spatial hash and asks for every enemy's neighbours within
+ * the separation radius, the same work the enemy movement does. The
+ * answers are checked against testing every pair.
+ *
+ * Build and run with: make bench && ./crowd_bench
+ */
+
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+#include "../SpatialHash.h"
+
+#define AREA 3000
+#define ENEMIES 2000
+#define CLUSTERS 40
+#define RADIUS 40
+#define TICKS 500
+
+using namespace std;
+
+static double msSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Enemies bunch up around the player, so cluster them rather than spreading evenly
+ */
+static void placeEnemies(vector<Position> &enemies)
+{
+    vector<Position> centers(CLUSTERS);
+    for (int i = 0; i < CLUSTERS; ++i)
+    {
+        centers[i].x = rand() % AREA;
+        centers[i].y = rand() % AREA;
+    }
+
+    enemies.resize(ENEMIES);
+    for (int i = 0; i < ENEMIES; ++i)
+    {
+        const Position &center = centers[i % CLUSTERS];
+        enemies[i].x = center.x + rand() % 300 - 150;
+        enemies[i].y = center.y + rand() % 300 - 150;
+    }
+}
+
+/**
+ * Every enemy takes a small random step, like a tick of movement
+ */
+static void wander(vector<Position> &enemies)
+{
+    for (size_t i = 0; i < enemies.size(); ++i)
+    {
+        enemies[i].x += rand() % 5 - 2;
+        enemies[i].y += rand() % 5 - 2;
+    }
+}
+
+int main(void)
+{
+    SpatialHash crowd(RADIUS);
+    vector<Position> enemies;
+    vector<SpatialEntry> found;
+
+    srand(1);
+    placeEnemies(enemies);
+
+    // Hashed queries, rebuilding the index every tick
+    long hashed = 0;
+    double worst = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int tick = 0; tick < TICKS; ++tick)
+    {
+        chrono::steady_clock::time_point tickStart = chrono::steady_clock::now();
+        wander(enemies);
+
+        crowd.clear();
+        for (int i = 0; i < ENEMIES; ++i)
+            crowd.insert(i, enemies[i]);
+        for (int i = 0; i < ENEMIES; ++i)
+        {
+            crowd.query(enemies[i], RADIUS, found);
+            hashed += found.size();
+        }
+
+        double tickMs = msSince(tickStart);
+        if (tickMs > worst)
+            worst = tickMs;
+    }
+    double hashMs = msSince(start);
+
+    // Every pair, on the final positions only since it is slow
+    long pairs = 0;
+    long lastTick = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < ENEMIES; ++i)
+    {
+        for (int j = 0; j < ENEMIES; ++j)
+        {
+            double dx = enemies[i].x - enemies[j].x;
+            double dy = enemies[i].y - enemies[j].y;
+            pairs += (dx * dx + dy * dy < RADIUS * RADIUS);
+        }
+    }
+    double pairMs = msSince(start);
+
+    for (int i = 0; i < ENEMIES; ++i)
+    {
+        crowd.query(enemies[i], RADIUS, found);
+        lastTick += found.size();
+    }
+
+    cout << "Hashed: " << TICKS << " ticks x " << ENEMIES << " enemies, "
+         << hashMs / TICKS << " ms/tick avg, " << worst << " ms/tick worst, "
+         << (double)hashed / ((double)TICKS * ENEMIES) << " neighbours/enemy avg" << endl;
+    cout << "All pairs: " << pairMs << " ms/tick, " << pairMs * TICKS / hashMs << "x slower, "
+         << (lastTick == pairs ? "same" : "DIFFERENT") << " neighbours (" << pairs << ")" << endl;
+
+    return lastTick != pairs;
+}
@@ -0,0 +1,135 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+/**
+ * Map generator benchmark
+ *
+ * Generates 1024x1024 and 8192x8192 maps on one thread and on every
+ * hardware thread (at least 4), checks the two come out the same, and
+ * checks by flood fill that all the floor can be reached from the start
+ * tile. The 1024x1024
+ * map is then given to the pathfinder for 1,000 queries between random
+ * floor tiles, which must all find a path.
+ *
+ * Build and run with: make bench && ./mapgen_bench
+ */
+
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+#include <thread>
+#include "../HierarchicalPathfinder.h"
+#include "../MapGenerator.h"
+
+#define SEED 7
+#define QUERIES 1000
+
+using namespace std;
+
+static double msSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Counts the floor that can't be walked to from the start tile
+ */
+static long unreachableFloor(const MapGenerator &generator)
+{
+    const vector<uint8_t> &tiles = generator.getTiles();
+    int width = generator.getWidth();
+    int height = generator.getHeight();
+    vector<unsigned char> seen(tiles.size(), 0);
+    vector<int> stack(1, GEN_START_ROW * width + GEN_START_COL);
+    long floor = 0;
+    long reached = 0;
+
+    for (size_t i = 0; i < tiles.size(); ++i)
+        floor += tiles[i] == GEN_TERRAIN;
+
+    seen[stack[0]] = 1;
+    while (!stack.empty())
+    {
+        int tile = stack.back();
+        stack.pop_back();
+        ++reached;
+
+        int row = tile / width;
+        int col = tile % width;
+        int neighbours[4] = { row > 0 ? tile - width : -1, row < height - 1 ? tile + width : -1,
+                              col > 0 ? tile - 1 : -1, col < width - 1 ? tile + 1 : -1 };
+        for (int n = 0; n < 4; ++n)
+        {
+            if (neighbours[n] >= 0 && !seen[neighbours[n]] && tiles[neighbours[n]] == GEN_TERRAIN)
+            {
+                seen[neighbours[n]] = 1;
+                stack.push_back(neighbours[n]);
+            }
+        }
+    }
+    return floor - reached;
+}
+
+static bool benchSize(int size, int threads, MapGenerator &parallel)
+{
+    MapGenerator single;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    single.generate(size, size, SEED, 1);
+    double singleMs = msSince(start);
+
+    start = chrono::steady_clock::now();
+    parallel.generate(size, size, SEED, threads);
+    double parallelMs = msSince(start);
+
+    bool same = single.getTiles() == parallel.getTiles();
+    long unreachable = unreachableFloor(parallel);
+    cout << size << "x" << size << ": " << singleMs << " ms on 1 thread, " << parallelMs << " ms on " << threads
+         << ", " << (same ? "same" : "DIFFERENT") << " map, " << unreachable << " unreachable floor tiles" << endl;
+    return same && unreachable == 0;
+}
+
+int main(void)
+{
+    int threads = thread::hardware_concurrency();
+    MapGenerator small;
+    MapGenerator large;
+    WalkGrid grid;
+    HierarchicalPathfinder pathfinder;
+    vector<int> floor;
+    vector<int> waypoints;
+    bool ok;
+
+    // Always split the work, so the same-map check means something on small machines too
+    if (threads < 4)
+        threads = 4;
+    ok = benchSize(1024, threads, small);
+    ok = benchSize(8192, threads, large) && ok;
+
+    // Pathfinding on the generated map
+    grid.resize(small.getHeight(), small.getWidth());
+    for (size_t i = 0; i < small.getTiles().size(); ++i)
+    {
+        grid.walkable[i] = small.getTiles()[i] == GEN_TERRAIN;
+        if (grid.walkable[i])
+            floor.push_back(i);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    pathfinder.build(grid);
+    double buildMs = msSince(start);
+
+    srand(1);
+    int found = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < QUERIES; ++i)
+        found += pathfinder.findPath(floor[rand() % floor.size()], floor[rand() % floor.size()], waypoints);
+    double queryMs = msSince(start);
+
+    cout << "pathfinding on 1024x1024: " << buildMs << " ms to build, " << queryMs * 1000 / QUERIES << " us per query, "
+         << found << "/" << QUERIES << " paths found" << endl;
+    return (ok && found == QUERIES) ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+/**
+ * Hierarchical pathfinding benchmark
+ *
+ * Builds a 1024x1024 map of walled rooms with random clutter, then runs
+ * 1,000 path queries per tick from agents wandering the map toward a
+ * moving player, plus a round of flee queries.
+ *
+ * Build and run with: make bench && ./pathfinding_bench
+ */
+
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+#include "../HierarchicalPathfinder.h"
+
+#define MAP_SIZE 1024
+#define ROOM_SIZE 32
+#define AGENTS 1000
+#define TICKS 200
+
+using namespace std;
+
+static double msSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Rooms separated by walls with a few doors each, plus random single-tile clutter
+ */
+static void buildMap(WalkGrid &grid)
+{
+    grid.resize(MAP_SIZE, MAP_SIZE);
+    for (int row = 0; row < MAP_SIZE; ++row)
+    {
+        for (int col = 0; col < MAP_SIZE; ++col)
+        {
+            bool wall = (row % ROOM_SIZE == 0) || (col % ROOM_SIZE == 0);
+            bool door = (row % ROOM_SIZE == ROOM_SIZE / 2) || (col % ROOM_SIZE == ROOM_SIZE / 4);
+            bool clutter = (rand() % 100) < 12;
+            grid.setWalkable(row, col, !(wall && !door) && !clutter);
+        }
+    }
+}
+
+static int randomOpenTile(WalkGrid &grid)
+{
+    int row, col;
+    do
+    {
+        row = rand() % grid.rows;
+        col = rand() % grid.columns;
+    } while (!grid.isWalkable(row, col));
+    return row * grid.columns + col;
+}
+
+int main(void)
+{
+    WalkGrid grid;
+    HierarchicalPathfinder pathfinder;
+    vector<int> agents(AGENTS);
+    vector<int> waypoints;
+    vector<int> tiles;
+
+    srand(1);
+    buildMap(grid);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    pathfinder.build(grid);
+    cout << "Build: " << msSince(start) << " ms, " << pathfinder.getRegionCount() << " regions, "
+         << pathfinder.getNodeCount() << " portal nodes" << endl;
+
+    for (int i = 0; i < AGENTS; ++i)
+        agents[i] = randomOpenTile(grid);
+    int player = randomOpenTile(grid);
+
+    // Chase queries: every agent asks for a route to the player each tick
+    double worst = 0;
+    int found = 0;
+    start = chrono::steady_clock::now();
+    for (int tick = 0; tick < TICKS; ++tick)
+    {
+        chrono::steady_clock::time_point tickStart = chrono::steady_clock::now();
+
+        // The player wanders to a new spot every so often, agents shuffle around
+        if (tick % 20 == 0)
+            player = randomOpenTile(grid);
+        for (int i = tick % 10; i < AGENTS; i += 10)
+            agents[i] = randomOpenTile(grid);
+
+        for (int i = 0; i < AGENTS; ++i)
+            found += pathfinder.findPath(agents[i], player, waypoints);
+
+        double tickMs = msSince(tickStart);
+        if (tickMs > worst)
+            worst = tickMs;
+    }
+    double total = msSince(start);
+    long hits = pathfinder.getCacheHits();
+    long misses = pathfinder.getCacheMisses();
+
+    cout << "Chase: " << TICKS << " ticks x " << AGENTS << " queries, "
+         << total / TICKS << " ms/tick avg, " << worst << " ms/tick worst, "
+         << total * 1000.0 / (TICKS * AGENTS) << " us/query, "
+         << found << " found, cache hit rate " << (100.0 * hits / (hits + misses)) << "%" << endl;
+
+    // Uncached worst case: distinct start and goal regions every query
+    pathfinder.clearCache();
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < AGENTS; ++i)
+        pathfinder.findPath(randomOpenTile(grid), randomOpenTile(grid), waypoints);
+    cout << "Cold: " << AGENTS << " random queries in " << msSince(start) << " ms" << endl;
+
+    // Flee queries: pick a far target and expand the full tile path
+    start = chrono::steady_clock::now();
+    int fled = 0;
+    size_t steps = 0;
+    for (int i = 0; i < AGENTS; ++i)
+    {
+        int target = pathfinder.findFleeTarget(agents[i], player, 16, rand());
+        if (target >= 0 && pathfinder.findTilePath(agents[i], target, tiles))
+        {
+            ++fled;
+            steps += tiles.size();
+        }
+    }
+    cout << "Flee: " << AGENTS << " targets + tile paths in " << msSince(start) << " ms, "
+         << fled << " found, " << (fled ? steps / fled : 0) << " tiles/path avg" << endl;
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+/**
+ * Projectile broadphase benchmark
+ *
+ * Fills an area with enemy bullets and a few soul bullets, each with a
+ * short swept move, and finds every soul bullet and enemy bullet pair that
+ * could touch with the grid broadphase. The area grows with the count so
+ * bullet density stays the same, and the pairs are checked against testing
+ * every soul bullet against every enemy bullet. Time per projectile should
+ * stay about flat up to 20,000 projectiles.
+ *
+ * Build and run with: make bench && ./projectile_bench
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+#include "../Broadphase.h"
+
+#define MAX_PROJECTILES 20000
+#define SOUL_PERCENT 5
+#define PIXELS_PER_PROJECTILE 800 // Area per projectile, about a bullet every 28 pixels
+#define TICKS 100
+#define ROUNDS 5
+
+using namespace std;
+
+static double msSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * A 10 pixel bullet moving up to 8 pixels, one lane in each list
+ */
+static void scatter(BoxArray &souls, BoxArray &shots, int count)
+{
+    int side = static_cast<int>(sqrt(static_cast<double>(count) * PIXELS_PER_PROJECTILE));
+
+    souls.clear();
+    shots.clear();
+    for (int i = 0; i < count; ++i)
+    {
+        int x = rand() % side;
+        int y = rand() % side;
+        int dx = rand() % 17 - 8;
+        int dy = rand() % 17 - 8;
+        BoxArray &list = (rand() % 100 < SOUL_PERCENT) ? souls : shots;
+
+        list.addBounds(min(x, x + dx), min(y, y + dy), max(x, x + dx) + 10, max(y, y + dy) + 10);
+        (&list == &souls ? shots : souls).addEmpty();
+    }
+}
+
+static bool overlaps(const BoxArray &a, int i, const BoxArray &b, int j)
+{
+    return a.minX[i] < b.maxX[j] && a.maxX[i] > b.minX[j] && a.minY[i] < b.maxY[j] && a.maxY[i] > b.minY[j];
+}
+
+static bool pairOrder(const BoxPair &x, const BoxPair &y)
+{
+    return x.a < y.a || (x.a == y.a && x.b < y.b);
+}
+
+int main(void)
+{
+    GridBroadphase grid;
+    BoxArray souls;
+    BoxArray shots;
+    vector<BoxPair> pairs;
+    vector<BoxPair> expected;
+
+    srand(1);
+    for (int count = MAX_PROJECTILES / 8; count <= MAX_PROJECTILES; count *= 2)
+    {
+        scatter(souls, shots, count);
+
+        // Fastest of a few rounds, so other work on the machine doesn't hide the trend
+        double gridMs = 0;
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for (int tick = 0; tick < TICKS; ++tick)
+                grid.findPairs(souls, shots, pairs);
+            double ms = msSince(start) / TICKS;
+            if (round == 0 || ms < gridMs)
+                gridMs = ms;
+        }
+
+        // Every soul bullet against every enemy bullet
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        expected.clear();
+        for (size_t i = 0; i < souls.size(); ++i)
+        {
+            for (size_t j = 0; j < shots.size(); ++j)
+            {
+                if (overlaps(souls, i, shots, j))
+                {
+                    BoxPair pair = { static_cast<int>(i), static_cast<int>(j) };
+                    expected.push_back(pair);
+                }
+            }
+        }
+        double bruteMs = msSince(start);
+
+        sort(pairs.begin(), pairs.end(), pairOrder);
+        bool same = pairs.size() == expected.size();
+        for (size_t i = 0; same && i < pairs.size(); ++i)
+            same = pairs[i].a == expected[i].a && pairs[i].b == expected[i].b;
+
+        cout << count << " projectiles: grid " << gridMs << " ms/tick ("
+             << gridMs * 1e6 / count << " ns/projectile), every pair " << bruteMs << " ms/tick, "
+             << pairs.size() << " pairs, " << (same ? "same" : "DIFFERENT") << endl;
+        if (!same)
+            return 1;
+    }
+
+    return 0;
+}
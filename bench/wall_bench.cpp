@@ -0,0 +1,177 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+ */
+
+/**
+ * Destructible wall benchmark
+ *
+ * Breaks 2,000 random walls on a generated 1024x1024 map, updating the
+ * pathfinder and a flow field toward the middle of the map one tile at a
+ * time, and compares that with rebuilding them from scratch. Every 100 walls
+ * the updated pathfinder is checked against a fresh build: both must agree
+ * on which tiles can reach each other, and every path must be made of
+ * adjacent walkable tiles. The patched flow field must give every tile the
+ * same distance as a fresh one. Walls outside the flow field's window
+ * around its target leave it alone, so they are its quickest updates.
+ *
+ * Build and run with: make bench && ./wall_bench
+ */
+
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+#include "../FlowField.h"
+#include "../HierarchicalPathfinder.h"
+#include "../Map.h"
+#include "../MapGenerator.h"
+
+#define SIZE 1024
+#define SEED 11
+#define BREAKS 2000
+#define CHECK_EVERY 100
+#define CHECK_QUERIES 200
+
+using namespace std;
+
+static double msSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Finds a position whose feet are on a tile
+ */
+static Position tileCentre(int tile)
+{
+    Position pos = { static_cast<double>((tile % SIZE) * TILE_WIDTH + (TILE_WIDTH - ENTITY_FOOT_WIDTH) / 2),
+                     static_cast<double>((tile / SIZE) * TILE_HEIGHT + (TILE_HEIGHT - ENTITY_FOOT_HEIGHT) / 2) };
+    return pos;
+}
+
+/**
+ * Counts the walkable tiles whose distance differs between two flow fields
+ */
+static long countDifferent(const WalkGrid &grid, FlowField &patched, FlowField &fresh)
+{
+    long different = 0;
+    for (int tile = 0; tile < SIZE * SIZE; ++tile)
+    {
+        if (grid.walkable[tile] && patched.getDistance(tileCentre(tile)) != fresh.getDistance(tileCentre(tile)))
+            ++different;
+    }
+    return different;
+}
+
+/**
+ * Checks a path steps between adjacent walkable tiles and ends where it should
+ */
+static bool validPath(const WalkGrid &grid, int from, int to, const vector<int> &path)
+{
+    int previous = from;
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+        int rows = abs(path[i] / grid.columns - previous / grid.columns);
+        int cols = abs(path[i] % grid.columns - previous % grid.columns);
+        if (rows > 1 || cols > 1 || !grid.walkable[path[i]])
+            return false;
+        previous = path[i];
+    }
+    return previous == to;
+}
+
+int main(void)
+{
+    MapGenerator generator;
+    WalkGrid grid;
+    HierarchicalPathfinder pathfinder;
+    FlowField flowField;
+    vector<int> walls;
+    vector<int> path;
+    double updateMs = 0;
+    double worstMs = 0;
+    double buildMs = 0;
+    double flowUpdateMs = 0;
+    double flowWorstMs = 0;
+    double flowBuildMs = 0;
+    int builds = 0;
+    long wrong = 0;
+    long checks = 0;
+    long flowWrong = 0;
+
+    generator.generate(SIZE, SIZE, SEED, 1);
+    grid.resize(SIZE, SIZE);
+    for (size_t i = 0; i < grid.walkable.size(); ++i)
+    {
+        grid.walkable[i] = generator.getTiles()[i] == GEN_TERRAIN;
+        if (generator.getTiles()[i] == GEN_WALL)
+            walls.push_back(i);
+    }
+    pathfinder.build(grid);
+
+    // Lead the flow field to the walkable tile nearest the middle of the map
+    int target = (SIZE / 2) * SIZE + SIZE / 2;
+    while (!grid.walkable[target])
+        ++target;
+    flowField.update(grid, tileCentre(target));
+
+    srand(1);
+    for (int i = 1; i <= BREAKS; ++i)
+    {
+        int wall = rand() % walls.size();
+        int tile = walls[wall];
+        walls[wall] = walls.back();
+        walls.pop_back();
+        grid.walkable[tile] = true;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        pathfinder.updateTile(tile);
+        double ms = msSince(start);
+        updateMs += ms;
+        if (ms > worstMs)
+            worstMs = ms;
+
+        start = chrono::steady_clock::now();
+        flowField.updateTile(grid, tile / SIZE, tile % SIZE);
+        ms = msSince(start);
+        flowUpdateMs += ms;
+        if (ms > flowWorstMs)
+            flowWorstMs = ms;
+
+        if (i % CHECK_EVERY != 0)
+            continue;
+
+        HierarchicalPathfinder fresh;
+        start = chrono::steady_clock::now();
+        fresh.build(grid);
+        buildMs += msSince(start);
+        ++builds;
+
+        FlowField freshField;
+        start = chrono::steady_clock::now();
+        freshField.update(grid, tileCentre(target));
+        flowBuildMs += msSince(start);
+        flowWrong += countDifferent(grid, flowField, freshField);
+
+        for (int q = 0; q < CHECK_QUERIES; ++q)
+        {
+            int from = rand() % (SIZE * SIZE);
+            int to = rand() % (SIZE * SIZE);
+            bool reachable = pathfinder.isReachable(from, to);
+
+            ++checks;
+            if (reachable != fresh.isReachable(from, to))
+                ++wrong;
+            else if (reachable && from != to && (!pathfinder.findTilePath(from, to, path) || !validPath(grid, from, to, path)))
+                ++wrong;
+        }
+    }
+
+    cout << BREAKS << " walls broken on " << SIZE << "x" << SIZE << ": " << updateMs * 1000 / BREAKS << " us per update ("
+         << worstMs << " ms worst), " << buildMs / builds << " ms per full build, " << wrong << "/" << checks
+         << " queries disagree" << endl;
+    cout << "Flow field: " << flowUpdateMs * 1000 / BREAKS << " us per update (" << flowWorstMs << " ms worst), "
+         << flowBuildMs / builds << " ms per full build, " << flowWrong << " tiles disagree" << endl;
+    return (wrong == 0 && flowWrong == 0) ? 0 : 1;
+}
@@ -5,42 +5,115 @@
 #endif //LAB
 
 #include <iostream>
+#include <stdlib.h>
+#include <string.h>
 #include "Map.h"
-#include "Humanoid.h"
 #include "TextureManager.h"
 #include "DisplayManager.h"
 #include "HUD.h"
-
-#define REFRESH_RATE 15
+#include "GameSession.h"
+#include "InputProvider.h"
+#include "BotInput.h"
+#include "SoakMonitor.h"
+#include "SimClock.h"
+#include "StartupReport.h"
+#include "ThreadPool.h"
 
 using namespace std;
 
-bool eventFinder(SDL_Event &event, Movement &movement);
-
 int main (int argc, char **argv) {
-	Movement movement;
+	StartupReport startup;
 
 	//Event handler
 	SDL_Event event;
 
-	// Initialize SDL objects
-	SDL_Init(SDL_INIT_EVERYTHING);
+	// Only video is used, which brings events along; audio, joysticks and haptics stay off
+	SDL_Init(SDL_INIT_VIDEO);
 	TTF_Init();
+	startup.phase("SDL video and TTF init");
+
+	// A map given with --map replaces the first level, e.g. one made by the generator
+	// --texture-budget sets how many KB of textures stay loaded
+	// --speed runs the game from 0.25 to 100 times as fast, --fast as fast as it can go
+	// --soak hands the controls to a bot and logs every run, for long unattended sessions
+	// --soak-time stops it after that many seconds, --soak-interval and --soak-csv set how it is sampled
+	// --seed repeats a run exactly, bot included
+	const char *mapPath = NULL;
+	long textureBudgetKB = -1;
+	bool soak = false;
+	double soakSeconds = 0;
+	double soakInterval = SOAK_INTERVAL;
+	const char *soakCsv = SOAK_CSV_PATH;
+	SimClock simClock;
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--map") == 0 && hasValue)
+			mapPath = argv[i + 1];
+		else if (strcmp(argv[i], "--texture-budget") == 0 && hasValue)
+			textureBudgetKB = atol(argv[i + 1]);
+		else if (strcmp(argv[i], "--speed") == 0 && hasValue)
+			simClock.setScale(atof(argv[i + 1]));
+		else if (strcmp(argv[i], "--fast") == 0)
+			simClock.setUnlimited();
+		else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+			simClock.setSeed(strtoul(argv[i + 1], NULL, 10));
+		else if (strcmp(argv[i], "--soak") == 0)
+			soak = true;
+		else if (strcmp(argv[i], "--soak-time") == 0 && hasValue)
+			soakSeconds = atof(argv[i + 1]);
+		else if (strcmp(argv[i], "--soak-interval") == 0 && hasValue)
+			soakInterval = atof(argv[i + 1]);
+		else if (strcmp(argv[i], "--soak-csv") == 0 && hasValue)
+			soakCsv = argv[i + 1];
+	}
+
+	// Reading and decoding assets runs on a thread pool while the window is created
+	TextureManager *txMan = new TextureManager();
+	if (textureBudgetKB >= 0)
+		txMan->setBudget(textureBudgetKB * 1024);
+	Map *map = NULL;
+	TTF_Font *fontNormal = NULL;
+	TTF_Font *fontBold = NULL;
+	ThreadPool *loaders = new ThreadPool(ThreadPool::defaultThreadCount());
+
+	txMan->decodeAll(*loaders, &startup);
+	loaders->submit(startup.timed("fonts", [&] {
+		fontNormal = HUD::openFont(txMan->getBundle(), FONT_NORMAL_PATH);
+		fontBold = HUD::openFont(txMan->getBundle(), FONT_BOLD_PATH);
+	}));
+	loaders->submit(startup.timed("map", [&] {
+		map = new Map(txMan, mapPath);
+	}));
+	startup.phase("asset bundle and queueing");
 
 	SDL_Window *window = SDL_CreateWindow("Soulgun", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, 0);
 	SDL_Renderer *renderer = SDL_CreateRenderer(window, -1, 0);
-
-	// Create all of the objects for the game engine
-	TextureManager *txMan = new TextureManager(renderer);
-	Map *map = new Map(txMan);
-	DisplayManager dispMan(renderer, txMan, map);
-	vector<Projectile*> playerShots;
-	Humanoid *player = dispMan.spawnHumanoid(map, ET_PLAYER);
-	HUD *hud = new HUD(renderer, player, txMan);
+	startup.phase("window and renderer");
+
+	// Finishes the loading tasks, only the uploads left need the renderer, which belongs to this thread
+	delete loaders;
+	startup.phase("waiting for the thread pool");
+	txMan->uploadAll(renderer);
+	startup.phase("texture upload");
+
+	// Create the rest of the objects for the game engine
+	DisplayManager dispMan(renderer, txMan, map, &simClock);
+	HUD *hud = new HUD(renderer, &dispMan, &simClock, fontNormal, fontBold);
+	GameSession session(&dispMan, hud, map, soak);
+	session.start();
+	InputProvider *input = soak ? static_cast<InputProvider *>(new BotInput(&simClock)) : new KeyboardInput();
+	bool wasOver = false;
+	SoakMonitor *monitor = soak ? new SoakMonitor(soakSeconds, soakInterval, soakCsv) : NULL;
+	if (soak)
+		cout << "Soak: seed " << simClock.getSeed() << ", repeat with --seed" << endl;
+	startup.phase("game setup and first run");
+
+	startup.print();
+	cout << "Assets from " << (txMan->getBundle().isOpen() ? ASSET_BUNDLE_PATH : "their own files") << endl;
 
 	// Start the game loop
-	int nextRefresh = SDL_GetTicks();
-	while (event.type != SDL_QUIT)
+	while (event.type != SDL_QUIT && !session.isFinished() && (monitor == NULL || !monitor->isFinished()))
 	{
 		// Check for input
 		while (SDL_PollEvent(&event) != 0) {
@@ -48,74 +121,68 @@ int main (int argc, char **argv) {
 				break;
 		}
 
-		SDL_RenderClear(renderer);
-
-		// Game Over screen
-        if(player->damage(0)){
-            SDL_RenderCopy(renderer, txMan->getTexture(TX_GAMEOVER), NULL, NULL);
-            SDL_RenderPresent(renderer);
-            SDL_Delay(3000);
-            break;
-        }
-
-		// Interpret event
-		if (eventFinder(event, movement))
-		{
-			playerShots = player->shoot(0,0,true);
-			for (int i = 0; i < playerShots.size(); ++i)
-				dispMan.addProjectile(playerShots[i]);
-		}
-
-		if (map->isPlayerColliding(player->testMove(movement)))
-		{
-			player->move(movement);
-		}
-
-		// Wait for refreshEntities delay
-		int now = SDL_GetTicks();
-		if (now < nextRefresh)
-			SDL_Delay(nextRefresh - now);
-		nextRefresh = now + REFRESH_RATE;
+		// Game Over screen fades in over the frozen game, then a soak starts a new run in place and play from the keyboard ends
+		bool gameOver = session.update();
+		if (soak && gameOver && !wasOver)
+			cout << "Soak: run " << session.getRunCount() << " over with score " << dispMan.getPlayerScore()
+				<< " after " << simClock.getMs() / 1000 << " s of game time" << endl;
+		wasOver = gameOver;
+
+		// Ask the keyboard or the bot what the player does
+		PlayerInput playerInput = input->read(&dispMan);
+		if (!gameOver && playerInput.fire)
+			dispMan.firePlayer();
+
+		if (!gameOver)
+			dispMan.movePlayer(map, playerInput.move);
+
+		// Wait until the frame is due at the clock's speed
+		simClock.pace();
+		if (monitor != NULL)
+			monitor->startFrame();
 		
 		SDL_RenderClear(renderer);
 		
 		// Respawn and recalculate entity positions
-		dispMan.spawnEnemies(map);
-		dispMan.moveEnemies(map);
-		dispMan.fireEnemies();
-		dispMan.moveProjectiles();
-
+		if (!gameOver) {
+			dispMan.advanceTick();
+			dispMan.spawnEnemies(map);
+			dispMan.moveEnemies(map);
+			dispMan.fireEnemies();
+			dispMan.moveProjectiles();
+		}
 
-		// Redraw entities on screen
+		// Redraw entities on screen, effects go on top of everything
 		dispMan.refreshEntities();
 		hud->refresh();
+		dispMan.refreshEffects();
 
 		SDL_RenderPresent(renderer);
+
+		// Textures can only be evicted once the frame using them is shown
+		txMan->endFrame();
+		if (monitor != NULL)
+			monitor->endFrame(&dispMan, session.getRunCount());
 	}
 
+	const TextureStats &textureStats = txMan->getStats();
+	cout << "Textures: " << textureStats.residentBytes / 1024 << " KB resident, " << textureStats.peakBytes / 1024 << " KB peak, "
+		<< txMan->getMissRate() * 100 << "% of " << textureStats.lookups << " lookups missed, "
+		<< textureStats.evictions << " evictions, " << textureStats.reloads << " reloads" << endl;
+
+	// A soak fails when memory or frame time kept growing, or it was too short to tell
+	int status = 0;
+	if (monitor != NULL)
+		status = monitor->finish();
+
 	// Cleanup
+	delete monitor;
+	delete input;
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
-	SDL_Quit();
 	TTF_Quit();
+	IMG_Quit();
+	SDL_Quit();
 
-	return 0;
-}
-
-/**
- * Interprets keyboard events
- * 
- * @param event A keyboard event
- * @param movement Movement struct that will be populated based on keyboard input
- * @returns True if user presses the shoot key
- */
-bool eventFinder(SDL_Event &event, Movement &movement){
-	const Uint8 *keystate = SDL_GetKeyboardState(NULL);
-
-	movement.left = (keystate[SDL_SCANCODE_LEFT] != 0);
-	movement.up = (keystate[SDL_SCANCODE_UP] != 0);
-	movement.right = (keystate[SDL_SCANCODE_RIGHT] != 0);
-	movement.down = (keystate[SDL_SCANCODE_DOWN] != 0);
-	return (keystate[SDL_SCANCODE_SPACE] != 0);
+	return status;
 }
-
@@ -0,0 +1,145 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+/**
+ * Asset packer
+ *
+ * Packs the game's images, fonts and maps into one bundle the game maps
+ * straight into memory at startup. PNGs are decoded here, converted to
+ * ARGB8888 (the first texture format of SDL's renderers) and have their
+ * alpha premultiplied, so the game only has to upload them. Anything else
+ * is stored as it is. Assets are named by the paths given, so run it from
+ * the game directory.
+ *
+ * Build and pack the game's assets with: make bundle
+ * Or pack any files with: ./assetpack <output.bundle> <asset>...
+ */
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string.h>
+#include "../AssetBundle.h"
+
+// Pixel format images are stored in
+#define PACK_FORMAT SDL_PIXELFORMAT_ARGB8888
+
+using namespace std;
+
+/**
+ * Decodes an image and premultiplies its alpha
+ *
+ * @param path Image to decode
+ * @param entry Receives the image's size and format
+ * @param pixels Receives the rows of pixels
+ * @returns False if the image could not be decoded
+ */
+static bool packImage(const char *path, AssetEntry &entry, vector<uint8_t> &pixels)
+{
+    SDL_Surface *loaded = IMG_Load(path);
+    if (loaded == NULL)
+    {
+        cout << "Error decoding " << path << ": " << IMG_GetError() << endl;
+        return false;
+    }
+    SDL_Surface *surface = SDL_ConvertSurfaceFormat(loaded, PACK_FORMAT, 0);
+    SDL_FreeSurface(loaded);
+    if (surface == NULL)
+    {
+        cout << "Error converting " << path << ": " << SDL_GetError() << endl;
+        return false;
+    }
+
+    entry.kind = AK_IMAGE;
+    entry.format = PACK_FORMAT;
+    entry.width = surface->w;
+    entry.height = surface->h;
+    entry.pitch = surface->w * 4;
+    pixels.resize(static_cast<size_t>(entry.pitch) * entry.height);
+
+    // ARGB8888 is one 32-bit word per pixel, alpha in the top byte
+    for (int y = 0; y < surface->h; ++y)
+    {
+        const uint32_t *in = reinterpret_cast<const uint32_t *>(static_cast<const uint8_t *>(surface->pixels) + y * surface->pitch);
+        uint32_t *out = reinterpret_cast<uint32_t *>(&pixels[y * entry.pitch]);
+        for (int x = 0; x < surface->w; ++x)
+        {
+            uint32_t a = in[x] >> 24;
+            uint32_t r = ((in[x] >> 16 & 0xff) * a + 127) / 255;
+            uint32_t g = ((in[x] >> 8 & 0xff) * a + 127) / 255;
+            uint32_t b = ((in[x] & 0xff) * a + 127) / 255;
+            out[x] = a << 24 | r << 16 | g << 8 | b;
+        }
+    }
+    SDL_FreeSurface(surface);
+    return true;
+}
+
+/**
+ * Reads a file as it is
+ *
+ * @param path File to read
+ * @param entry Receives the raw kind
+ * @param bytes Receives the file
+ * @returns False if the file could not be read
+ */
+static bool packRaw(const char *path, AssetEntry &entry, vector<uint8_t> &bytes)
+{
+    ifstream in(path, ios::binary);
+    if (!in.is_open())
+    {
+        cout << "Error reading " << path << endl;
+        return false;
+    }
+    bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    entry.kind = AK_RAW;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    vector<AssetEntry> entries;
+    vector<vector<uint8_t> > data;
+    size_t total = 0;
+
+    if (argc < 3)
+    {
+        cout << "Usage: " << argv[0] << " <output.bundle> <asset>..." << endl;
+        return 1;
+    }
+
+    for (int i = 2; i < argc; ++i)
+    {
+        const char *path = argv[i];
+        size_t length = strlen(path);
+        AssetEntry entry;
+        vector<uint8_t> bytes;
+
+        if (length >= ASSET_NAME_SIZE)
+        {
+            cout << "Asset path too long: " << path << endl;
+            return 1;
+        }
+        memset(&entry, 0, sizeof(entry));
+        memcpy(entry.name, path, length);
+
+        bool image = length > 4 && strcmp(path + length - 4, ".png") == 0;
+        if (!(image ? packImage(path, entry, bytes) : packRaw(path, entry, bytes)))
+            return 1;
+
+        total += bytes.size();
+        entries.push_back(entry);
+        data.push_back(bytes);
+    }
+
+    if (!AssetBundle::write(argv[1], entries, data))
+        return 1;
+
+    cout << argv[1] << ": " << entries.size() << " assets, " << total << " bytes" << endl;
+    return 0;
+}
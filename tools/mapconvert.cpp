@@ -0,0 +1,46 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+/**
+ * Map converter
+ *
+ * Imports a text map (one row of tile types per line) and writes it in the
+ * binary format the game maps straight into memory. Binary maps can be
+ * given too, e.g. to rewrite one in the current version. With --chunked the
+ * map is written in chunks instead, for maps the game should stream in.
+ *
+ * Build and run with: make mapconvert && ./mapconvert assets/maps/levelone.txt assets/maps/levelone.map
+ */
+
+#include <iostream>
+#include <string.h>
+#include "../ChunkCache.h"
+#include "../MapFile.h"
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+    MapFile map;
+    bool chunked = (argc == 4 && strcmp(argv[1], "--chunked") == 0);
+    const char *in = argv[argc - 2];
+    const char *out = argv[argc - 1];
+
+    if (argc != 3 && !chunked)
+    {
+        cout << "Usage: " << argv[0] << " [--chunked] <input map> <output.map>" << endl;
+        return 1;
+    }
+
+    if (!map.open(in))
+        return 1;
+    if (chunked ? !ChunkCache::write(out, map.getWidth(), map.getHeight(), map.getPalette(), map.getTiles()) : !map.save(out))
+        return 1;
+
+    cout << in << " -> " << out << ": " << map.getWidth() << "x" << map.getHeight()
+         << " tiles, " << map.getPalette().size() << " palette entries" << (chunked ? ", chunked" : "") << endl;
+    return 0;
+}
@@ -0,0 +1,45 @@
+/**
+ * Soulgun
+ * Copyright (C) 2021 Change It Later JACK
+ * Distributed under the MIT software license
+*/
+
+/**
+ * Map generator
+ *
+ * Generates a map of caves and rooms and writes it in the binary format, or
+ * chunked with --chunked for maps the game should stream in. The same seed
+ * always gives the same map. Play it with: ./a.out --map <output.map>
+ *
+ * Build and run with: make mapgen && ./mapgen 1024 1024 7 big.map
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include "../MapGenerator.h"
+
+using namespace std;
+
+int main(int argc, char **argv)
+{
+    MapGenerator generator;
+    bool chunked = (argc == 6 && strcmp(argv[1], "--chunked") == 0);
+    int first = chunked ? 2 : 1;
+    int threads = thread::hardware_concurrency();
+
+    if (argc != 5 && !chunked)
+    {
+        cout << "Usage: " << argv[0] << " [--chunked] <width> <height> <seed> <output.map>" << endl;
+        return 1;
+    }
+
+    if (!generator.generate(atoi(argv[first]), atoi(argv[first + 1]), strtoull(argv[first + 2], NULL, 10), threads > 0 ? threads : 1)
+        || !generator.save(argv[first + 3], chunked))
+        return 1;
+
+    cout << argv[first + 3] << ": " << generator.getWidth() << "x" << generator.getHeight() << " tiles"
+         << (chunked ? ", chunked" : "") << endl;
+    return 0;
+}